@@ -682,7 +682,7 @@ void AI::Step(Command &activeCommands)
 {
 	// First, figure out the comparative strengths of the present governments.
 	const System *playerSystem = player.GetSystem();
-	map<const Government *, int64_t> strength;
+	ScratchMap<const Government *, int64_t> strength;
 	UpdateStrengths(strength, playerSystem);
 	CacheShipLists();
 
@@ -1668,12 +1668,12 @@ shared_ptr<Ship> AI::FindNonHostileTarget(const Ship &ship) const
 // Return a list of all targetable ships in the same system as the player that
 // match the desired hostility (i.e. enemy or non-enemy). Does not consider the
 // ship's current target, as its inclusion may or may not be desired.
-vector<Ship *> AI::GetShipsList(const Ship &ship, bool targetEnemies, double maxRange) const
+ScratchVector<Ship *> AI::GetShipsList(const Ship &ship, bool targetEnemies, double maxRange) const
 {
 	if(maxRange < 0.)
 		maxRange = numeric_limits<double>::infinity();
 
-	auto targets = vector<Ship *>();
+	auto targets = ScratchVector<Ship *>();
 
 	// The cached lists are built each step based on the current ships in the player's system.
 	const auto &rosters = targetEnemies ? enemyLists : allyLists;
@@ -3600,11 +3600,11 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic,
 		const optional<Point> &targetOverride) const
 {
 	// (Position, Velocity) pairs of the targets.
-	vector<pair<Point, Point>> targets;
+	ScratchVector<pair<Point, Point>> targets;
 	if(!targetOverride)
 	{
 		// First, get the set of potential hostile ships.
-		vector<const Body *> targetBodies;
+		ScratchVector<const Body *> targetBodies;
 		const Ship *currentTarget = ship.GetTargetShip().get();
 		if(opportunistic || !currentTarget || !currentTarget->IsTargetable())
 		{
@@ -4828,7 +4828,7 @@ bool AI::Has(const Ship &ship, const Government *government, int type) const
 
 
 
-void AI::UpdateStrengths(map<const Government *, int64_t> &strength, const System *playerSystem)
+void AI::UpdateStrengths(ScratchMap<const Government *, int64_t> &strength, const System *playerSystem)
 {
 	// Tally the strength of a government by the strength of its present and able ships.
 	governmentRosters.clear();
@@ -4845,7 +4845,7 @@ void AI::UpdateStrengths(map<const Government *, int64_t> &strength, const Syste
 	allyStrength.clear();
 	for(const auto &gov : strength)
 	{
-		set<const Government *> allies;
+		ScratchSet<const Government *> allies;
 		for(const auto &enemy : strength)
 			if(enemy.first->IsEnemy(gov.first))
 			{
@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "FireCommand.h"
 #include "FormationPositioner.h"
 #include "Point.h"
+#include "ScratchArena.h"
 
 #include <cstdint>
 #include <list>
@@ -100,7 +101,7 @@ private:
 	std::shared_ptr<Ship> FindTarget(const Ship &ship) const;
 	std::shared_ptr<Ship> FindNonHostileTarget(const Ship &ship) const;
 	// Obtain a list of ships matching the desired hostility.
-	std::vector<Ship *> GetShipsList(const Ship &ship, bool targetEnemies, double maxRange = -1.) const;
+	ScratchVector<Ship *> GetShipsList(const Ship &ship, bool targetEnemies, double maxRange = -1.) const;
 
 	bool FollowOrders(Ship &ship, Command &command);
 	void MoveInFormation(Ship &ship, Command &command);
@@ -177,7 +178,7 @@ private:
 	bool Has(const Ship &ship, const Government *government, int type) const;
 
 	// Functions to classify ships based on government and system.
-	void UpdateStrengths(std::map<const Government *, int64_t> &strength, const System *playerSystem);
+	void UpdateStrengths(ScratchMap<const Government *, int64_t> &strength, const System *playerSystem);
 	void CacheShipLists();
 
 
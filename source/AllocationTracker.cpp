@@ -0,0 +1,480 @@
+/* AllocationTracker.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "AllocationTracker.h"
+
+#ifdef ES_ALLOCATION_TRACKING
+#include "Files.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define ES_HAS_BACKTRACE
+#endif
+#endif
+
+using namespace std;
+
+#ifdef ES_ALLOCATION_TRACKING
+namespace {
+	constexpr int PHASE_COUNT = 6;
+	const char *const PHASE_NAMES[PHASE_COUNT] = {"other", "load", "enter system", "calculate step", "draw", "save"};
+
+	// Each thread counts its own allocations, so that the counters are not
+	// shared between threads. Any threads beyond the last slot share it.
+	constexpr int MAX_THREADS = 256;
+	struct Counters {
+		atomic<uint64_t> allocations[PHASE_COUNT];
+		atomic<uint64_t> bytes[PHASE_COUNT];
+		atomic<uint64_t> frees[PHASE_COUNT];
+	};
+	Counters threadCounters[MAX_THREADS];
+	atomic<int> threadCount = 0;
+
+	// How often each scope was entered, and the most allocations made within one.
+	atomic<uint64_t> entries[PHASE_COUNT];
+	atomic<uint64_t> peaks[PHASE_COUNT];
+
+	atomic<int> defaultPhase = static_cast<int>(AllocationTracker::Phase::OTHER);
+
+	// Every SAMPLE_INTERVAL allocations on a thread, record where that
+	// allocation came from. Stacks that are recorded more than once are merged.
+	// Depending on what the compiler inlined, the first few frames of each
+	// stack may be within operator new itself.
+	constexpr uint32_t SAMPLE_INTERVAL = 256;
+	constexpr int SKIPPED_FRAMES = 1;
+	constexpr int STACK_DEPTH = 10;
+	constexpr size_t MAX_SITES = 4096;
+	struct Site {
+		void *stack[STACK_DEPTH] = {};
+		int phase = 0;
+		uint64_t samples = 0;
+		uint64_t bytes = 0;
+	};
+	Site sites[MAX_SITES];
+	mutex siteMutex;
+
+	thread_local Counters *counters = nullptr;
+	thread_local int currentPhase = -1;
+	thread_local uint32_t untilSample = SAMPLE_INTERVAL;
+	// Capturing a stack can itself allocate memory, which must not be sampled.
+	thread_local bool isSampling = false;
+
+
+	Counters &ThreadCounters()
+	{
+		if(!counters)
+			counters = &threadCounters[min(threadCount++, MAX_THREADS - 1)];
+		return *counters;
+	}
+
+	int CurrentPhase()
+	{
+		return currentPhase >= 0 ? currentPhase : defaultPhase.load(memory_order_relaxed);
+	}
+
+	void Sample(size_t size, int phase)
+	{
+		void *frames[SKIPPED_FRAMES + STACK_DEPTH] = {};
+#ifdef ES_HAS_BACKTRACE
+		int count = backtrace(frames, SKIPPED_FRAMES + STACK_DEPTH);
+#elif defined(_WIN32)
+		int count = CaptureStackBackTrace(0, SKIPPED_FRAMES + STACK_DEPTH, frames, nullptr);
+#else
+		int count = 0;
+#endif
+		if(count <= SKIPPED_FRAMES)
+			return;
+		void **stack = frames + SKIPPED_FRAMES;
+
+		uint64_t hash = phase;
+		for(int i = 0; i < STACK_DEPTH; ++i)
+			hash = (hash ^ reinterpret_cast<uintptr_t>(stack[i])) * 1099511628211ull;
+
+		lock_guard<mutex> lock(siteMutex);
+		for(size_t probe = 0; probe < MAX_SITES; ++probe)
+		{
+			Site &site = sites[(hash + probe) % MAX_SITES];
+			bool isEmpty = !site.samples;
+			if(!isEmpty && (site.phase != phase || !equal(stack, stack + STACK_DEPTH, site.stack)))
+				continue;
+			if(isEmpty)
+			{
+				copy(stack, stack + STACK_DEPTH, site.stack);
+				site.phase = phase;
+			}
+			++site.samples;
+			site.bytes += size;
+			return;
+		}
+	}
+
+	void Record(size_t size)
+	{
+		Counters &mine = ThreadCounters();
+		int phase = CurrentPhase();
+		mine.allocations[phase].fetch_add(1, memory_order_relaxed);
+		mine.bytes[phase].fetch_add(size, memory_order_relaxed);
+
+		if(--untilSample || isSampling)
+			return;
+		untilSample = SAMPLE_INTERVAL;
+		isSampling = true;
+		Sample(size, phase);
+		isSampling = false;
+	}
+
+	void RecordFree(void *pointer)
+	{
+		if(pointer)
+			ThreadCounters().frees[CurrentPhase()].fetch_add(1, memory_order_relaxed);
+	}
+
+	void *Allocate(size_t size, size_t alignment, bool canThrow)
+	{
+		Record(size);
+		size = max<size_t>(size, 1);
+		while(true)
+		{
+			void *pointer = nullptr;
+			if(alignment <= alignof(max_align_t))
+				pointer = malloc(size);
+			else
+			{
+#ifdef _WIN32
+				pointer = _aligned_malloc(size, alignment);
+#else
+				if(posix_memalign(&pointer, alignment, size))
+					pointer = nullptr;
+#endif
+			}
+			if(pointer)
+				return pointer;
+
+			new_handler handler = get_new_handler();
+			if(!handler)
+				break;
+			handler();
+		}
+		if(canThrow)
+			throw bad_alloc();
+		return nullptr;
+	}
+
+	void Free(void *pointer, bool isAligned)
+	{
+		RecordFree(pointer);
+#ifdef _WIN32
+		if(isAligned)
+		{
+			_aligned_free(pointer);
+			return;
+		}
+#else
+		static_cast<void>(isAligned);
+#endif
+		free(pointer);
+	}
+
+	uint64_t Total(atomic<uint64_t> (Counters::*member)[PHASE_COUNT], int phase)
+	{
+		uint64_t total = 0;
+		int threads = min(threadCount.load(), MAX_THREADS);
+		for(int i = 0; i < threads; ++i)
+			total += (threadCounters[i].*member)[phase].load(memory_order_relaxed);
+		return total;
+	}
+
+	string Escape(const string &text)
+	{
+		string result;
+		for(char c : text)
+		{
+			if(c == '"' || c == '\\')
+				result += '\\';
+			if(static_cast<unsigned char>(c) >= ' ')
+				result += c;
+		}
+		return result;
+	}
+
+	// Get a description of each frame of the given stack.
+	vector<string> Describe(void *const *stack)
+	{
+		int depth = 0;
+		while(depth < STACK_DEPTH && stack[depth])
+			++depth;
+
+		vector<string> result;
+#ifdef ES_HAS_BACKTRACE
+		char **symbols = backtrace_symbols(stack, depth);
+		if(symbols)
+		{
+			for(int i = 0; i < depth; ++i)
+				result.emplace_back(symbols[i]);
+			free(symbols);
+			return result;
+		}
+#endif
+		for(int i = 0; i < depth; ++i)
+		{
+			char buffer[32];
+			snprintf(buffer, sizeof(buffer), "%p", stack[i]);
+			result.emplace_back(buffer);
+		}
+		return result;
+	}
+}
+#endif
+
+
+
+AllocationTracker::Scope::Scope(Phase phase)
+{
+#ifdef ES_ALLOCATION_TRACKING
+	int index = static_cast<int>(phase);
+	previous = currentPhase;
+	currentPhase = index;
+	start = ThreadCounters().allocations[index].load(memory_order_relaxed);
+#else
+	static_cast<void>(phase);
+#endif
+}
+
+
+
+AllocationTracker::Scope::~Scope()
+{
+#ifdef ES_ALLOCATION_TRACKING
+	int index = currentPhase;
+	uint64_t count = ThreadCounters().allocations[index].load(memory_order_relaxed) - start;
+	++entries[index];
+	uint64_t peak = peaks[index].load(memory_order_relaxed);
+	while(count > peak && !peaks[index].compare_exchange_weak(peak, count, memory_order_relaxed))
+		continue;
+	currentPhase = previous;
+#endif
+}
+
+
+
+// Check whether allocations are being tracked in this build.
+bool AllocationTracker::IsEnabled()
+{
+#ifdef ES_ALLOCATION_TRACKING
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+
+// Set the phase to attribute allocations to on threads that are not within any Scope.
+void AllocationTracker::SetDefaultPhase(Phase phase)
+{
+#ifdef ES_ALLOCATION_TRACKING
+	defaultPhase = static_cast<int>(phase);
+#else
+	static_cast<void>(phase);
+#endif
+}
+
+
+
+// Get a summary of the allocations so far, as JSON.
+string AllocationTracker::Summary()
+{
+#ifdef ES_ALLOCATION_TRACKING
+	string json = "{\n\t\"sample_interval\": " + to_string(SAMPLE_INTERVAL)
+		+ ",\n\t\"threads\": " + to_string(threadCount.load()) + ",\n\t\"phases\": [";
+	for(int i = 0; i < PHASE_COUNT; ++i)
+	{
+		json += (i ? ",\n\t\t{" : "\n\t\t{");
+		json += "\"name\": \"" + string(PHASE_NAMES[i]) + "\"";
+		json += ", \"allocations\": " + to_string(Total(&Counters::allocations, i));
+		json += ", \"bytes\": " + to_string(Total(&Counters::bytes, i));
+		json += ", \"frees\": " + to_string(Total(&Counters::frees, i));
+		json += ", \"scopes\": " + to_string(entries[i].load());
+		json += ", \"peak_allocations_per_scope\": " + to_string(peaks[i].load()) + "}";
+	}
+	json += "\n\t],\n\t\"call_sites\": [";
+
+	// List the call sites with the most samples first.
+	vector<Site> found;
+	{
+		lock_guard<mutex> lock(siteMutex);
+		for(const Site &site : sites)
+			if(site.samples)
+				found.push_back(site);
+	}
+	sort(found.begin(), found.end(), [](const Site &a, const Site &b) { return a.samples > b.samples; });
+	for(size_t i = 0; i < found.size(); ++i)
+	{
+		const Site &site = found[i];
+		json += (i ? ",\n\t\t{" : "\n\t\t{");
+		json += "\"phase\": \"" + string(PHASE_NAMES[site.phase]) + "\"";
+		json += ", \"samples\": " + to_string(site.samples);
+		json += ", \"bytes\": " + to_string(site.bytes);
+		json += ", \"stack\": [";
+		vector<string> frames = Describe(site.stack);
+		for(size_t j = 0; j < frames.size(); ++j)
+			json += (j ? ", \"" : "\"") + Escape(frames[j]) + "\"";
+		json += "]}";
+	}
+	json += "\n\t]\n}\n";
+	return json;
+#else
+	return "";
+#endif
+}
+
+
+
+// Write the summary to the log and to "allocations.json" in the config folder.
+void AllocationTracker::Report()
+{
+#ifdef ES_ALLOCATION_TRACKING
+	string log = "Heap allocations by phase (allocations, bytes, scopes, peak allocations in one scope):";
+	for(int i = 0; i < PHASE_COUNT; ++i)
+		log += "\n\t" + string(PHASE_NAMES[i]) + ": " + to_string(Total(&Counters::allocations, i))
+			+ ", " + to_string(Total(&Counters::bytes, i)) + ", " + to_string(entries[i].load())
+			+ ", " + to_string(peaks[i].load());
+	Logger::LogError(log);
+
+	const filesystem::path path = Files::Config() / "allocations.json";
+	Files::Write(path, Summary());
+	Logger::LogError("The sampled call sites of these allocations were written to \"" + path.string() + "\".");
+#endif
+}
+
+
+
+#ifdef ES_ALLOCATION_TRACKING
+// Replace the global allocation functions, so that every allocation is counted.
+void *operator new(size_t size)
+{
+	return Allocate(size, 0, true);
+}
+
+void *operator new[](size_t size)
+{
+	return Allocate(size, 0, true);
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+	return Allocate(size, 0, false);
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept
+{
+	return Allocate(size, 0, false);
+}
+
+void *operator new(size_t size, align_val_t alignment)
+{
+	return Allocate(size, static_cast<size_t>(alignment), true);
+}
+
+void *operator new[](size_t size, align_val_t alignment)
+{
+	return Allocate(size, static_cast<size_t>(alignment), true);
+}
+
+void *operator new(size_t size, align_val_t alignment, const nothrow_t &) noexcept
+{
+	return Allocate(size, static_cast<size_t>(alignment), false);
+}
+
+void *operator new[](size_t size, align_val_t alignment, const nothrow_t &) noexcept
+{
+	return Allocate(size, static_cast<size_t>(alignment), false);
+}
+
+void operator delete(void *pointer) noexcept
+{
+	Free(pointer, false);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+	Free(pointer, false);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+	Free(pointer, false);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+	Free(pointer, false);
+}
+
+void operator delete(void *pointer, const nothrow_t &) noexcept
+{
+	Free(pointer, false);
+}
+
+void operator delete[](void *pointer, const nothrow_t &) noexcept
+{
+	Free(pointer, false);
+}
+
+void operator delete(void *pointer, align_val_t) noexcept
+{
+	Free(pointer, true);
+}
+
+void operator delete[](void *pointer, align_val_t) noexcept
+{
+	Free(pointer, true);
+}
+
+void operator delete(void *pointer, size_t, align_val_t) noexcept
+{
+	Free(pointer, true);
+}
+
+void operator delete[](void *pointer, size_t, align_val_t) noexcept
+{
+	Free(pointer, true);
+}
+
+void operator delete(void *pointer, align_val_t, const nothrow_t &) noexcept
+{
+	Free(pointer, true);
+}
+
+void operator delete[](void *pointer, align_val_t, const nothrow_t &) noexcept
+{
+	Free(pointer, true);
+}
+#endif
@@ -0,0 +1,66 @@
+/* AllocationTracker.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+
+
+// Counts every heap allocation that the game makes, grouped by what the game
+// was doing at the time, and samples where the allocations come from. This is
+// only active if the game was built with the ES_ALLOCATION_TRACKING option,
+// which replaces the global operator new and delete. Otherwise, all of these
+// functions do nothing.
+class AllocationTracker {
+public:
+	enum class Phase : int {
+		OTHER,
+		LOAD,
+		ENTER_SYSTEM,
+		CALCULATE_STEP,
+		DRAW,
+		SAVE
+	};
+
+	// Attribute every allocation that this thread makes to the given phase,
+	// until this object goes out of scope.
+	class Scope {
+	public:
+		explicit Scope(Phase phase);
+		~Scope();
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+#ifdef ES_ALLOCATION_TRACKING
+	private:
+		int previous;
+		unsigned long long start;
+#endif
+	};
+
+
+public:
+	// Check whether allocations are being tracked in this build.
+	static bool IsEnabled();
+	// Set the phase to attribute allocations to on threads that are not within
+	// any Scope. This covers the worker threads that load the game data.
+	static void SetDefaultPhase(Phase phase);
+
+	// Get a summary of the allocations so far, as JSON.
+	static std::string Summary();
+	// Write the summary to the log and to "allocations.json" in the config folder.
+	static void Report();
+};
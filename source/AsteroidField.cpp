@@ -22,6 +22,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Minable.h"
 #include "Projectile.h"
 #include "Random.h"
+#include "Rectangle.h"
 #include "Screen.h"
 #include "image/SpriteSet.h"
 
@@ -53,6 +54,12 @@ void AsteroidField::Clear()
 {
 	asteroids.clear();
 	minables.clear();
+
+	// The collision sets refer to the objects that were just removed, so they
+	// must not be used until the next Step() fills them again.
+	asteroidCollisions.Clear(0);
+	minableCollisions.Clear(0);
+	maxSpeed = 0.;
 }
 
 
@@ -86,11 +93,13 @@ void AsteroidField::Add(const Minable *minable, int count, double energy, const
 // Move all the asteroids forward one step.
 void AsteroidField::Step(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam, int step)
 {
+	maxSpeed = 0.;
 	asteroidCollisions.Clear(step);
 	for(Asteroid &asteroid : asteroids)
 	{
 		asteroidCollisions.Add(asteroid);
 		asteroid.Step();
+		maxSpeed = max(maxSpeed, asteroid.Velocity().Length());
 	}
 	asteroidCollisions.Finish();
 
@@ -103,6 +112,7 @@ void AsteroidField::Step(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flo
 		if((*it)->Move(visuals, flotsam))
 		{
 			minableCollisions.Add(**it);
+			maxSpeed = max(maxSpeed, (*it)->Velocity().Length());
 			++it;
 		}
 		else
@@ -116,16 +126,44 @@ void AsteroidField::Step(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flo
 // Draw the asteroids, centered on the given location.
 void AsteroidField::Draw(DrawList &draw, const Point &center, double zoom) const
 {
-	for(const Asteroid &asteroid : asteroids)
-		asteroid.Draw(draw, center, zoom);
-	for(const shared_ptr<Minable> &minable : minables)
-		draw.Add(*minable);
+	// The collision sets hold every object that was present at the last step,
+	// each one covering every grid cell that its sprite can overlap. Use them to
+	// skip the objects that are nowhere near the screen, unless objects have
+	// been added since then. The asteroids were added to their collision set
+	// before they moved, and any object's motion blur can extend beyond its
+	// sprite, so allow for that.
+	ScratchVector<Body *> visible;
+	const Rectangle area = draw.VisibleArea();
+	const Point margin = Point(1., 1.) * (1.5 * maxSpeed);
+	const Rectangle expanded = Rectangle::WithCorners(area.TopLeft() - margin, area.BottomRight() + margin);
+
+	if(asteroidCollisions.All().size() == asteroids.size())
+	{
+		visible.clear();
+		asteroidCollisions.Area(expanded, visible, true);
+		for(const Body *body : visible)
+			static_cast<const Asteroid *>(body)->Draw(draw, center, zoom);
+	}
+	else
+		for(const Asteroid &asteroid : asteroids)
+			asteroid.Draw(draw, center, zoom);
+
+	if(minableCollisions.All().size() == minables.size())
+	{
+		visible.clear();
+		minableCollisions.Area(expanded, visible);
+		for(const Body *body : visible)
+			draw.Add(*body);
+	}
+	else
+		for(const shared_ptr<Minable> &minable : minables)
+			draw.Add(*minable);
 }
 
 
 
 // Check if the given projectile collides with any asteroids. This excludes minables.
-void AsteroidField::CollideAsteroids(const Projectile &projectile, vector<Collision> &result) const
+void AsteroidField::CollideAsteroids(const Projectile &projectile, ScratchVector<Collision> &result) const
 {
 	// Check for collisions with ordinary asteroids, which are tiled.
 	// Rather than tiling the collision set, tile the projectile.
@@ -155,7 +193,7 @@ void AsteroidField::CollideAsteroids(const Projectile &projectile, vector<Collis
 
 
 // Check if the given projectile collides with any minables.
-void AsteroidField::CollideMinables(const Projectile &projectile, vector<Collision> &result) const
+void AsteroidField::CollideMinables(const Projectile &projectile, ScratchVector<Collision> &result) const
 {
 	minableCollisions.Line(projectile, result);
 }
@@ -163,7 +201,7 @@ void AsteroidField::CollideMinables(const Projectile &projectile, vector<Collisi
 
 
 // Get a list of minables affected by an explosion with blast radius.
-void AsteroidField::MinablesCollisionsCircle(const Point &center, double radius, vector<Body *> &result) const
+void AsteroidField::MinablesCollisionsCircle(const Point &center, double radius, ScratchVector<Body *> &result) const
 {
 	minableCollisions.Circle(center, radius, result);
 }
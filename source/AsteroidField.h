@@ -60,11 +60,11 @@ public:
 	void Draw(DrawList &draw, const Point &center, double zoom) const;
 
 	// Check if the given projectile collides with any asteroids. This excludes minables.
-	void CollideAsteroids(const Projectile &projectile, std::vector<Collision> &result) const;
+	void CollideAsteroids(const Projectile &projectile, ScratchVector<Collision> &result) const;
 	// Check if the given projectile collides with any minables.
-	void CollideMinables(const Projectile &projectile, std::vector<Collision> &result) const;
+	void CollideMinables(const Projectile &projectile, ScratchVector<Collision> &result) const;
 	// Get a list of minables affected by an explosion with blast radius.
-	void MinablesCollisionsCircle(const Point &center, double radius, std::vector<Body *> &result) const;
+	void MinablesCollisionsCircle(const Point &center, double radius, ScratchVector<Body *> &result) const;
 
 	// Get the list of minable asteroids.
 	const std::list<std::shared_ptr<Minable>> &Minables() const;
@@ -92,4 +92,6 @@ private:
 
 	CollisionSet asteroidCollisions;
 	CollisionSet minableCollisions;
+	// The fastest that any asteroid or minable moved in the last step.
+	double maxSpeed = 0.;
 };
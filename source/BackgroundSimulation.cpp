@@ -0,0 +1,414 @@
+/* BackgroundSimulation.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "BackgroundSimulation.h"
+
+#include "Angle.h"
+#include "Fleet.h"
+#include "Government.h"
+#include "JumpType.h"
+#include "Outfit.h"
+#include "Personality.h"
+#include "Point.h"
+#include "Ship.h"
+#include "ShipJumpNavigation.h"
+#include "StellarObject.h"
+#include "System.h"
+
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+namespace {
+	// A ship that is as strong as all of its enemies together is disabled after
+	// this many steps of fighting, and destroyed after as many again.
+	const double STEPS_TO_DISABLE = 1800.;
+	// Ships that have nowhere to go wait this long before choosing a system to travel to.
+	const int64_t IDLE_STEPS = 600;
+	// Ships arrive this far from the center of a system, on the side they came from.
+	const double ARRIVAL_DISTANCE = 1000.;
+
+	// Scramble the bits of the given value, so that similar values give very
+	// different results.
+	uint64_t Mix(uint64_t value)
+	{
+		value += 0x9E3779B97F4A7C15ull;
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+		return value ^ (value >> 31);
+	}
+
+	// Get the fuel needed to jump to the given system, or 0 if the ship cannot make that jump.
+	double JumpFuel(const Ship &ship, const System &from, const System &to)
+	{
+		if(ship.IsRestrictedFrom(to))
+			return 0.;
+		double fuel = ship.JumpNavigation().GetCheapestJumpType(&from, &to).second;
+		return ship.Fuel() * ship.Attributes().Get("fuel capacity") >= fuel ? fuel : 0.;
+	}
+
+	// Choose a system for an idle ship to travel to. The choice is based on the
+	// given seed, and not on the order of the system's links in memory.
+	const System *ChooseDestination(const Ship &ship, const System &system, uint64_t seed)
+	{
+		const Personality &personality = ship.GetPersonality();
+		if(personality.IsStaying() || personality.IsWaiting() || personality.IsDerelict())
+			return nullptr;
+
+		const ShipJumpNavigation &navigation = ship.JumpNavigation();
+		const set<const System *> &links = navigation.HasJumpDrive()
+			? system.JumpNeighbors(navigation.JumpRange()) : system.Links();
+		vector<const System *> options;
+		for(const System *link : links)
+			if(JumpFuel(ship, system, *link))
+				options.push_back(link);
+		if(options.empty())
+			return nullptr;
+
+		sort(options.begin(), options.end(),
+			[](const System *a, const System *b) { return a->TrueName() < b->TrueName(); });
+		return options[Mix(seed) % options.size()];
+	}
+}
+
+
+
+// Check whether the given ship can be left to this simulation. Ships in the
+// given systems, and the player's ships and their escorts, always need the
+// full simulation.
+bool BackgroundSimulation::CanSimulate(const Ship &ship, const System *playerSystem, const System *flagshipSystem)
+{
+	const System *system = ship.GetSystem();
+	if(!system || system == playerSystem || system == flagshipSystem)
+		return false;
+	// Ships that are jumping, landing, taking off, or boarding are left alone
+	// until they are done.
+	if(ship.IsYours() || ship.IsDestroyed() || ship.IsHyperspacing() || ship.Zoom() < 1. || ship.IsBoarding())
+		return false;
+
+	shared_ptr<Ship> parent = ship.GetParent();
+	return !parent || !parent->IsYours();
+}
+
+
+
+// Take over the simulation of the given ship.
+void BackgroundSimulation::Add(const shared_ptr<Ship> &ship)
+{
+	auto it = regions.try_emplace(ship->GetSystem()).first;
+	if(it->second.records.empty())
+		it->second.lastStep = step;
+
+	Record &record = it->second.records.emplace_back();
+	record.ship = ship;
+	record.seed = hash<string>()(ship->UUID().ToString());
+}
+
+
+
+// Hand all the ships in the given system back to the full simulation.
+void BackgroundSimulation::Release(const System *system, list<shared_ptr<Ship>> &ships)
+{
+	if(!system)
+		return;
+	auto it = regions.find(system);
+	if(it == regions.end())
+		return;
+
+	for(Record &record : it->second.records)
+		ships.push_back(std::move(record.ship));
+	regions.erase(it);
+}
+
+
+
+// Stop simulating every ship.
+void BackgroundSimulation::Clear()
+{
+	regions.clear();
+	next = nullptr;
+}
+
+
+
+// Get the number of ships that are being simulated.
+size_t BackgroundSimulation::Size() const
+{
+	size_t size = 0;
+	for(const auto &it : regions)
+		size += it.second.records.size();
+	return size;
+}
+
+
+
+// Advance the simulation by one step. Any ship that is about to jump into
+// the player's system is handed back to the full simulation, and events
+// are added for every ship that is disabled or destroyed. Returns the
+// number of ships that were simulated in this step.
+size_t BackgroundSimulation::Step(const System *playerSystem, list<shared_ptr<Ship>> &ships,
+	list<ShipEvent> &events)
+{
+	++step;
+	if(regions.empty())
+		return 0;
+
+	// Pick up where the last step left off, and simulate each system that has
+	// waited long enough, until the budget is used up. A system with more ships
+	// than the budget is still simulated if it comes first, so it never starves.
+	vector<pair<const System *, Region *>> due;
+	size_t count = 0;
+	auto it = next ? regions.lower_bound(next) : regions.begin();
+	for(size_t checked = 0; checked < regions.size(); ++checked, ++it)
+	{
+		if(it == regions.end())
+			it = regions.begin();
+		Region &region = it->second;
+		if(step - region.lastStep < STEPS_PER_UPDATE)
+			continue;
+		if(!due.empty() && count + region.records.size() > MAX_SHIPS_PER_STEP)
+			break;
+		due.emplace_back(it->first, &region);
+		count += region.records.size();
+	}
+	next = (it == regions.end()) ? nullptr : it->first;
+	if(due.empty())
+		return 0;
+
+	// Each system only changes the ships that are in it. Anything that affects
+	// other systems is applied afterwards, in order. The number of ships is
+	// capped, so this is cheap enough to do on the thread that called Step().
+	vector<Result> results(due.size());
+	for(size_t i = 0; i < due.size(); ++i)
+	{
+		Region &region = *due[i].second;
+		Simulate(*due[i].first, region, step - region.lastStep, step, results[i]);
+	}
+
+	for(Result &result : results)
+	{
+		events.splice(events.end(), result.events);
+		for(Departure &departure : result.departures)
+		{
+			Ship &ship = *departure.record.ship;
+			// A ship that is jumping into the player's system is handed back
+			// just before it jumps, so that its arrival can be seen.
+			if(departure.to == playerSystem)
+			{
+				Fleet::Enter(*departure.to, ship, departure.from);
+				ships.push_back(std::move(departure.record.ship));
+				continue;
+			}
+
+			Point direction = (departure.to->Position() - departure.from->Position()).Unit();
+			ship.TransferFuel(JumpFuel(ship, *departure.from, *departure.to), nullptr);
+			ship.SetSystem(departure.to);
+			ship.SetTargetSystem(nullptr);
+			ship.Place(-ARRIVAL_DISTANCE * direction, Point(), Angle(direction), false);
+
+			auto arrival = regions.try_emplace(departure.to);
+			if(arrival.second)
+				arrival.first->second.lastStep = step;
+			arrival.first->second.records.push_back(std::move(departure.record));
+		}
+	}
+	erase_if(regions, [](const auto &it) { return it.second.records.empty(); });
+
+	return count;
+}
+
+
+
+bool BackgroundSimulation::ByTrueName::operator()(const System *a, const System *b) const
+{
+	if(a->TrueName() != b->TrueName())
+		return a->TrueName() < b->TrueName();
+	return less<const System *>()(a, b);
+}
+
+
+
+// Advance all the ships in one system by the given number of steps.
+void BackgroundSimulation::Simulate(const System &system, Region &region, int64_t steps, int64_t step,
+	Result &result)
+{
+	region.lastStep = step;
+	ResolveCombat(region, steps, result);
+	Move(system, region, steps, step, result);
+
+	// Destroyed ships are not simulated any more, and ships that have left are
+	// added to the systems that they jumped to.
+	auto &records = region.records;
+	records.erase(remove_if(records.begin(), records.end(),
+		[](const Record &record) { return !record.ship || record.ship->IsDestroyed(); }), records.end());
+}
+
+
+
+// Wear down each ship by the strength of the enemies in the same system,
+// compared to its own strength. Every ship is compared with the ships as they
+// were before this fight, so the order of the ships does not matter.
+void BackgroundSimulation::ResolveCombat(Region &region, int64_t steps, Result &result)
+{
+	const auto &records = region.records;
+	vector<double> pressure(records.size());
+	vector<bool> isLethal(records.size());
+	for(size_t i = 0; i < records.size(); ++i)
+	{
+		const Ship &ship = *records[i].ship;
+		const Government *gov = ship.GetGovernment();
+		if(!gov || ship.IsDestroyed())
+			continue;
+		for(size_t j = 0; j < records.size(); ++j)
+		{
+			const Ship &enemy = *records[j].ship;
+			if(i == j || enemy.IsDestroyed() || enemy.IsDisabled() || enemy.GetPersonality().IsPacifist()
+					|| !gov->IsEnemy(enemy.GetGovernment()))
+				continue;
+			pressure[i] += max<int64_t>(1, enemy.Strength());
+			isLethal[i] = isLethal[i] || !enemy.GetPersonality().Disables();
+		}
+	}
+
+	for(size_t i = 0; i < records.size(); ++i)
+	{
+		Record &record = region.records[i];
+		const shared_ptr<Ship> &ship = record.ship;
+		bool wasDisabled = ship->IsDisabled();
+		// Enemies that only want to disable a ship leave it alone once it is disabled.
+		if(!pressure[i] || (wasDisabled && !isLethal[i]))
+			continue;
+
+		record.attrition += steps * pressure[i] / (STEPS_TO_DISABLE * max<int64_t>(1, ship->Strength()));
+		if(!wasDisabled && record.attrition >= 1.)
+		{
+			record.attrition = 1.;
+			ship->Disable();
+			result.events.emplace_back(nullptr, ship, ShipEvent::DISABLE);
+		}
+		else if(wasDisabled && record.attrition >= 2.)
+		{
+			ship->Destroy();
+			result.events.emplace_back(nullptr, ship, ShipEvent::DESTROY);
+			// Any ships still in its bays are destroyed with it.
+			for(const Ship::Bay &bay : ship->Bays())
+				if(bay.ship)
+				{
+					bay.ship->Destroy();
+					result.events.emplace_back(nullptr, bay.ship, ShipEvent::DESTROY);
+				}
+		}
+	}
+}
+
+
+
+// Fly each ship straight to where it is going. Ships that are travelling to
+// another system leave once they reach the edge of this one, taking along
+// any ships that are following them.
+void BackgroundSimulation::Move(const System &system, Region &region, int64_t steps, int64_t step, Result &result)
+{
+	auto IsFollowing = [&system](const Ship &ship)
+	{
+		shared_ptr<Ship> parent = ship.GetParent();
+		return parent && parent->GetSystem() == &system && !parent->IsDisabled() && !parent->IsDestroyed();
+	};
+
+	set<const Ship *> leaving;
+	for(Record &record : region.records)
+	{
+		Ship &ship = *record.ship;
+		if(ship.IsDestroyed() || IsFollowing(ship))
+			continue;
+		if(ship.IsDisabled())
+		{
+			ship.SetVelocity(Point());
+			continue;
+		}
+
+		const System *target = ship.GetTargetSystem();
+		if(target && !JumpFuel(ship, system, *target))
+		{
+			target = nullptr;
+			ship.SetTargetSystem(nullptr);
+		}
+		if(!target && !ship.GetTargetStellar() && record.idle >= IDLE_STEPS)
+		{
+			target = ChooseDestination(ship, system, record.seed ^ static_cast<uint64_t>(step));
+			ship.SetTargetSystem(target);
+		}
+
+		Point destination;
+		if(target)
+		{
+			bool isJump = ship.JumpNavigation().GetCheapestJumpType(&system, target).first == JumpType::JUMP_DRIVE;
+			double departure = isJump ? system.JumpDepartureDistance() : system.HyperDepartureDistance();
+			destination = (target->Position() - system.Position()).Unit() * (departure + 1.);
+		}
+		else if(ship.GetTargetStellar())
+			destination = ship.GetTargetStellar()->Position();
+		else
+		{
+			record.idle += steps;
+			ship.SetVelocity(Point());
+			continue;
+		}
+		record.idle = 0;
+
+		Point offset = destination - ship.Position();
+		double distance = offset.Length();
+		double travel = ship.MaxVelocity() * steps;
+		if(travel < distance)
+		{
+			Point velocity = offset.Unit() * ship.MaxVelocity();
+			ship.SetPosition(ship.Position() + velocity * steps);
+			ship.SetVelocity(velocity);
+			continue;
+		}
+		ship.SetPosition(destination);
+		ship.SetVelocity(Point());
+		if(target)
+		{
+			leaving.insert(&ship);
+			result.departures.push_back(Departure{std::move(record), &system, target});
+		}
+	}
+
+	// Ships that are following another ship stay with it, and leave with it if
+	// they are able to make the same jump.
+	for(Record &record : region.records)
+	{
+		if(!record.ship)
+			continue;
+		Ship &ship = *record.ship;
+		if(ship.IsDestroyed() || ship.IsDisabled() || !IsFollowing(ship))
+			continue;
+
+		shared_ptr<Ship> parent = ship.GetParent();
+		record.idle = 0;
+		ship.SetPosition(parent->Position());
+		ship.SetVelocity(parent->Velocity());
+		const System *target = parent->GetTargetSystem();
+		if(leaving.contains(parent.get()) && target && JumpFuel(ship, system, *target))
+		{
+			leaving.insert(&ship);
+			result.departures.push_back(Departure{std::move(record), &system, target});
+		}
+	}
+}
@@ -0,0 +1,124 @@
+/* BackgroundSimulation.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "ShipEvent.h"
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+class Ship;
+class System;
+
+
+
+// A coarse simulation of the NPCs that are in systems other than the player's.
+// Instead of giving those ships orders and moving them every step, each system
+// is advanced in large steps, only a few systems at a time. The ships fly
+// straight to where they are going, jump once they reach the edge of the
+// system, and fights are resolved by comparing the strength of each side.
+// The outcome only depends on the state of the ships and on the number of
+// steps that have passed, not on the order that the ships were added in.
+class BackgroundSimulation {
+public:
+	// Each system is simulated at most once in this many steps.
+	static constexpr int64_t STEPS_PER_UPDATE = 60;
+	// The most ships that will be simulated in a single step.
+	static constexpr size_t MAX_SHIPS_PER_STEP = 100;
+
+
+public:
+	// Check whether the given ship can be left to this simulation. Ships in the
+	// given systems, and the player's ships and their escorts, always need the
+	// full simulation.
+	static bool CanSimulate(const Ship &ship, const System *playerSystem, const System *flagshipSystem);
+
+	// Take over the simulation of the given ship.
+	void Add(const std::shared_ptr<Ship> &ship);
+	// Hand all the ships in the given system back to the full simulation.
+	void Release(const System *system, std::list<std::shared_ptr<Ship>> &ships);
+	// Stop simulating every ship.
+	void Clear();
+	// Get the number of ships that are being simulated.
+	size_t Size() const;
+
+	// Advance the simulation by one step. Any ship that is about to jump into
+	// the player's system is handed back to the full simulation, and events
+	// are added for every ship that is disabled or destroyed. Returns the
+	// number of ships that were simulated in this step.
+	size_t Step(const System *playerSystem, std::list<std::shared_ptr<Ship>> &ships,
+		std::list<ShipEvent> &events);
+
+
+private:
+	// Order systems by name, so that they are always simulated in the same order.
+	class ByTrueName {
+	public:
+		bool operator()(const System *a, const System *b) const;
+	};
+
+	class Record {
+	public:
+		std::shared_ptr<Ship> ship;
+		// How close this ship is to being disabled (at 1) or destroyed (at 2).
+		double attrition = 0.;
+		// How long this ship has been idle, in steps.
+		int64_t idle = 0;
+		// A value that is unique to this ship, to base its decisions on.
+		uint64_t seed = 0;
+	};
+
+	// All the ships that are in one system.
+	class Region {
+	public:
+		std::vector<Record> records;
+		// The step when this system was last simulated.
+		int64_t lastStep = 0;
+	};
+
+	// A ship that is leaving the system that it is in.
+	class Departure {
+	public:
+		Record record;
+		const System *from = nullptr;
+		const System *to = nullptr;
+	};
+
+	// The results of simulating one system.
+	class Result {
+	public:
+		std::vector<Departure> departures;
+		std::list<ShipEvent> events;
+	};
+
+
+private:
+	// Advance all the ships in one system by the given number of steps.
+	static void Simulate(const System &system, Region &region, int64_t steps, int64_t step, Result &result);
+	static void ResolveCombat(Region &region, int64_t steps, Result &result);
+	static void Move(const System &system, Region &region, int64_t steps, int64_t step, Result &result);
+
+
+private:
+	std::map<const System *, Region, ByTrueName> regions;
+	// The number of steps that have been simulated.
+	int64_t step = 0;
+	// The system to check first in the next step.
+	const System *next = nullptr;
+};
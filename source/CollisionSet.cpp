@@ -22,6 +22,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "image/Mask.h"
 #include "Point.h"
 #include "Projectile.h"
+#include "Rectangle.h"
 #include "Ship.h"
 
 #include <algorithm>
@@ -86,12 +87,20 @@ void CollisionSet::Clear(int step)
 
 // Add an object to the set.
 void CollisionSet::Add(Body &body)
+{
+	Add(body, body.Radius());
+}
+
+
+
+// Add an object to the set, covering everything within the given radius of it.
+void CollisionSet::Add(Body &body, double radius)
 {
 	// Calculate the range of (x, y) grid coordinates this object covers.
-	int minX = static_cast<int>(body.Position().X() - body.Radius()) >> SHIFT;
-	int minY = static_cast<int>(body.Position().Y() - body.Radius()) >> SHIFT;
-	int maxX = static_cast<int>(body.Position().X() + body.Radius()) >> SHIFT;
-	int maxY = static_cast<int>(body.Position().Y() + body.Radius()) >> SHIFT;
+	int minX = static_cast<int>(body.Position().X() - radius) >> SHIFT;
+	int minY = static_cast<int>(body.Position().Y() - radius) >> SHIFT;
+	int maxX = static_cast<int>(body.Position().X() + radius) >> SHIFT;
+	int maxY = static_cast<int>(body.Position().Y() + radius) >> SHIFT;
 
 	// Add a pointer to this object in every grid cell it occupies.
 	for(int y = minY; y <= maxY; ++y)
@@ -137,7 +146,7 @@ void CollisionSet::Finish()
 
 // Get all possible collisions for the given projectile. Collisions are not necessarily
 // sorted by distance.
-void CollisionSet::Line(const Projectile &projectile, vector<Collision> &result) const
+void CollisionSet::Line(const Projectile &projectile, ScratchVector<Collision> &result) const
 {
 	// What objects the projectile hits depends on its government.
 	const Government *pGov = projectile.GetGovernment();
@@ -152,7 +161,7 @@ void CollisionSet::Line(const Projectile &projectile, vector<Collision> &result)
 
 // Get all possible collisions along a line. Collisions are not necessarily sorted by
 // distance.
-void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &lineResult,
+void CollisionSet::Line(const Point &from, const Point &to, ScratchVector<Collision> &lineResult,
 		const Government *pGov, const Body *target) const
 {
 	const int x = from.X();
@@ -309,7 +318,7 @@ void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &l
 
 
 // Get all objects within the given range of the given point.
-void CollisionSet::Circle(const Point &center, double radius, vector<Body *> &result) const
+void CollisionSet::Circle(const Point &center, double radius, ScratchVector<Body *> &result) const
 {
 	Ring(center, 0., radius, result);
 }
@@ -318,7 +327,7 @@ void CollisionSet::Circle(const Point &center, double radius, vector<Body *> &re
 
 // Get all objects touching a ring with a given inner and outer range
 // centered at the given point.
-void CollisionSet::Ring(const Point &center, double inner, double outer, vector<Body *> &circleResult) const
+void CollisionSet::Ring(const Point &center, double inner, double outer, ScratchVector<Body *> &circleResult) const
 {
 	// Calculate the range of (x, y) grid coordinates this ring covers.
 	const int minX = static_cast<int>(center.X() - outer) >> SHIFT;
@@ -363,6 +372,62 @@ void CollisionSet::Ring(const Point &center, double inner, double outer, vector<
 
 
 
+// Get all objects that occupy any grid cell overlapping the given rectangle,
+// in the order they were added.
+void CollisionSet::Area(const Rectangle &area, ScratchVector<Body *> &result, bool isTiled) const
+{
+	// Calculate the range of (x, y) grid coordinates this rectangle covers.
+	const int minX = static_cast<int>(area.Left()) >> SHIFT;
+	const int minY = static_cast<int>(area.Top()) >> SHIFT;
+	int maxX = static_cast<int>(area.Right()) >> SHIFT;
+	int maxY = static_cast<int>(area.Bottom()) >> SHIFT;
+	// If the grid is tiled, each cell only needs to be checked once no matter
+	// how large the rectangle is.
+	if(isTiled)
+	{
+		maxX = min(maxX, minX + static_cast<int>(WRAP_MASK));
+		maxY = min(maxY, minY + static_cast<int>(WRAP_MASK));
+	}
+
+	seen.clear();
+	seen.resize(all.size());
+	thread_local vector<unsigned> found;
+	found.clear();
+
+	for(int y = minY; y <= maxY; ++y)
+	{
+		const auto gy = y & WRAP_MASK;
+		for(int x = minX; x <= maxX; ++x)
+		{
+			const auto gx = x & WRAP_MASK;
+			const auto index = gy * CELLS + gx;
+			vector<Entry>::const_iterator it = sorted.begin() + counts[index];
+			vector<Entry>::const_iterator end = sorted.begin() + counts[index + 1];
+
+			for( ; it != end; ++it)
+			{
+				// Unless the grid is tiled, skip objects that were put in this
+				// same grid cell only because of the cell coordinates wrapping around.
+				if(!isTiled && (it->x != x || it->y != y))
+					continue;
+
+				if(seen[it->seenIndex])
+					continue;
+				seen[it->seenIndex] = true;
+				found.push_back(it->seenIndex);
+			}
+		}
+	}
+
+	// Return the objects in the order they were added, so that anything drawn
+	// from this list is layered the same way as if every object were checked.
+	sort(found.begin(), found.end());
+	for(unsigned index : found)
+		result.push_back(all[index]);
+}
+
+
+
 const vector<Body *> &CollisionSet::All() const
 {
 	return all;
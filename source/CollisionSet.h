@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Collision.h"
 #include "CollisionType.h"
+#include "ScratchArena.h"
 
 #include <vector>
 
@@ -24,6 +25,7 @@ class Body;
 class Government;
 class Point;
 class Projectile;
+class Rectangle;
 
 
 
@@ -41,23 +43,32 @@ public:
 	void Clear(int step);
 	// Add an object to the set.
 	void Add(Body &body);
+	// Add an object to the set, as if it covered everything within the given
+	// radius of it (e.g. the range of a weapon) instead of just its sprite.
+	void Add(Body &body, double radius);
 	// Finish adding objects (and organize them into the final lookup table).
 	void Finish();
 
 	// Get all possible collisions for the given projectile. Collisions are not necessarily
 	// sorted by distance.
-	void Line(const Projectile &projectile, std::vector<Collision> &result) const;
+	void Line(const Projectile &projectile, ScratchVector<Collision> &result) const;
 
 	// Get all possible collisions along a line. Collisions are not necessarily sorted by
 	// distance.
-	void Line(const Point &from, const Point &to, std::vector<Collision> &result,
+	void Line(const Point &from, const Point &to, ScratchVector<Collision> &result,
 		const Government *pGov = nullptr, const Body *target = nullptr) const;
 
 	// Get all objects within the given range of the given point.
-	void Circle(const Point &center, double radius, std::vector<Body *> &result) const;
+	void Circle(const Point &center, double radius, ScratchVector<Body *> &result) const;
 	// Get all objects touching a ring with a given inner and outer range
 	// centered at the given point.
-	void Ring(const Point &center, double inner, double outer, std::vector<Body *> &result) const;
+	void Ring(const Point &center, double inner, double outer, ScratchVector<Body *> &result) const;
+	// Get all objects that occupy any grid cell overlapping the given rectangle,
+	// in the order they were added. This is a coarse check, for skipping most
+	// of the objects that cannot be in the rectangle. If the objects repeat
+	// every CELL_SIZE * CELLS pixels (like an asteroid field), set isTiled so
+	// that the repeated copies of them are included too.
+	void Area(const Rectangle &area, ScratchVector<Body *> &result, bool isTiled = false) const;
 
 	// Get all objects within this collision set.
 	const std::vector<Body *> &All() const;
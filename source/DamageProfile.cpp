@@ -16,10 +16,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DamageProfile.h"
 
 #include "DamageDealt.h"
+#include "DamageProtection.h"
 #include "image/Mask.h"
 #include "Minable.h"
 #include "MinableDamageDealt.h"
-#include "Outfit.h"
 #include "Ship.h"
 #include "Weapon.h"
 
@@ -119,17 +119,17 @@ double DamageProfile::Scale(double scale, const Body &body, bool blast) const
 // Populate the given DamageDealt object with values.
 void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 {
-	const Outfit &attributes = ship.Attributes();
+	const DamageProtection &protection = ship.Protection();
 	const Weapon &weapon = damage.GetWeapon();
 	double shieldFraction = 0.;
 
 	// Lambda for returning the damage scale that a damage type should
 	// use given the default percentage that is blocked by shields and hull,
 	// and the value of its protection attribute.
-	auto ScaleType = [&](double shieldBlocked, double hullBlocked, double protection)
+	auto ScaleType = [&](double shieldBlocked, double hullBlocked, double protectionValue)
 	{
 		double blocked = (1. - shieldBlocked) * (shieldFraction) + (1. - hullBlocked) * (1. - shieldFraction);
-		return damage.scaling * blocked / (1. + protection);
+		return damage.scaling * blocked / (1. + protectionValue);
 	};
 
 	// Determine the shieldFraction, which dictates how much damage
@@ -137,11 +137,11 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 	double shields = ship.ShieldLevel();
 	if(shields > 0.)
 	{
-		double piercing = max(0., min(1., weapon.Piercing() / (1. + attributes.Get("piercing protection"))
-			- attributes.Get("piercing resistance")));
-		double highPermeability = attributes.Get("high shield permeability");
-		double lowPermeability = attributes.Get("low shield permeability");
-		double permeability = ship.Cloaking() * attributes.Get("cloaked shield permeability");
+		double piercing = max(0., min(1., weapon.Piercing() / (1. + protection.piercingProtection)
+			- protection.piercingResistance));
+		double highPermeability = protection.highShieldPermeability;
+		double lowPermeability = protection.lowShieldPermeability;
+		double permeability = ship.Cloaking() * protection.cloakedShieldPermeability;
 		if(highPermeability || lowPermeability)
 		{
 			// Determine what portion of its maximum shields the ship is currently at.
@@ -155,8 +155,7 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 
 		damage.shieldDamage = (weapon.ShieldDamage()
 			+ weapon.RelativeShieldDamage() * ship.MaxShields())
-			* ScaleType(0., 0., attributes.Get("shield protection")
-			+ (ship.IsCloaked() ? attributes.Get("cloak shield protection") : 0.));
+			* ScaleType(0., 0., protection.shield + (ship.IsCloaked() ? protection.cloakShield : 0.));
 		if(damage.shieldDamage > shields)
 			shieldFraction = min(shieldFraction, shields / damage.shieldDamage);
 	}
@@ -166,8 +165,7 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 	// Hull damage is blocked 100%.
 	// Shield damage is blocked 0%.
 	damage.shieldDamage *= shieldFraction;
-	double totalHullProtection = (ScaleType(1., 0., attributes.Get("hull protection") +
-		(ship.IsCloaked() ? attributes.Get("cloak hull protection") : 0.)));
+	double totalHullProtection = ScaleType(1., 0., protection.hull + (ship.IsCloaked() ? protection.cloakHull : 0.));
 	damage.hullDamage = (weapon.HullDamage()
 		+ weapon.RelativeHullDamage() * ship.MaxHull())
 		* totalHullProtection;
@@ -182,36 +180,41 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 			* (1. - hullFraction);
 	}
 	damage.energyDamage = (weapon.EnergyDamage()
-		+ weapon.RelativeEnergyDamage() * attributes.Get("energy capacity"))
-		* ScaleType(.5, 0., attributes.Get("energy protection"));
+		+ weapon.RelativeEnergyDamage() * protection.energyCapacity)
+		* ScaleType(.5, 0., protection.energy);
 	damage.heatDamage = (weapon.HeatDamage()
 		+ weapon.RelativeHeatDamage() * ship.MaximumHeat())
-		* ScaleType(.5, 0., attributes.Get("heat protection"));
+		* ScaleType(.5, 0., protection.heat);
 	damage.fuelDamage = (weapon.FuelDamage()
-		+ weapon.RelativeFuelDamage() * attributes.Get("fuel capacity"))
-		* ScaleType(.5, 0., attributes.Get("fuel protection"));
-
-	// DoT damage types with an instantaneous analog.
-	// Ion and burn damage are blocked 50% by shields.
-	// Corrosion and leak damage are blocked 100%.
-	// Discharge damage is blocked 50% by the absence of shields.
-	damage.dischargeDamage = weapon.DischargeDamage() * ScaleType(0., .5, attributes.Get("discharge protection"));
-	damage.corrosionDamage = weapon.CorrosionDamage() * ScaleType(1., 0., attributes.Get("corrosion protection"));
-	damage.ionDamage = weapon.IonDamage() * ScaleType(.5, 0., attributes.Get("ion protection"));
-	damage.burnDamage = weapon.BurnDamage() * ScaleType(.5, 0., attributes.Get("burn protection"));
-	damage.leakDamage = weapon.LeakDamage() * ScaleType(1., 0., attributes.Get("leak protection"));
-
-	// Unique special damage types.
-	// Slowing and scrambling are blocked 50% by shields.
-	// Disruption is blocked 50% by the absence of shields.
-	damage.slowingDamage = weapon.SlowingDamage() * ScaleType(.5, 0., attributes.Get("slowing protection"));
-	damage.scramblingDamage = weapon.ScramblingDamage() * ScaleType(.5, 0., attributes.Get("scramble protection"));
-	damage.disruptionDamage = weapon.DisruptionDamage() * ScaleType(0., .5, attributes.Get("disruption protection"));
+		+ weapon.RelativeFuelDamage() * protection.fuelCapacity)
+		* ScaleType(.5, 0., protection.fuel);
+
+	// Most weapons do none of the remaining damage types, so skip them.
+	if(weapon.DoesStatusDamage())
+	{
+		// DoT damage types with an instantaneous analog.
+		// Ion and burn damage are blocked 50% by shields.
+		// Corrosion and leak damage are blocked 100%.
+		// Discharge damage is blocked 50% by the absence of shields.
+		damage.dischargeDamage = weapon.DischargeDamage() * ScaleType(0., .5, protection.discharge);
+		damage.corrosionDamage = weapon.CorrosionDamage() * ScaleType(1., 0., protection.corrosion);
+		damage.ionDamage = weapon.IonDamage() * ScaleType(.5, 0., protection.ion);
+		damage.burnDamage = weapon.BurnDamage() * ScaleType(.5, 0., protection.burn);
+		damage.leakDamage = weapon.LeakDamage() * ScaleType(1., 0., protection.leak);
+
+		// Unique special damage types.
+		// Slowing and scrambling are blocked 50% by shields.
+		// Disruption is blocked 50% by the absence of shields.
+		damage.slowingDamage = weapon.SlowingDamage() * ScaleType(.5, 0., protection.slowing);
+		damage.scramblingDamage = weapon.ScramblingDamage() * ScaleType(.5, 0., protection.scramble);
+		damage.disruptionDamage = weapon.DisruptionDamage() * ScaleType(0., .5, protection.disruption);
+	}
 
 	// Hit force is unaffected by shields.
-	double hitForce = weapon.HitForce() * ScaleType(0., 0., attributes.Get("force protection"));
+	double hitForce = weapon.HitForce();
 	if(hitForce)
 	{
+		hitForce *= ScaleType(0., 0., protection.force);
 		Point d = ship.Position() - position;
 		double distance = d.Length();
 		if(distance)
@@ -0,0 +1,49 @@
+/* DamageProtection.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "DamageProtection.h"
+
+#include "Outfit.h"
+
+using namespace std;
+
+
+
+DamageProtection::DamageProtection(const Outfit &attributes)
+	: piercingProtection(attributes.Get("piercing protection")),
+	piercingResistance(attributes.Get("piercing resistance")),
+	highShieldPermeability(attributes.Get("high shield permeability")),
+	lowShieldPermeability(attributes.Get("low shield permeability")),
+	cloakedShieldPermeability(attributes.Get("cloaked shield permeability")),
+	shield(attributes.Get("shield protection")),
+	cloakShield(attributes.Get("cloak shield protection")),
+	hull(attributes.Get("hull protection")),
+	cloakHull(attributes.Get("cloak hull protection")),
+	energy(attributes.Get("energy protection")),
+	heat(attributes.Get("heat protection")),
+	fuel(attributes.Get("fuel protection")),
+	discharge(attributes.Get("discharge protection")),
+	corrosion(attributes.Get("corrosion protection")),
+	ion(attributes.Get("ion protection")),
+	burn(attributes.Get("burn protection")),
+	leak(attributes.Get("leak protection")),
+	slowing(attributes.Get("slowing protection")),
+	scramble(attributes.Get("scramble protection")),
+	disruption(attributes.Get("disruption protection")),
+	force(attributes.Get("force protection")),
+	energyCapacity(attributes.Get("energy capacity")),
+	fuelCapacity(attributes.Get("fuel capacity"))
+{
+}
@@ -0,0 +1,61 @@
+/* DamageProtection.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+class Outfit;
+
+
+
+// The attributes of a ship that determine how much damage it takes from each
+// damage type. These are looked up once whenever the ship's outfits change,
+// instead of every time that the ship is hit.
+class DamageProtection {
+public:
+	DamageProtection() = default;
+	explicit DamageProtection(const Outfit &attributes);
+
+
+public:
+	double piercingProtection = 0.;
+	double piercingResistance = 0.;
+	double highShieldPermeability = 0.;
+	double lowShieldPermeability = 0.;
+	double cloakedShieldPermeability = 0.;
+
+	double shield = 0.;
+	double cloakShield = 0.;
+	double hull = 0.;
+	double cloakHull = 0.;
+	double energy = 0.;
+	double heat = 0.;
+	double fuel = 0.;
+
+	double discharge = 0.;
+	double corrosion = 0.;
+	double ion = 0.;
+	double burn = 0.;
+	double leak = 0.;
+
+	double slowing = 0.;
+	double scramble = 0.;
+	double disruption = 0.;
+
+	double force = 0.;
+
+	// The capacities that relative damage is based on.
+	double energyCapacity = 0.;
+	double fuelCapacity = 0.;
+};
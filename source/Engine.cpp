@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Engine.h"
 
 #include "AlertLabel.h"
+#include "AllocationTracker.h"
 #include "audio/Audio.h"
 #include "CategoryList.h"
 #include "CategoryType.h"
@@ -26,6 +27,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DamageProfile.h"
 #include "Effect.h"
 #include "FighterHitHelper.h"
+#include "Files.h"
 #include "shader/FillShader.h"
 #include "Fleet.h"
 #include "Flotsam.h"
@@ -56,6 +58,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Projectile.h"
 #include "Random.h"
 #include "shader/RingShader.h"
+#include "ScratchArena.h"
 #include "Screen.h"
 #include "Ship.h"
 #include "ship/ShipAICache.h"
@@ -275,11 +278,22 @@ namespace {
 
 
 Engine::Engine(PlayerInfo &player)
-	: player(player), ai(player, ships, asteroids.Minables(), flotsam),
+	: player(player), antiMissileRanges(256u, 32u, CollisionType::SHIP),
+	tractorBeamRanges(256u, 32u, CollisionType::SHIP), ai(player, ships, asteroids.Minables(), flotsam),
 	ammoDisplay(player), shipCollisions(256u, 32u, CollisionType::SHIP)
 {
 	zoom.base = Preferences::ViewZoom();
 	zoom.modifier = Preferences::Has("Landing zoom") ? 2. : 1.;
+	simulateOtherSystems = Preferences::Has("Simulate other systems");
+
+	// Profiling which sprites are drawn where is only done on request.
+	recordSpriteUsage = Preferences::Has("Record sprite usage");
+	if(recordSpriteUsage)
+		for(size_t i = 0; i < 2; ++i)
+		{
+			draw[i].SetUsage(&spriteUsage);
+			batchDraw[i].SetUsage(&spriteUsage);
+		}
 
 	if(!player.IsLoaded() || !player.GetSystem())
 		return;
@@ -329,6 +343,9 @@ Engine::~Engine()
 	// Wait for any outstanding task to finish to avoid race conditions when
 	// destroying the engine.
 	queue.Wait();
+
+	if(recordSpriteUsage && !spriteUsage.IsEmpty())
+		spriteUsage.Save(Files::Config() / "sprite usage.txt");
 }
 
 
@@ -336,6 +353,7 @@ Engine::~Engine()
 void Engine::Place()
 {
 	ships.clear();
+	background.Clear();
 	ai.ClearOrders();
 
 	player.SetSystemEntry(SystemEntry::TAKE_OFF);
@@ -567,6 +585,9 @@ void Engine::Step(bool isActive)
 			const System *to = flagship->GetTargetSystem();
 			if(from && to && from != to)
 			{
+				// Warm up the destination's sprites while the jump is under way.
+				if(to != jumpInProgress[1])
+					PreloadSystem(*to);
 				jumpInProgress[0] = from;
 				jumpInProgress[1] = to;
 			}
@@ -1321,7 +1342,8 @@ void Engine::Draw() const
 
 	if(Preferences::Has("Show CPU / GPU load"))
 	{
-		string loadString = to_string(lround(load * 100.)) + "% CPU";
+		string loadString = to_string(lround(load * 100.)) + "% CPU, "
+			+ to_string(scratchAllocations) + " scratch allocations / step";
 		Color color = *colors.Get("medium");
 		font.Draw(loadString,
 			Point(-10 - font.Width(loadString), Screen::Height() * -.5 + 5.), color);
@@ -1407,6 +1429,7 @@ void Engine::BreakTargeting(const Government *gov)
 
 void Engine::EnterSystem()
 {
+	AllocationTracker::Scope allocationScope(AllocationTracker::Phase::ENTER_SYSTEM);
 	ai.Clean();
 
 	Ship *flagship = player.Flagship();
@@ -1552,9 +1575,24 @@ void Engine::EnterSystem()
 
 
 
+// Begin loading any deferred sprites that the given system is expected to
+// need, based on its definition and on what has been drawn there before.
+void Engine::PreloadSystem(const System &system)
+{
+	for(const Sprite *sprite : SpriteUsage::Predict(system))
+		GameData::Preload(queue, sprite);
+	for(const auto &it : spriteUsage.Get(&system))
+		GameData::Preload(queue, it.first);
+}
+
+
+
 void Engine::CalculateStep()
 {
 	FrameTimer loadTimer;
+	AllocationTracker::Scope allocationScope(AllocationTracker::Phase::CALCULATE_STEP);
+	// Any scratch containers used during this step are released at the end of it.
+	ScratchArena::Scope scratchScope;
 
 	// If there is a pending zoom update then use it
 	// because the zoom will get updated in the main thread
@@ -1611,6 +1649,10 @@ void Engine::CalculateStep()
 	// Populate the radar.
 	FillRadar();
 
+	// Attribute everything drawn in this step to the system it is drawn in.
+	if(recordSpriteUsage)
+		spriteUsage.SetSystem(playerSystem);
+
 	// Draw the planets.
 	for(const StellarObject &object : playerSystem->Objects())
 		if(object.HasSprite())
@@ -1682,11 +1724,14 @@ void Engine::CalculateStep()
 
 	// Keep track of how much of the CPU time we are using.
 	loadSum += loadTimer.Time();
+	maxScratchAllocations = max(maxScratchAllocations, ScratchArena::TakeAllocationCount());
 	if(++loadCount == 60)
 	{
 		load = loadSum;
 		loadSum = 0.;
 		loadCount = 0;
+		scratchAllocations = maxScratchAllocations;
+		maxScratchAllocations = 0;
 	}
 }
 
@@ -1695,6 +1740,9 @@ void Engine::CalculateStep()
 // Calculate things that require the engine not to be paused.
 void Engine::CalculateUnpaused(const Ship *flagship, const System *playerSystem)
 {
+	if(simulateOtherSystems)
+		StepBackground(flagship, playerSystem);
+
 	// Now, all the ships must decide what they are doing next.
 	ai.Step(activeCommands);
 
@@ -1775,6 +1823,9 @@ void Engine::CalculateUnpaused(const Ship *flagship, const System *playerSystem)
 		playerSystem = flagship->GetSystem();
 		player.SetSystem(*playerSystem);
 		EnterSystem();
+		// Any ships in the new system that were being simulated in the
+		// background need the full simulation now.
+		background.Release(playerSystem, ships);
 	}
 	PrunePointers(ships);
 
@@ -1853,6 +1904,26 @@ void Engine::CalculateUnpaused(const Ship *flagship, const System *playerSystem)
 
 
 
+// Hand the ships in other systems to the background simulation, and advance it.
+void Engine::StepBackground(const Ship *flagship, const System *playerSystem)
+{
+	const System *flagshipSystem = flagship ? flagship->GetSystem() : nullptr;
+	background.Release(flagshipSystem, ships);
+	for(auto it = ships.begin(); it != ships.end(); )
+	{
+		if(BackgroundSimulation::CanSimulate(**it, playerSystem, flagshipSystem))
+		{
+			background.Add(*it);
+			it = ships.erase(it);
+		}
+		else
+			++it;
+	}
+	background.Step(playerSystem, ships, eventQueue);
+}
+
+
+
 // Move a ship. Also determine if the ship should generate hyperspace sounds or
 // boarding events, fire weapons, and launch fighters.
 void Engine::MoveShip(const shared_ptr<Ship> &ship)
@@ -1970,6 +2041,18 @@ void Engine::FillCollisionSets()
 
 	// Get the ship collision set ready to query.
 	shipCollisions.Finish();
+
+	// Place the ships with anti-missile and tractor beam systems by how far
+	// those systems reach. They are added in the same order as in the lists,
+	// so that they are still checked in that order.
+	antiMissileRanges.Clear(step);
+	for(Ship *ship : hasAntiMissile)
+		antiMissileRanges.Add(*ship, ship->AntiMissileRange());
+	antiMissileRanges.Finish();
+	tractorBeamRanges.Clear(step);
+	for(Ship *ship : hasTractorBeam)
+		tractorBeamRanges.Add(*ship, ship->TractorBeamRange());
+	tractorBeamRanges.Finish();
 }
 
 
@@ -2353,7 +2436,7 @@ void Engine::DoCollisions(Projectile &projectile)
 	// The asteroids can collide with projectiles, the same as any other
 	// object. If the asteroid turns out to be closer than the ship, it
 	// shields the ship (unless the projectile has a blast radius).
-	vector<Collision> collisions;
+	ScratchVector<Collision> collisions;
 	const Government *gov = projectile.GetGovernment();
 	const Weapon &weapon = projectile.GetWeapon();
 
@@ -2379,8 +2462,8 @@ void Engine::DoCollisions(Projectile &projectile)
 		double triggerRadius = weapon.TriggerRadius();
 		if(triggerRadius)
 		{
-			vector<Body *> inRadius;
-			inRadius.reserve(min(static_cast<vector<Body *>::size_type>(triggerRadius), ships.size()));
+			ScratchVector<Body *> inRadius;
+			inRadius.reserve(min(static_cast<size_t>(triggerRadius), ships.size()));
 			shipCollisions.Circle(projectile.Position(), triggerRadius, inRadius);
 			for(const Body *body : inRadius)
 			{
@@ -2444,7 +2527,7 @@ void Engine::DoCollisions(Projectile &projectile)
 			// "safe" weapon.
 			Point hitPos = projectile.Position() + range * projectile.Velocity();
 			bool isSafe = weapon.IsSafe();
-			vector<Body *> blastCollisions;
+			ScratchVector<Body *> blastCollisions;
 			blastCollisions.reserve(32);
 			shipCollisions.Circle(hitPos, blastRadius, blastCollisions);
 			for(Body *body : blastCollisions)
@@ -2493,13 +2576,20 @@ void Engine::DoCollisions(Projectile &projectile)
 	// If the projectile is still alive, give the anti-missile systems a chance to shoot it down.
 	if(!projectile.IsDead() && projectile.MissileStrength())
 	{
-		for(Ship *ship : hasAntiMissile)
+		// Only the ships whose anti-missile range covers this projectile's grid
+		// cell can reach it. They are found in the order they were added.
+		ScratchVector<Body *> defenders;
+		antiMissileRanges.Area(Rectangle(projectile.Position(), Point()), defenders);
+		for(Body *body : defenders)
+		{
+			Ship *ship = reinterpret_cast<Ship *>(body);
 			if(ship == projectile.Target() || gov->IsEnemy(ship->GetGovernment()))
 				if(ship->FireAntiMissile(projectile, visuals))
 				{
 					projectile.Kill();
 					break;
 				}
+		}
 	}
 }
 
@@ -2519,9 +2609,9 @@ void Engine::DoWeather(Weather &weather)
 		// Get all ship bodies that are touching a ring defined by the hazard's min
 		// and max ranges at the hazard's origin. Any ship touching this ring takes
 		// hazard damage.
-		vector<Body *> affectedShips;
+		ScratchVector<Body *> affectedShips;
 		if(hazard->SystemWide())
-			affectedShips = shipCollisions.All();
+			affectedShips.assign(shipCollisions.All().begin(), shipCollisions.All().end());
 		else
 		{
 			affectedShips.reserve(ships.size());
@@ -2542,7 +2632,7 @@ void Engine::DoCollection(Flotsam &flotsam)
 {
 	// Check if any ship can pick up this flotsam. Cloaked ships without "cloaked pickup" cannot act.
 	Ship *collector = nullptr;
-	vector<Body *> pickupShips;
+	ScratchVector<Body *> pickupShips;
 	pickupShips.reserve(16);
 	shipCollisions.Circle(flotsam.Position(), 5., pickupShips);
 	for(Body *body : pickupShips)
@@ -2564,8 +2654,11 @@ void Engine::DoCollection(Flotsam &flotsam)
 		// Also determine the average velocity of the ships pulling on this flotsam.
 		Point avgShipVelocity;
 		int count = 0;
-		for(Ship *ship : hasTractorBeam)
+		ScratchVector<Body *> tractorShips;
+		tractorBeamRanges.Area(Rectangle(flotsam.Position(), Point()), tractorShips);
+		for(Body *body : tractorShips)
 		{
+			Ship *ship = reinterpret_cast<Ship *>(body);
 			Point shipPull = ship->FireTractorBeam(flotsam, visuals);
 			if(shipPull)
 			{
@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "AlertLabel.h"
 #include "AmmoDisplay.h"
 #include "AsteroidField.h"
+#include "BackgroundSimulation.h"
 #include "shader/BatchDrawList.h"
 #include "CollisionSet.h"
 #include "Color.h"
@@ -32,9 +33,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Projectile.h"
 #include "Radar.h"
 #include "Rectangle.h"
+#include "image/SpriteUsage.h"
 #include "TaskQueue.h"
 
 #include <condition_variable>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
@@ -49,6 +52,7 @@ class PlayerInfo;
 class Ship;
 class ShipEvent;
 class Sprite;
+class System;
 class Visual;
 class Weather;
 
@@ -168,10 +172,14 @@ private:
 
 private:
 	void EnterSystem();
+	// Begin loading any deferred sprites that the given system is expected to
+	// need, based on its definition and on what has been drawn there before.
+	void PreloadSystem(const System &system);
 
 	void CalculateStep();
 	// Calculate things that require the engine not to be paused.
 	void CalculateUnpaused(const Ship *flagship, const System *playerSystem);
+	void StepBackground(const Ship *flagship, const System *playerSystem);
 
 	void MoveShip(const std::shared_ptr<Ship> &ship);
 
@@ -221,8 +229,15 @@ private:
 	// tractor beams ready to fire.
 	std::vector<Ship *> hasAntiMissile;
 	std::vector<Ship *> hasTractorBeam;
+	// The same ships, placed in a grid by the range of those systems, so that
+	// each projectile or flotsam only checks the ships that can reach it.
+	CollisionSet antiMissileRanges;
+	CollisionSet tractorBeamRanges;
 
 	AI ai;
+	// If enabled, the NPCs in other systems are handed to a coarser simulation.
+	bool simulateOtherSystems = false;
+	BackgroundSimulation background;
 
 	TaskQueue queue;
 
@@ -235,6 +250,9 @@ private:
 	DrawList draw[2];
 	BatchDrawList batchDraw[2];
 	Radar radar[2];
+	// If enabled, a profile of which sprites are drawn in which systems.
+	bool recordSpriteUsage = false;
+	SpriteUsage spriteUsage;
 
 	bool wasActive = false;
 	bool isMouseHoldEnabled = false;
@@ -316,4 +334,8 @@ private:
 	double load = 0.;
 	int loadCount = 0;
 	double loadSum = 0.;
+	// The most heap allocations made by scratch containers in any one step,
+	// over the same period as the load.
+	int64_t scratchAllocations = 0;
+	int64_t maxScratchAllocations = 0;
 };
@@ -16,6 +16,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Files.h"
 
 #include "Logger.h"
+#include "MappedFile.h"
+#include "PackedArchive.h"
 
 #include <SDL2/SDL.h>
 
@@ -32,6 +34,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
+#include <streambuf>
 
 using namespace std;
 
@@ -49,6 +52,119 @@ namespace {
 
 	shared_ptr<iostream> errorLog;
 
+	// Mounted packed archives, and the directories that they stand in for, with
+	// the most deeply nested directories first.
+	mutex archiveMutex;
+	vector<pair<string, shared_ptr<const PackedArchive>>> archives;
+
+	// Get the given directory in the form used to match paths to archives.
+	string ArchiveRoot(const filesystem::path &path)
+	{
+		string root = path.lexically_normal().generic_string();
+		while(root.length() > 1 && root.ends_with('/'))
+			root.pop_back();
+		return root;
+	}
+
+	// Find the mounted archive that the given path would be in, if any, and the
+	// name of that path within the archive.
+	shared_ptr<const PackedArchive> FindArchive(const filesystem::path &path, string &name)
+	{
+		lock_guard<mutex> lock(archiveMutex);
+		if(archives.empty())
+			return nullptr;
+
+		string full = ArchiveRoot(path);
+		for(const auto &[root, archive] : archives)
+			if(full == root)
+			{
+				name.clear();
+				return archive;
+			}
+			else if(full.length() > root.length() && full.starts_with(root) && full[root.length()] == '/')
+			{
+				name = full.substr(root.length() + 1);
+				return archive;
+			}
+		return nullptr;
+	}
+
+	// Add the files or the directories that are directly within the given
+	// directory in a mounted archive to the given list.
+	void ListArchived(const filesystem::path &directory, bool directories, vector<filesystem::path> &list)
+	{
+		string name;
+		auto archive = FindArchive(directory, name);
+		if(!archive)
+			return;
+
+		size_t prefix = name.empty() ? 0 : name.length() + 1;
+		for(const string &file : archive->List(name))
+		{
+			string_view relative = string_view(file).substr(prefix);
+			size_t slash = relative.find('/');
+			if(directories && slash != string_view::npos)
+				list.emplace_back(directory / relative.substr(0, slash));
+			else if(!directories && slash == string_view::npos)
+				list.emplace_back(directory / relative);
+		}
+	}
+
+	// A read-only buffer for a file within a packed archive. If the file is not
+	// compressed, it is read directly from the archive's mapped memory.
+	class ArchiveBuffer : public streambuf {
+	public:
+		ArchiveBuffer(shared_ptr<const PackedArchive> archive, const string &name)
+			: archive(std::move(archive))
+		{
+			string_view view = this->archive->View(name);
+			if(view.empty())
+			{
+				contents = this->archive->Read(name);
+				view = contents;
+			}
+			char *begin = const_cast<char *>(view.data());
+			setg(begin, begin, begin + view.size());
+		}
+
+	protected:
+		pos_type seekoff(off_type offset, ios_base::seekdir direction, ios_base::openmode mode) override
+		{
+			if(!(mode & ios_base::in))
+				return pos_type(off_type(-1));
+			char *base = (direction == ios_base::beg) ? eback() : (direction == ios_base::end) ? egptr() : gptr();
+			if(offset < eback() - base || offset > egptr() - base)
+				return pos_type(off_type(-1));
+			setg(eback(), base + offset, egptr());
+			return pos_type(gptr() - eback());
+		}
+
+		pos_type seekpos(pos_type position, ios_base::openmode mode) override
+		{
+			return seekoff(off_type(position), ios_base::beg, mode);
+		}
+
+	private:
+		shared_ptr<const PackedArchive> archive;
+		string contents;
+	};
+
+	class ArchiveStream : private ArchiveBuffer, public iostream {
+	public:
+		ArchiveStream(shared_ptr<const PackedArchive> archive, const string &name)
+			: ArchiveBuffer(std::move(archive), name), iostream(static_cast<ArchiveBuffer *>(this)) {}
+	};
+
+	// The contents of a file that has been mapped into memory, along with
+	// whatever must be kept alive for them to remain valid.
+	class MappedContents {
+	public:
+		MappedFile file;
+		shared_ptr<const PackedArchive> archive;
+		string contents;
+		string_view view;
+	};
+
 	// Open the given folder in a separate window.
 	void OpenFolder(const filesystem::path &path)
 	{
@@ -232,16 +348,14 @@ const filesystem::path &Files::Tests()
 vector<filesystem::path> Files::List(const filesystem::path &directory)
 {
 	vector<filesystem::path> list;
-
-	if(!Exists(directory) || !is_directory(directory))
-		return list;
-
-	for(const auto &entry : filesystem::directory_iterator(directory))
-		if(entry.is_regular_file())
-			list.emplace_back(entry);
+	if(exists(directory) && is_directory(directory))
+		for(const auto &entry : filesystem::directory_iterator(directory))
+			if(entry.is_regular_file())
+				list.emplace_back(entry);
+	ListArchived(directory, false, list);
 
 	sort(list.begin(), list.end());
-
+	list.erase(unique(list.begin(), list.end()), list.end());
 	return list;
 }
 
@@ -251,15 +365,14 @@ vector<filesystem::path> Files::List(const filesystem::path &directory)
 vector<filesystem::path> Files::ListDirectories(const filesystem::path &directory)
 {
 	vector<filesystem::path> list;
-
-	if(!Exists(directory) || !is_directory(directory))
-		return list;
-
-	for(const auto &entry : filesystem::directory_iterator(directory))
-		if(entry.is_directory())
-			list.emplace_back(entry);
+	if(exists(directory) && is_directory(directory))
+		for(const auto &entry : filesystem::directory_iterator(directory))
+			if(entry.is_directory())
+				list.emplace_back(entry);
+	ListArchived(directory, true, list);
 
 	sort(list.begin(), list.end());
+	list.erase(unique(list.begin(), list.end()), list.end());
 	return list;
 }
 
@@ -268,22 +381,67 @@ vector<filesystem::path> Files::ListDirectories(const filesystem::path &director
 vector<filesystem::path> Files::RecursiveList(const filesystem::path &directory)
 {
 	vector<filesystem::path> list;
-	if(!Exists(directory) || !is_directory(directory))
-		return list;
-
-	for(const auto &entry : filesystem::recursive_directory_iterator(directory))
-		if(entry.is_regular_file())
-			list.emplace_back(entry);
+	if(exists(directory) && is_directory(directory))
+		for(const auto &entry : filesystem::recursive_directory_iterator(directory))
+			if(entry.is_regular_file())
+				list.emplace_back(entry);
+
+	// Add any files from a packed archive, unless a file with the same path is
+	// actually in the directory.
+	string name;
+	if(auto archive = FindArchive(directory, name))
+	{
+		size_t prefix = name.empty() ? 0 : name.length() + 1;
+		for(const string &file : archive->List(name))
+			list.emplace_back(directory / file.substr(prefix));
+	}
 
 	sort(list.begin(), list.end());
+	list.erase(unique(list.begin(), list.end()), list.end());
 	return list;
 }
 
 
 
+// If the given resources or plugin directory contains a packed archive, mount
+// it so that the files in it are treated as if they were in that directory.
+// Files that are actually in the directory take priority over the archive.
+bool Files::Mount(const filesystem::path &source)
+{
+	filesystem::path path = source / PackedArchive::FILE_NAME;
+	if(!exists(path))
+		return false;
+	shared_ptr<const PackedArchive> archive = PackedArchive::Open(path);
+	if(!archive)
+		return false;
+
+	string root = ArchiveRoot(source);
+	lock_guard<mutex> lock(archiveMutex);
+	auto it = find_if(archives.begin(), archives.end(),
+		[&root](const auto &mounted) { return mounted.first == root; });
+	if(it != archives.end())
+		it->second = std::move(archive);
+	else
+	{
+		// Keep the archives with the longest roots first, so that the archive of a
+		// plugin is found instead of that of the resources directory it is in.
+		it = find_if(archives.begin(), archives.end(),
+			[&root](const auto &mounted) { return mounted.first.length() < root.length(); });
+		archives.emplace(it, root, std::move(archive));
+	}
+	return true;
+}
+
+
+
 bool Files::Exists(const filesystem::path &filePath)
 {
-	return exists(filePath);
+	if(exists(filePath))
+		return true;
+
+	string name;
+	auto archive = FindArchive(filePath, name);
+	return archive && (archive->Has(name) || archive->HasDirectory(name));
 }
 
 
@@ -341,6 +499,10 @@ shared_ptr<iostream> Files::Open(const filesystem::path &path, bool write)
 {
 	if(write)
 		return shared_ptr<iostream>{new fstream{path, ios::out | ios::binary}};
+
+	string name;
+	if(auto archive = FindArchive(path, name); archive && !exists(path) && archive->Has(name))
+		return make_shared<ArchiveStream>(archive, name);
 	return shared_ptr<iostream>{new fstream{path, ios::in | ios::binary}};
 }
 
@@ -348,6 +510,9 @@ shared_ptr<iostream> Files::Open(const filesystem::path &path, bool write)
 
 string Files::Read(const filesystem::path &path)
 {
+	string name;
+	if(auto archive = FindArchive(path, name); archive && !exists(path) && archive->Has(name))
+		return archive->Read(name);
 	return Read(Open(path));
 }
 
@@ -362,6 +527,44 @@ string Files::Read(shared_ptr<iostream> file)
 
 
 
+// Get read-only access to the whole contents of the given file, without
+// copying them if possible. Returns null if the file cannot be read.
+shared_ptr<const string_view> Files::Map(const filesystem::path &path)
+{
+	auto mapped = make_shared<MappedContents>();
+	string name;
+	if(auto archive = FindArchive(path, name); archive && !exists(path) && archive->Has(name))
+	{
+		mapped->view = archive->View(name);
+		if(mapped->view.empty())
+		{
+			mapped->contents = archive->Read(name);
+			mapped->view = mapped->contents;
+		}
+		mapped->archive = std::move(archive);
+	}
+	else
+	{
+		mapped->file = MappedFile(path);
+		if(mapped->file.IsOpen())
+			mapped->view = mapped->file.View();
+		else
+		{
+			// Some files, such as pipes, cannot be mapped but can still be read.
+			if(!exists(path) || is_directory(path))
+				return nullptr;
+			shared_ptr<iostream> in = Open(path);
+			if(!in || !*in)
+				return nullptr;
+			mapped->contents = Read(in);
+			mapped->view = mapped->contents;
+		}
+	}
+	return shared_ptr<const string_view>(mapped, &mapped->view);
+}
+
+
+
 void Files::Write(const filesystem::path &path, const string &data)
 {
 	Write(Open(path, true), data);
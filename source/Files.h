@@ -16,6 +16,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -51,6 +54,11 @@ public:
 	// that it contains, recursively.
 	static std::vector<std::filesystem::path> RecursiveList(const std::filesystem::path &directory);
 
+	// If the given resources or plugin directory contains a packed archive, mount
+	// it so that the files in it are treated as if they were in that directory.
+	// Files that are actually in the directory take priority over the archive.
+	static bool Mount(const std::filesystem::path &source);
+
 	static bool Exists(const std::filesystem::path &filePath);
 	static std::filesystem::file_time_type Timestamp(const std::filesystem::path &filePath);
 	static bool Copy(const std::filesystem::path &from, const std::filesystem::path &to);
@@ -64,6 +72,9 @@ public:
 	static std::shared_ptr<std::iostream> Open(const std::filesystem::path &path, bool write = false);
 	static std::string Read(const std::filesystem::path &path);
 	static std::string Read(std::shared_ptr<std::iostream> file);
+	// Get read-only access to the whole contents of the given file, without
+	// copying them if possible. Returns null if the file cannot be read.
+	static std::shared_ptr<const std::string_view> Map(const std::filesystem::path &path);
 	static void Write(const std::filesystem::path &path, const std::string &data);
 	static void Write(std::shared_ptr<std::iostream> file, const std::string &data);
 	static void CreateFolder(const std::filesystem::path &path);
@@ -185,6 +185,14 @@ const Government *Fleet::GetGovernment() const
 
 
 
+// Get the variants this fleet chooses from when it spawns.
+const WeightedList<Variant> &Fleet::Variants() const
+{
+	return variants;
+}
+
+
+
 // Choose a fleet to be created during flight, and have it enter the system via jump or planetary departure.
 void Fleet::Enter(const System &system, list<shared_ptr<Ship>> &ships, const Planet *planet) const
 {
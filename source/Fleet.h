@@ -59,6 +59,8 @@ public:
 
 	// Get the government of this fleet.
 	const Government *GetGovernment() const;
+	// Get the variants this fleet chooses from when it spawns.
+	const WeightedList<Variant> &Variants() const;
 
 	// Choose a fleet to be created during flight, and have it enter the system via jump or planetary departure.
 	void Enter(const System &system, std::list<std::shared_ptr<Ship>> &ships, const Planet *planet = nullptr) const;
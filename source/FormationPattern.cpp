@@ -258,6 +258,18 @@ FormationPattern::PositionIterator FormationPattern::begin(double centerBodyRadi
 
 
 
+// Get the first count positions in this pattern all at once.
+vector<Point> FormationPattern::Positions(size_t count, double centerBodyRadius) const
+{
+	vector<Point> positions;
+	positions.reserve(count);
+	for(auto it = begin(centerBodyRadius); positions.size() < count; ++it)
+		positions.push_back(*it);
+	return positions;
+}
+
+
+
 // Get the number of lines (and arcs) in this formation.
 unsigned int FormationPattern::Lines() const
 {
@@ -87,6 +87,8 @@ public:
 
 	// Get an iterator to iterate over the formation positions in this pattern.
 	PositionIterator begin(double centerBodyRadius) const;
+	// Get the first count positions in this pattern all at once.
+	std::vector<Point> Positions(size_t count, double centerBodyRadius) const;
 
 	// Information about allowed rotating and mirroring that still results in the same formation.
 	int Rotatable() const;
@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 using namespace std;
 
@@ -66,28 +67,23 @@ Point FormationPositioner::Position(const Ship *ship)
 {
 	Point relPos;
 
-	auto it = shipPositions.find(ship);
-	if(it != shipPositions.end())
+	auto it = lower_bound(slotIndex.begin(), slotIndex.end(), ship,
+		[](const pair<const Ship *, unsigned> &entry, const Ship *ship) { return entry.first < ship; });
+	if(it != slotIndex.end() && it->first == ship)
 	{
-		// Retrieve the ships currently known coordinate in the formation.
-		auto &status = it->second;
-
-		// Register that this ship was seen.
-		if(status.second != tickTock)
-			status.second = tickTock;
-
-		// Return the cached position that we have for the ship.
-		relPos = status.first;
+		// Register that this ship was seen, and return the cached position
+		// that we have for the ship.
+		Slot &slot = slots[it->second];
+		slot.round = round;
+		relPos = slot.position;
 	}
 	else
 	{
-		// Add the ship to the set of coordinates. We add it with a default
-		// coordinate of Point(0,0), it will gets its proper coordinate in
-		// the next generate round.
-		shipPositions[ship] = make_pair(relPos, tickTock);
-
-		// Add the ship to the ring.
-		shipsInFormation.push_back(ship->shared_from_this());
+		// Add the ship to the formation. We add it with a default coordinate
+		// of Point(0,0), it will get its proper coordinate in the next
+		// generate round.
+		slotIndex.emplace(it, ship, slots.size());
+		slots.push_back(Slot{ship->shared_from_this(), ship, relPos, round});
 
 		// Trigger immediate re-generation of the formation positions (to
 		// ensure that this new ship also gets a valid position).
@@ -102,53 +98,42 @@ Point FormationPositioner::Position(const Ship *ship)
 // Re-generate the list of (relative) positions for the ships in the formation.
 void FormationPositioner::CalculatePositions()
 {
-	// Run the position iterator for the ships in the formation.
-	auto itPos = pattern->begin(centerBodyRadius);
+	// Generate the positions of the pattern in one go, with some room to spare
+	// so that this does not need to be done again for every ship that joins.
+	if(patternPositions.size() < slots.size())
+		patternPositions = pattern->Positions(max<size_t>(2 * slots.size(), 8), centerBodyRadius);
 
-	// Run the iterator.
+	bool removedShips = false;
 	size_t shipIndex = 0;
-	while(shipIndex < shipsInFormation.size())
+	while(shipIndex < slots.size())
 	{
 		// If the ship is no longer valid or not or no longer part of this
-		// formation, then we need to remove it.
-		auto ship = shipsInFormation[shipIndex].lock();
-		bool removeShip = !ship || !IsActiveInFormation(ship.get());
-
-		// Lookup the ship in the positions map.
-		auto itCoor = shipPositions.end();
-		if(ship)
-			itCoor = shipPositions.find(ship.get());
-
-		// If the ship is not in the overall table or if it was not
-		// active since the last iteration, then we also remove it.
-		removeShip |= itCoor == shipPositions.end() ||
-				itCoor->second.second != tickTock;
-
-		// Perform removes if we need to.
-		if(removeShip)
+		// formation, or if it was not active since the last iteration, then
+		// we need to remove it. Ships are not freed while the AI is running,
+		// so there is no need to lock the handle to check it.
+		const Slot &slot = slots[shipIndex];
+		if(slot.handle.expired() || slot.round != round || !IsActiveInFormation(slot.ship))
 		{
-			// Remove the ship from the ring.
 			Remove(shipIndex);
-			// And remove the ship from the shipsPositions map.
-			if(itCoor != shipPositions.end())
-				shipPositions.erase(itCoor);
+			removedShips = true;
 		}
 		else
 		{
 			// Calculate the new coordinate for the current ship.
-			Point &shipRelPos = itCoor->second.first;
-			shipRelPos = *itPos;
+			Point &shipRelPos = slots[shipIndex].position;
+			shipRelPos = patternPositions[shipIndex];
 			if(flippedY)
 				shipRelPos.Set(-shipRelPos.X(), shipRelPos.Y());
 			if(flippedX)
 				shipRelPos.Set(shipRelPos.X(), -shipRelPos.Y());
-			++itPos;
 			++shipIndex;
 		}
 	}
+	if(removedShips)
+		IndexSlots();
 
-	// Switch marker to detect stale/missing ships in the next iteration.
-	tickTock = !tickTock;
+	// Start a new round, to detect stale/missing ships in the next iteration.
+	++round;
 }
 
 
@@ -248,13 +233,24 @@ bool FormationPositioner::IsActiveInFormation(const Ship *ship) const
 // ship itself is not the last ship).
 void FormationPositioner::Remove(unsigned int index)
 {
-	if(shipsInFormation.empty())
+	if(slots.empty())
 		return;
 
 	// Move the last element to the current position and remove the last
 	// element; this will let last ship take the position of the ship that
 	// we will remove.
-	if(index < shipsInFormation.size() - 1)
-		shipsInFormation[index].swap(shipsInFormation.back());
-	shipsInFormation.pop_back();
+	if(index < slots.size() - 1)
+		swap(slots[index], slots.back());
+	slots.pop_back();
+}
+
+
+
+// Rebuild the lookup table of ships' slots after ships have been removed.
+void FormationPositioner::IndexSlots()
+{
+	slotIndex.clear();
+	for(unsigned i = 0; i < slots.size(); ++i)
+		slotIndex.emplace_back(slots[i].ship, i);
+	sort(slotIndex.begin(), slotIndex.end());
 }
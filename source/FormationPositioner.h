@@ -16,9 +16,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include "Angle.h"
+#include "Point.h"
 
-#include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 class Body;
@@ -57,14 +58,31 @@ private:
 	// ship itself is not the last ship).
 	void Remove(unsigned int index);
 
+	// Rebuild the lookup table of ships' slots after ships have been removed.
+	void IndexSlots();
+
 
 private:
-	// Lists of ships on the rings. Used when (re)generating positions for the ring.
-	// The actual positions are stored in shipPositions.
-	std::vector<std::weak_ptr<const Ship>> shipsInFormation;
-	// Lookup/cache of the ship coordinates in the formation, its ring-section and
-	// an indicator if it was seen since last generate loop.
-	std::map<const Ship *, std::pair<Point, bool>> shipPositions;
+	// A ship that participates in the formation, and its coordinates in it.
+	class Slot {
+	public:
+		// This handle is only used to check if the ship still exists.
+		std::weak_ptr<const Ship> handle;
+		const Ship *ship;
+		Point position;
+		// The round of position calculations in which this ship last asked for
+		// its position.
+		unsigned round;
+	};
+
+	// The ships in the formation, in the order that they are assigned positions.
+	std::vector<Slot> slots;
+	// The index of each ship's slot, sorted by ship for fast lookups.
+	std::vector<std::pair<const Ship *, unsigned>> slotIndex;
+	// The positions in the pattern, in order. These only depend on the pattern
+	// and on the center body radius, so they are only generated again if more
+	// ships join the formation.
+	std::vector<Point> patternPositions;
 
 	// Timer that controls the (re)generation of ship positions.
 	int positionsTimer = 0;
@@ -86,5 +104,5 @@ private:
 
 	// Status variable used to track if ships still participate in the formation.
 	// TODO: This method of tracking shouldn't be needed; ships themselves should have a state to show what they are doing.
-	bool tickTock = true;
+	unsigned round = 0;
 };
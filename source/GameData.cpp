@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "GameData.h"
 
+#include "AllocationTracker.h"
 #include "audio/Audio.h"
 #include "shader/BatchShader.h"
 #include "CategoryList.h"
@@ -51,8 +52,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Plugins.h"
 #include "shader/PointerShader.h"
 #include "Politics.h"
+#include "shader/RadarShader.h"
 #include "RenderBuffer.h"
 #include "shader/RingShader.h"
+#include "Screen.h"
 #include "Ship.h"
 #include "image/Sprite.h"
 #include "image/SpriteSet.h"
@@ -67,8 +70,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <atomic>
+#include <functional>
 #include <iostream>
 #include <queue>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -92,6 +97,9 @@ namespace {
 
 	vector<filesystem::path> sources;
 	map<const Sprite *, shared_ptr<ImageSet>> deferred;
+	// Image sets with @2x frames or swizzle masks that were not loaded yet,
+	// so that they can be loaded once they are needed.
+	map<const Sprite *, shared_ptr<ImageSet>> partiallyLoaded;
 	map<const Sprite *, int> preloaded;
 
 	MaskManager maskManager;
@@ -111,12 +119,37 @@ namespace {
 	// List of image sets that are waiting to be uploaded to the GPU.
 	mutex imageQueueMutex;
 	queue<shared_ptr<ImageSet>> imageQueue;
+	// The number of image sets from the queue that are currently being loaded.
+	int activeLoads = 0;
+
+	// Loads the images of a sprite. The @2x frames are only loaded if the
+	// current display mode uses them, and swizzle masks only once a sprite is
+	// drawn with a swizzle that needs them. Until the game window exists, the
+	// display mode is not known, so all the images are loaded rather than
+	// drawing the first frames without them. If the images are not going to be
+	// uploaded, all of them are loaded so that any errors in them are reported.
+	// The frames are loaded in parallel, and then the given function is called
+	// in the main thread.
+	void LoadImages(TaskQueue &queue, const shared_ptr<ImageSet> &image, function<void()> loaded)
+	{
+		bool loadAll = preventSpriteUpload || !Screen::IsHighDPIKnown();
+		image->Load(queue, loadAll || Screen::IsHighResolution(), loadAll, std::move(loaded));
+	}
+
+	// Uploads the images of a sprite, and remembers it if it has other images
+	// that might need to be loaded later.
+	void UploadImages(const shared_ptr<ImageSet> &image)
+	{
+		Sprite *sprite = SpriteSet::Modify(image->Name());
+		image->Upload(sprite, !preventSpriteUpload);
+		if(!preventSpriteUpload && image->UnloadedVariants())
+			partiallyLoaded[sprite] = image;
+	}
 
 	// Loads a sprite and queues it for upload to the GPU.
 	void LoadSprite(TaskQueue &queue, const shared_ptr<ImageSet> &image)
 	{
-		queue.Run([image] { image->Load(); },
-			[image] { image->Upload(SpriteSet::Modify(image->Name()), !preventSpriteUpload); });
+		queue.Run([image, &queue] { LoadImages(queue, image, [image] { UploadImages(image); }); });
 	}
 
 	void LoadSpriteQueued(TaskQueue &queue, const shared_ptr<ImageSet> &image);
@@ -124,7 +157,10 @@ namespace {
 	void LoadSpriteQueued(TaskQueue &queue)
 	{
 		if(imageQueue.empty())
+		{
+			--activeLoads;
 			return;
+		}
 
 		// Start loading the next image in the list.
 		// This is done to save memory on startup.
@@ -136,18 +172,55 @@ namespace {
 	// Recursively loads the next image in the queue, if any.
 	void LoadSpriteQueued(TaskQueue &queue, const shared_ptr<ImageSet> &image)
 	{
-		queue.Run([image] { image->Load(); },
-			[image, &queue]
+		queue.Run([image, &queue]
 			{
-				image->Upload(SpriteSet::Modify(image->Name()), !preventSpriteUpload);
-				++spritesLoaded;
-
-				// Start loading the next image in the queue, if any.
-				lock_guard lock(imageQueueMutex);
-				LoadSpriteQueued(queue);
+				LoadImages(queue, image, [image, &queue]
+					{
+						UploadImages(image);
+						++spritesLoaded;
+
+						// Start loading the next image in the queue, if any.
+						lock_guard lock(imageQueueMutex);
+						LoadSpriteQueued(queue);
+					});
 			});
 	}
 
+	// Add the given image sets to the queue of images to load, and start loading
+	// them if there are not already enough images being loaded. Deferred images
+	// are only remembered, not loaded.
+	void QueueImages(TaskQueue &queue, map<string, shared_ptr<ImageSet>> &images)
+	{
+		for(auto &it : images)
+			if(it.second)
+				it.second->ValidateFrames();
+
+		lock_guard lock(imageQueueMutex);
+		for(auto &it : images)
+		{
+			// This should never happen, but just in case:
+			if(!it.second)
+				continue;
+
+			// For landscapes, remember all the source files but don't load them yet.
+			if(ImageSet::IsDeferred(it.first))
+				deferred[SpriteSet::Get(it.first)] = std::move(it.second);
+			else
+			{
+				imageQueue.push(std::move(it.second));
+				++totalSprites;
+			}
+		}
+
+		// Launch the tasks to actually load the images, making sure not to exceed the amount
+		// of tasks the main thread can handle in a single frame to limit peak memory usage.
+		while(activeLoads < TaskQueue::MAX_SYNC_TASKS && !imageQueue.empty())
+		{
+			++activeLoads;
+			LoadSpriteQueued(queue);
+		}
+	}
+
 	void LoadPlugin(TaskQueue &queue, const filesystem::path &path)
 	{
 		const auto *plugin = Plugins::Load(path);
@@ -193,6 +266,9 @@ namespace {
 shared_future<void> GameData::BeginLoad(TaskQueue &queue, bool onlyLoadData, bool debugMode, bool preventUpload)
 {
 	preventSpriteUpload = preventUpload;
+	// Until the game data is finished loading, count allocations on the worker
+	// threads as part of loading it.
+	AllocationTracker::SetDefaultPhase(AllocationTracker::Phase::LOAD);
 
 	// Initialize the list of "source" folders based on any active plugins.
 	LoadSources(queue);
@@ -200,39 +276,21 @@ shared_future<void> GameData::BeginLoad(TaskQueue &queue, bool onlyLoadData, boo
 	if(!onlyLoadData)
 	{
 		queue.Run([&queue] {
-			// Now, read all the images in all the path directories. For each unique
-			// name, only remember one instance, letting things on the higher priority
-			// paths override the default images.
-			map<string, shared_ptr<ImageSet>> images = FindImages();
-
-			// From the name, strip out any frame number, plus the extension.
-			for(auto &it : images)
-			{
-				// This should never happen, but just in case:
-				if(!it.second)
-					continue;
-
-				// Reduce the set of images to those that are valid.
-				it.second->ValidateFrames();
-				// For landscapes, remember all the source files but don't load them yet.
-				if(ImageSet::IsDeferred(it.first))
-					deferred[SpriteSet::Get(it.first)] = std::move(it.second);
-				else
-				{
-					lock_guard lock(imageQueueMutex);
-					imageQueue.push(std::move(std::move(it.second)));
-					++totalSprites;
-				}
-			}
-			queuedAllImages = true;
-
-			// Launch the tasks to actually load the images, making sure not to exceed the amount
-			// of tasks the main thread can handle in a single frame to limit peak memory usage.
-			{
-				lock_guard lock(imageQueueMutex);
-				for(int i = 0; i < TaskQueue::MAX_SYNC_TASKS; ++i)
-					LoadSpriteQueued(queue);
-			}
+			// Now, read all the images in all the path directories. Each directory
+			// within "images/" is scanned separately, in parallel. All the frames of
+			// an image are in the same directory, so each directory's images can
+			// begin loading as soon as that directory has been scanned in every source.
+			vector<filesystem::path> directories = FindImageDirectories();
+			auto remaining = make_shared<atomic<size_t>>(directories.size());
+			for(const filesystem::path &directory : directories)
+				queue.Run([&queue, directory, remaining] {
+					map<string, shared_ptr<ImageSet>> images = FindImages(directory);
+					QueueImages(queue, images);
+					if(!--*remaining)
+						queuedAllImages = true;
+				});
+			if(directories.empty())
+				queuedAllImages = true;
 
 			// Generate a catalog of music files.
 			Music::Init(sources);
@@ -259,6 +317,7 @@ void GameData::FinishLoading()
 	playerGovernment = objects.governments.Get("Escort");
 
 	politics.Reset();
+	AllocationTracker::SetDefaultPhase(AllocationTracker::Phase::OTHER);
 }
 
 
@@ -289,6 +348,7 @@ void GameData::LoadShaders()
 	LineShader::Init();
 	OutlineShader::Init();
 	PointerShader::Init();
+	RadarShader::Init();
 	RingShader::Init();
 	SpriteShader::Init();
 	BatchShader::Init();
@@ -368,6 +428,36 @@ void GameData::Preload(TaskQueue &queue, const Sprite *sprite)
 
 
 
+// Begin loading the @2x frames or swizzle masks of any sprites that have been
+// drawn in a way that needs them since this was last called.
+void GameData::LoadRequestedVariants(TaskQueue &queue)
+{
+	for(Sprite *sprite : SpriteSet::TakeRequests())
+	{
+		int variants = sprite->TakeRequestedVariants();
+		auto it = partiallyLoaded.find(sprite);
+		if(!variants || it == partiallyLoaded.end())
+			continue;
+
+		// While this image set is loading, it must not be loaded again. If the
+		// sprite still needs other images after this, it will be added back.
+		shared_ptr<ImageSet> image = std::move(it->second);
+		partiallyLoaded.erase(it);
+		queue.Run([image, variants]
+			{
+				image->LoadVariants(variants & Sprite::HIGH_DPI, variants & Sprite::SWIZZLE_MASK);
+			},
+			[image, sprite]
+			{
+				image->UploadVariants(sprite);
+				if(image->UnloadedVariants())
+					partiallyLoaded[sprite] = image;
+			});
+	}
+}
+
+
+
 // Get the list of resource sources (i.e. plugin folders).
 const vector<filesystem::path> &GameData::Sources()
 {
@@ -927,21 +1017,46 @@ void GameData::LoadSources(TaskQueue &queue)
 {
 	sources.clear();
 	sources.push_back(Files::Resources());
+	Files::Mount(Files::Resources());
 
+	// Plugins may be distributed as a packed archive, so mount any archives
+	// before checking which directories contain a plugin.
 	vector<filesystem::path> globalPlugins = Files::ListDirectories(Files::GlobalPlugins());
 	for(const auto &path : globalPlugins)
+	{
+		Files::Mount(path);
 		if(Plugins::IsPlugin(path))
 			LoadPlugin(queue, path);
+	}
 
 	vector<filesystem::path> localPlugins = Files::ListDirectories(Files::UserPlugins());
 	for(const auto &path : localPlugins)
+	{
+		Files::Mount(path);
 		if(Plugins::IsPlugin(path))
 			LoadPlugin(queue, path);
+	}
+}
+
+
+
+// Get the directories within the "images/" directory of any source, as paths
+// relative to it. An empty path stands for the images directly within "images/".
+vector<filesystem::path> GameData::FindImageDirectories()
+{
+	set<filesystem::path> directories = {filesystem::path()};
+	for(const auto &source : sources)
+		for(const auto &path : Files::ListDirectories(source / "images/"))
+			directories.insert(path.filename());
+	return vector<filesystem::path>(directories.begin(), directories.end());
 }
 
 
 
-map<string, shared_ptr<ImageSet>> GameData::FindImages()
+// Find the images in the given directory within the "images/" directory of each
+// source. For each unique name, only remember one instance, letting things on
+// the higher priority paths override the default images.
+map<string, shared_ptr<ImageSet>> GameData::FindImages(const filesystem::path &directory)
 {
 	map<string, shared_ptr<ImageSet>> images;
 	for(const auto &source : sources)
@@ -950,7 +1065,8 @@ map<string, shared_ptr<ImageSet>> GameData::FindImages()
 		// this directory prefix.
 		filesystem::path directoryPath = source / "images/";
 
-		vector<filesystem::path> imageFiles = Files::RecursiveList(directoryPath);
+		vector<filesystem::path> imageFiles = directory.empty() ? Files::List(directoryPath)
+			: Files::RecursiveList(directoryPath / directory);
 		for(auto &path : imageFiles)
 			if(ImageSet::IsImage(path))
 			{
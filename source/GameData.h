@@ -88,6 +88,9 @@ public:
 	// Begin loading a sprite that was previously deferred. Currently this is
 	// done with all landscapes to speed up the program's startup.
 	static void Preload(TaskQueue &queue, const Sprite *sprite);
+	// Begin loading the @2x frames or swizzle masks of any sprites that have been
+	// drawn in a way that needs them since this was last called.
+	static void LoadRequestedVariants(TaskQueue &queue);
 
 	// Get the list of resource sources (i.e. plugin folders).
 	static const std::vector<std::filesystem::path> &Sources();
@@ -182,5 +185,6 @@ public:
 
 private:
 	static void LoadSources(TaskQueue &queue);
-	static std::map<std::string, std::shared_ptr<ImageSet>> FindImages();
+	static std::vector<std::filesystem::path> FindImageDirectories();
+	static std::map<std::string, std::shared_ptr<ImageSet>> FindImages(const std::filesystem::path &directory);
 };
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameWindow.h"
 
 #include "Files.h"
+#include "image/CompressedTexture.h"
 #include "image/ImageBuffer.h"
 #include "image/ImageFileData.h"
 #include "Logger.h"
@@ -236,6 +237,7 @@ bool GameWindow::Init(bool headless)
 
 	// Check for support of various graphical features.
 	supportsAdaptiveVSync = OpenGL::HasAdaptiveVSyncSupport();
+	CompressedTexture::SetEnabled(Preferences::Has("Compress textures") && OpenGL::HasTextureCompressionSupport());
 
 	// Enable the user's preferred VSync state, otherwise update to an available
 	// value (e.g. if an external program is forcing a particular VSync state).
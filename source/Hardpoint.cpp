@@ -36,8 +36,7 @@ namespace {
 	void CreateEffects(const map<const Effect *, int> &m, Point pos, Point vel, Angle angle, vector<Visual> &visuals)
 	{
 		for(const auto &it : m)
-			for(int i = 0; i < it.second; ++i)
-				visuals.emplace_back(*it.first, pos, vel, angle);
+			Visual::Spawn(visuals, it.second, *it.first, pos, vel, angle);
 	}
 }
 
@@ -97,6 +97,10 @@ void ItemInfoDisplay::DrawAttributes(const Point &topLeft) const
 
 void ItemInfoDisplay::DrawTooltips() const
 {
+	// A tooltip builds up while the mouse stays over a label, and fades once it leaves.
+	isTooltipChanging = isHoverFound ? hoverCount < HOVER_TIME : hoverCount > 0;
+	isHoverFound = false;
+
 	if(!hoverCount || hoverCount-- < HOVER_TIME || !hoverText.Height())
 		return;
 
@@ -115,6 +119,15 @@ void ItemInfoDisplay::DrawTooltips() const
 
 
 
+// Check if the last call to DrawTooltips() left a tooltip partway through
+// appearing or disappearing, so that it needs to be drawn again.
+bool ItemInfoDisplay::IsTooltipChanging() const
+{
+	return isTooltipChanging;
+}
+
+
+
 // Update the location where the mouse is hovering.
 void ItemInfoDisplay::Hover(const Point &point)
 {
@@ -210,6 +223,7 @@ void ItemInfoDisplay::CheckHover(const Table &table, const string &label) const
 	Point radius = .5 * table.GetRowSize();
 	if(abs(distance.X()) < radius.X() && abs(distance.Y()) < radius.Y())
 	{
+		isHoverFound = true;
 		hoverCount += 2 * (label == hover);
 		hover = label;
 		if(hoverCount >= HOVER_TIME)
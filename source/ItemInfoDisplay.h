@@ -44,6 +44,9 @@ public:
 	void DrawDescription(const Point &topLeft) const;
 	virtual void DrawAttributes(const Point &topLeft) const;
 	void DrawTooltips() const;
+	// Check if the last call to DrawTooltips() left a tooltip partway through
+	// appearing or disappearing, so that it needs to be drawn again.
+	bool IsTooltipChanging() const;
 
 	// Update the location where the mouse is hovering.
 	void Hover(const Point &point);
@@ -73,5 +76,8 @@ protected:
 	mutable std::string hover;
 	mutable int hoverCount = 0;
 	bool hasHover = false;
+	// Whether the mouse was over one of the labels when they were last drawn.
+	mutable bool isHoverFound = false;
+	mutable bool isTooltipChanging = false;
 	mutable WrappedText hoverText;
 };
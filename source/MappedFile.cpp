@@ -0,0 +1,175 @@
+/* MappedFile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "MappedFile.h"
+
+#if defined _WIN32
+#define STRICT
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+using namespace std;
+
+
+
+// Map the given file. If it cannot be mapped, IsOpen() will return false.
+MappedFile::MappedFile(const filesystem::path &path)
+{
+#ifdef _WIN32
+	file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		file = nullptr;
+		return;
+	}
+	LARGE_INTEGER length;
+	if(!GetFileSizeEx(file, &length))
+		return;
+	size = length.QuadPart;
+	// A file with no contents cannot be mapped.
+	if(!size)
+	{
+		isOpen = true;
+		return;
+	}
+	mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(!mapping)
+		return;
+	data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	isOpen = data;
+#else
+	file = open(path.c_str(), O_RDONLY);
+	if(file < 0)
+		return;
+	struct stat status;
+	if(fstat(file, &status) || !S_ISREG(status.st_mode))
+		return;
+	size = status.st_size;
+	// A file with no contents cannot be mapped.
+	if(!size)
+	{
+		isOpen = true;
+		return;
+	}
+	void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	if(mapped == MAP_FAILED)
+		return;
+	data = static_cast<const char *>(mapped);
+	isOpen = true;
+#endif
+}
+
+
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+	Swap(other);
+}
+
+
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+	if(this != &other)
+	{
+		Close();
+		Swap(other);
+	}
+	return *this;
+}
+
+
+
+// Check whether the file was mapped successfully. An empty file counts as
+// mapped, even though there is nothing to map.
+bool MappedFile::IsOpen() const
+{
+	return isOpen;
+}
+
+
+
+const char *MappedFile::Data() const
+{
+	return data;
+}
+
+
+
+size_t MappedFile::Size() const
+{
+	return isOpen ? size : 0;
+}
+
+
+
+string_view MappedFile::View() const
+{
+	return data ? string_view(data, size) : string_view();
+}
+
+
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if(data)
+		UnmapViewOfFile(data);
+	if(mapping)
+		CloseHandle(mapping);
+	if(file)
+		CloseHandle(file);
+	mapping = nullptr;
+	file = nullptr;
+#else
+	if(data)
+		munmap(const_cast<char *>(data), size);
+	if(file >= 0)
+		close(file);
+	file = -1;
+#endif
+	data = nullptr;
+	size = 0;
+	isOpen = false;
+}
+
+
+
+void MappedFile::Swap(MappedFile &other) noexcept
+{
+	swap(data, other.data);
+	swap(size, other.size);
+	swap(isOpen, other.isOpen);
+	swap(file, other.file);
+#ifdef _WIN32
+	swap(mapping, other.mapping);
+#endif
+}
@@ -0,0 +1,62 @@
+/* MappedFile.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+
+
+// A file that has been mapped into memory for reading, so that its contents
+// can be accessed directly without reading them into a buffer first. The file
+// stays mapped for as long as this object exists.
+class MappedFile {
+public:
+	MappedFile() = default;
+	// Map the given file. If it cannot be mapped, IsOpen() will return false.
+	explicit MappedFile(const std::filesystem::path &path);
+	MappedFile(const MappedFile &) = delete;
+	MappedFile(MappedFile &&other) noexcept;
+	~MappedFile();
+
+	MappedFile &operator=(const MappedFile &) = delete;
+	MappedFile &operator=(MappedFile &&other) noexcept;
+
+	// Check whether the file was mapped successfully. An empty file counts as
+	// mapped, even though there is nothing to map.
+	bool IsOpen() const;
+	const char *Data() const;
+	size_t Size() const;
+	std::string_view View() const;
+
+
+private:
+	void Close();
+	void Swap(MappedFile &other) noexcept;
+
+
+private:
+	const char *data = nullptr;
+	size_t size = 0;
+	bool isOpen = false;
+#ifdef _WIN32
+	void *file = nullptr;
+	void *mapping = nullptr;
+#else
+	int file = -1;
+#endif
+};
@@ -33,6 +33,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "System.h"
 #include "UI.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <sstream>
@@ -1218,8 +1219,10 @@ bool Mission::HasShip(const shared_ptr<Ship> &ship) const
 
 
 // If any event occurs between two ships, check to see if this mission cares
-// about it. This may affect the mission status or display a message.
-void Mission::Do(const ShipEvent &event, PlayerInfo &player, UI *ui)
+// about it. This may affect the mission status or display a message. If the
+// NPCs that the event's target belongs to are already known, only those NPCs
+// are told about the event.
+void Mission::Do(const ShipEvent &event, PlayerInfo &player, UI *ui, const vector<const NPC *> *targetNPCs)
 {
 	if(event.TargetGovernment()->IsPlayer() && !IsFailed(player))
 	{
@@ -1274,7 +1277,8 @@ void Mission::Do(const ShipEvent &event, PlayerInfo &player, UI *ui)
 	}
 
 	for(NPC &npc : npcs)
-		npc.Do(event, player, ui, this, isVisible);
+		if(!targetNPCs || find(targetNPCs->begin(), targetNPCs->end(), &npc) != targetNPCs->end())
+			npc.Do(event, player, ui, this, isVisible);
 }
 
 
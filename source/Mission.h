@@ -29,6 +29,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -171,8 +172,11 @@ public:
 	// Checks if the given ship belongs to one of the mission's NPCs.
 	bool HasShip(const std::shared_ptr<Ship> &ship) const;
 	// If any event occurs between two ships, check to see if this mission cares
-	// about it. This may affect the mission status or display a message.
-	void Do(const ShipEvent &event, PlayerInfo &player, UI *ui);
+	// about it. This may affect the mission status or display a message. If the
+	// NPCs that the event's target belongs to are already known, only those NPCs
+	// are told about the event.
+	void Do(const ShipEvent &event, PlayerInfo &player, UI *ui,
+		const std::vector<const NPC *> *targetNPCs = nullptr);
 	bool RequiresGiftedShip(const std::string &shipId) const;
 
 	// Get the internal name used for this mission. This name is unique and is
@@ -0,0 +1,334 @@
+/* PackedArchive.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "PackedArchive.h"
+
+#include "Files.h"
+#include "Logger.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+using namespace std;
+
+namespace {
+	// The archive begins with a header that identifies it and gives the number
+	// of files and the size of the table of their names:
+	//   char magic[8], uint32 version, uint32 count, uint64 namesSize, uint64 reserved
+	// That is followed by an entry for each file, sorted by name:
+	//   uint64 offset, uint64 storedSize, uint64 size, uint32 nameOffset, uint32 nameLength
+	// and then by the table of names, and the contents of the files. All values
+	// are stored in little-endian order.
+	const char MAGIC[8] = {'E', 'S', 'P', 'A', 'C', 'K', '\0', '\0'};
+	const uint32_t VERSION = 1;
+	const size_t HEADER_SIZE = 32;
+	const size_t ENTRY_SIZE = 32;
+	const uint64_t ALIGNMENT = 16;
+	// Only keep the compressed version of a file if it is at most this fraction
+	// of the original size. Images and sounds that are already compressed would
+	// otherwise be decompressed every time they are read, for almost no benefit.
+	const double COMPRESSION_THRESHOLD = .9;
+
+	uint64_t Align(uint64_t offset)
+	{
+		return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+	void Put(string &out, uint64_t value, int bytes)
+	{
+		for(int i = 0; i < bytes; ++i)
+			out += static_cast<char>((value >> (8 * i)) & 0xFF);
+	}
+
+	uint64_t Get(const char *in, int bytes)
+	{
+		uint64_t value = 0;
+		for(int i = 0; i < bytes; ++i)
+			value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+		return value;
+	}
+
+	string Compress(const string &contents)
+	{
+		uLongf size = compressBound(contents.size());
+		string compressed(size, '\0');
+		if(compress2(reinterpret_cast<Bytef *>(compressed.data()), &size,
+				reinterpret_cast<const Bytef *>(contents.data()), contents.size(), Z_BEST_COMPRESSION) != Z_OK)
+			return contents;
+		compressed.resize(size);
+		return compressed;
+	}
+
+	void LogInvalid(const filesystem::path &archive)
+	{
+		Logger::LogError("Error: \"" + archive.string() + "\" is not a valid packed archive.");
+	}
+}
+
+
+
+const string PackedArchive::FILE_NAME = "content.pack";
+
+
+
+// Pack the given files into an archive at the given path. Each file is named
+// by its path relative to the given root directory.
+bool PackedArchive::Write(const filesystem::path &archive, const filesystem::path &root,
+	const vector<filesystem::path> &files, bool compress)
+{
+	vector<pair<string, filesystem::path>> named;
+	named.reserve(files.size());
+	for(const filesystem::path &path : files)
+	{
+		string name = path.lexically_normal().lexically_relative(root.lexically_normal()).generic_string();
+		if(name.empty() || name == "." || name.starts_with(".."))
+		{
+			Logger::LogError("Error: \"" + path.string() + "\" is not within \"" + root.string() + "\".");
+			return false;
+		}
+		named.emplace_back(std::move(name), path);
+	}
+	sort(named.begin(), named.end());
+	named.erase(unique(named.begin(), named.end(),
+		[](const auto &a, const auto &b) { return a.first == b.first; }), named.end());
+
+	string names;
+	for(const auto &it : named)
+		names += it.first;
+
+	ofstream out(archive, ios::out | ios::binary | ios::trunc);
+	if(!out)
+	{
+		Logger::LogError("Error: unable to write \"" + archive.string() + "\".");
+		return false;
+	}
+
+	// Write the contents of each file first, leaving room for the index, since
+	// the compressed sizes are not known until each file has been read.
+	uint64_t offset = Align(HEADER_SIZE + ENTRY_SIZE * named.size() + names.size());
+	out << string(offset, '\0');
+
+	string index;
+	uint32_t nameOffset = 0;
+	for(const auto &it : named)
+	{
+		string contents = Files::Read(it.second);
+		uint64_t size = contents.size();
+		if(compress && !contents.empty())
+		{
+			string compressed = Compress(contents);
+			if(compressed.size() <= COMPRESSION_THRESHOLD * size)
+				contents = std::move(compressed);
+		}
+		uint64_t storedSize = contents.size();
+		uint64_t padding = Align(storedSize) - storedSize;
+		out << contents << string(padding, '\0');
+
+		Put(index, offset, 8);
+		Put(index, storedSize, 8);
+		Put(index, size, 8);
+		Put(index, nameOffset, 4);
+		Put(index, it.first.size(), 4);
+		offset += storedSize + padding;
+		nameOffset += it.first.size();
+	}
+
+	string header(MAGIC, sizeof(MAGIC));
+	Put(header, VERSION, 4);
+	Put(header, named.size(), 4);
+	Put(header, names.size(), 8);
+	Put(header, 0, 8);
+
+	out.seekp(0);
+	out << header << index << names;
+	out.close();
+	if(!out)
+	{
+		Logger::LogError("Error: unable to write \"" + archive.string() + "\".");
+		return false;
+	}
+	return true;
+}
+
+
+
+// Map the archive at the given path into memory. Returns null if the archive
+// could not be opened or is not valid.
+shared_ptr<PackedArchive> PackedArchive::Open(const filesystem::path &archive)
+{
+	shared_ptr<PackedArchive> result(new PackedArchive());
+
+	result->file = MappedFile(archive);
+	if(!result->file.IsOpen())
+		return nullptr;
+	if(result->file.Size() < HEADER_SIZE)
+	{
+		LogInvalid(archive);
+		return nullptr;
+	}
+	result->data = result->file.Data();
+
+	// Check that the index is complete and consistent before trusting any of it.
+	const char *data = result->data;
+	uint64_t length = result->file.Size();
+	if(memcmp(data, MAGIC, sizeof(MAGIC)) || Get(data + 8, 4) != VERSION)
+	{
+		LogInvalid(archive);
+		return nullptr;
+	}
+	uint64_t count = Get(data + 12, 4);
+	uint64_t namesSize = Get(data + 16, 8);
+	uint64_t namesStart = HEADER_SIZE + ENTRY_SIZE * count;
+	if(namesStart > length || namesSize > length - namesStart)
+	{
+		LogInvalid(archive);
+		return nullptr;
+	}
+
+	result->entries.reserve(count);
+	for(uint64_t i = 0; i < count; ++i)
+	{
+		const char *in = data + HEADER_SIZE + ENTRY_SIZE * i;
+		Entry entry;
+		entry.offset = Get(in, 8);
+		entry.storedSize = Get(in + 8, 8);
+		entry.size = Get(in + 16, 8);
+		uint64_t nameOffset = Get(in + 24, 4);
+		uint64_t nameLength = Get(in + 28, 4);
+		if(entry.offset > length || entry.storedSize > length - entry.offset
+				|| nameOffset + nameLength > namesSize)
+		{
+			LogInvalid(archive);
+			return nullptr;
+		}
+		entry.name = string_view(data + namesStart + nameOffset, nameLength);
+		if(!result->entries.empty() && !(result->entries.back().name < entry.name))
+		{
+			LogInvalid(archive);
+			return nullptr;
+		}
+		result->entries.push_back(entry);
+	}
+
+	return result;
+}
+
+
+
+// Get the number of files in this archive.
+size_t PackedArchive::Size() const
+{
+	return entries.size();
+}
+
+
+
+// Check whether the archive contains a file with the given name.
+bool PackedArchive::Has(string_view name) const
+{
+	return Find(name);
+}
+
+
+
+// Check whether the archive contains any files within the given directory.
+bool PackedArchive::HasDirectory(string_view directory) const
+{
+	string prefix(directory);
+	if(!prefix.empty() && !prefix.ends_with('/'))
+		prefix += '/';
+	auto it = LowerBound(prefix);
+	return it != entries.end() && it->name.starts_with(prefix);
+}
+
+
+
+// Get the names of all the files within the given directory or any directory
+// that it contains, in sorted order.
+vector<string> PackedArchive::List(string_view directory) const
+{
+	string prefix(directory);
+	if(!prefix.empty() && !prefix.ends_with('/'))
+		prefix += '/';
+
+	vector<string> list;
+	for(auto it = LowerBound(prefix); it != entries.end() && it->name.starts_with(prefix); ++it)
+		list.emplace_back(it->name);
+	return list;
+}
+
+
+
+// Get the contents of the given file, decompressing it if necessary.
+string PackedArchive::Read(string_view name) const
+{
+	const Entry *entry = Find(name);
+	if(!entry)
+		return "";
+	if(entry->storedSize == entry->size)
+		return string(data + entry->offset, entry->storedSize);
+
+	string contents(entry->size, '\0');
+	uLongf size = entry->size;
+	if(uncompress(reinterpret_cast<Bytef *>(contents.data()), &size,
+			reinterpret_cast<const Bytef *>(data + entry->offset), entry->storedSize) != Z_OK || size != entry->size)
+	{
+		Logger::LogError("Error: unable to decompress \"" + string(name) + "\" from a packed archive.");
+		return "";
+	}
+	return contents;
+}
+
+
+
+// Get the contents of the given file directly from the mapped memory. This is
+// empty if the file does not exist or is compressed.
+string_view PackedArchive::View(string_view name) const
+{
+	const Entry *entry = Find(name);
+	if(!entry || entry->storedSize != entry->size)
+		return {};
+	return string_view(data + entry->offset, entry->storedSize);
+}
+
+
+
+// Check whether the given file is stored compressed.
+bool PackedArchive::IsCompressed(string_view name) const
+{
+	const Entry *entry = Find(name);
+	return entry && entry->storedSize != entry->size;
+}
+
+
+
+// Find the first entry whose name is not less than the given name.
+vector<PackedArchive::Entry>::const_iterator PackedArchive::LowerBound(string_view name) const
+{
+	return lower_bound(entries.begin(), entries.end(), name,
+		[](const Entry &entry, string_view name) { return entry.name < name; });
+}
+
+
+
+const PackedArchive::Entry *PackedArchive::Find(string_view name) const
+{
+	auto it = LowerBound(name);
+	return (it != entries.end() && it->name == name) ? &*it : nullptr;
+}
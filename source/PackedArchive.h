@@ -0,0 +1,97 @@
+/* PackedArchive.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+// A single file that holds the contents of many asset files, so that they can
+// all be found and read without opening each of them separately. The archive
+// starts with an index of all the files it contains, sorted by name, followed
+// by the contents of each file, each aligned to a 16 byte boundary. The contents
+// of a file may be compressed, if that makes it significantly smaller.
+// The archive is memory mapped when opened, so reading a file that is not
+// compressed does not need to copy its contents at all.
+class PackedArchive {
+public:
+	// The name of the archive file within a resources or plugin directory.
+	static const std::string FILE_NAME;
+
+
+public:
+	// Pack the given files into an archive at the given path. Each file is named
+	// by its path relative to the given root directory.
+	static bool Write(const std::filesystem::path &archive, const std::filesystem::path &root,
+		const std::vector<std::filesystem::path> &files, bool compress = true);
+	// Map the archive at the given path into memory. Returns null if the archive
+	// could not be opened or is not valid.
+	static std::shared_ptr<PackedArchive> Open(const std::filesystem::path &archive);
+
+	PackedArchive(const PackedArchive &) = delete;
+	PackedArchive &operator=(const PackedArchive &) = delete;
+
+	// Get the number of files in this archive.
+	size_t Size() const;
+	// Check whether the archive contains a file with the given name.
+	bool Has(std::string_view name) const;
+	// Check whether the archive contains any files within the given directory.
+	bool HasDirectory(std::string_view directory) const;
+	// Get the names of all the files within the given directory or any directory
+	// that it contains, in sorted order.
+	std::vector<std::string> List(std::string_view directory) const;
+
+	// Get the contents of the given file, decompressing it if necessary.
+	std::string Read(std::string_view name) const;
+	// Get the contents of the given file directly from the mapped memory. This is
+	// empty if the file does not exist or is compressed.
+	std::string_view View(std::string_view name) const;
+	// Check whether the given file is stored compressed.
+	bool IsCompressed(std::string_view name) const;
+
+
+private:
+	class Entry {
+	public:
+		std::string_view name;
+		uint64_t offset;
+		uint64_t storedSize;
+		uint64_t size;
+	};
+
+
+private:
+	PackedArchive() = default;
+
+	// Find the first entry whose name is not less than the given name.
+	std::vector<Entry>::const_iterator LowerBound(std::string_view name) const;
+	const Entry *Find(std::string_view name) const;
+
+
+private:
+	MappedFile file;
+	const char *data = nullptr;
+
+	std::vector<Entry> entries;
+};
@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameData.h"
 #include "Point.h"
 #include "Preferences.h"
+#include "RenderBuffer.h"
 #include "Screen.h"
 #include "image/Sprite.h"
 #include "shader/SpriteShader.h"
@@ -269,13 +270,48 @@ bool Panel::DoScroll(double dx, double dy)
 
 void Panel::DoDraw()
 {
-	Draw();
+	if(isRetained)
+		DrawRetained();
+	else
+		Draw();
 	for(auto &child : children)
 		child->DoDraw();
 }
 
 
 
+// Draw this panel's retained image, redrawing it first if it is out of date.
+void Panel::DrawRetained()
+{
+	// The image must be recreated if the window has been resized or zoomed.
+	Point size(Screen::Width(), Screen::Height());
+	if(!retained || retained->Dimensions() != size || retainedZoom != Screen::Zoom())
+	{
+		retained = make_shared<RenderBuffer>(size);
+		retainedZoom = Screen::Zoom();
+		isRetainedValid = false;
+	}
+
+	if(isRetainedValid)
+	{
+		// The UI clears every panel's clickable zones before drawing, so restore
+		// the ones that were added when the image was drawn.
+		zones = retainedZones;
+	}
+	else
+	{
+		// Mark the image as valid first, so that Draw() can invalidate it again.
+		isRetainedValid = true;
+		auto target = retained->SetTarget();
+		Draw();
+		target.Deactivate();
+		retainedZones = zones;
+	}
+	retained->Draw(Point());
+}
+
+
+
 void Panel::SetIsFullScreen(bool set)
 {
 	isFullScreen = set;
@@ -297,6 +333,28 @@ void Panel::SetInterruptible(bool set)
 
 
 
+void Panel::SetRetained(bool set)
+{
+	isRetained = set;
+	isRetainedValid = false;
+	if(!set)
+	{
+		retained.reset();
+		retainedZones.clear();
+	}
+}
+
+
+
+// Make a retained panel call Draw() again the next time it is drawn. This
+// may also be called from within Draw() to request another frame.
+void Panel::Invalidate()
+{
+	isRetainedValid = false;
+}
+
+
+
 // Dim the background of this panel.
 void Panel::DrawBackdrop() const
 {
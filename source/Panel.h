@@ -28,6 +28,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 class Command;
 class Point;
+class RenderBuffer;
 class Sprite;
 class TestContext;
 class UI;
@@ -93,6 +94,15 @@ protected:
 	void SetIsFullScreen(bool set);
 	void SetTrapAllEvents(bool set);
 	void SetInterruptible(bool set);
+	// Draw this panel into an offscreen buffer, and keep showing that image
+	// instead of calling Draw() until the panel is invalidated. A panel is
+	// invalidated automatically whenever it handles user input or the stack of
+	// panels changes; anything else that changes what it draws, including any
+	// animation, must call Invalidate().
+	void SetRetained(bool set);
+	// Make a retained panel call Draw() again the next time it is drawn. This
+	// may also be called from within Draw() to request another frame.
+	void Invalidate();
 
 	// Dim the background of this panel.
 	void DrawBackdrop() const;
@@ -144,6 +154,8 @@ private:
 	bool DoScroll(double dx, double dy);
 
 	void DoDraw();
+	// Draw this panel's retained image, redrawing it first if it is out of date.
+	void DrawRetained();
 
 	// Call a method on all the children in reverse order, and then on this
 	// object. Recursion stops as soon as any child returns true.
@@ -160,6 +172,14 @@ private:
 
 	std::list<Zone> zones;
 
+	// The image of a retained panel, and the clickable zones that were added
+	// when it was drawn.
+	bool isRetained = false;
+	bool isRetainedValid = false;
+	int retainedZoom = 0;
+	std::shared_ptr<RenderBuffer> retained;
+	std::list<Zone> retainedZones;
+
 	std::vector<std::shared_ptr<Panel>> children;
 	std::vector<std::shared_ptr<Panel>> childrenToAdd;
 	std::vector<const Panel *> childrenToRemove;
@@ -177,6 +197,8 @@ bool Panel::EventVisit(bool (Panel::*f)(FARGS ...), ARGS ...args)
 		if((*it)->EventVisit(f, args...))
 			return true;
 
-	// If none of our children handled this event, then it could be for us.
+	// If none of our children handled this event, then it could be for us. Any
+	// input may change what this panel draws.
+	Invalidate();
 	return (this->*f)(args...);
 }
@@ -21,6 +21,21 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
+namespace {
+	// Replace every occurrence of the target that comes after the given position.
+	void ReplaceAllFrom(string &text, size_t start, const string &target, const string &replacement)
+	{
+		// Most replacements do not apply to most text, so only copy the text if
+		// there is something in it to replace.
+		if(target.empty() || text.find(target, start) == string::npos)
+			return;
+
+		string tail(text, start);
+		Format::ReplaceAll(tail, target, replacement);
+		text.replace(start, string::npos, tail);
+	}
+}
+
 
 
 // Replace all occurrences ${phrase name} with the expanded phrase from GameData::Phrases()
@@ -41,7 +56,10 @@ std::string Phrase::ExpandPhrases(const std::string &source)
 		++next;
 		string phraseName = string{source, var + 2, next - var - 3};
 		const Phrase *phrase = GameData::Phrases().Find(phraseName);
-		result.append(phrase ? phrase->Get() : phraseName);
+		if(phrase)
+			phrase->Append(result);
+		else
+			result.append(phraseName);
 	}
 	// Optimization for most common case: no phrase in string:
 	if(!next)
@@ -102,23 +120,38 @@ const string &Phrase::Name() const
 string Phrase::Get() const
 {
 	string result;
+	Append(result);
+	return result;
+}
+
+
+
+// Add a random sentence's text to the end of the given string. Any nested
+// phrases are expanded directly into the same string, and replacements only
+// change the text that this phrase added.
+void Phrase::Append(string &result) const
+{
 	if(sentences.empty())
-		return result;
+		return;
 
+	const size_t start = result.length();
 	for(const auto &part : sentences[Random::Int(sentences.size())])
 	{
 		if(!part.choices.empty())
 		{
 			const auto &choice = part.choices.Get();
 			for(const auto &element : choice)
-				result += element.second ? element.second->Get() : element.first;
+			{
+				if(element.second)
+					element.second->Append(result);
+				else
+					result += element.first;
+			}
 		}
 		else if(!part.replacements.empty())
 			for(const auto &pair : part.replacements)
-				Format::ReplaceAll(result, pair.first, pair.second);
+				ReplaceAllFrom(result, start, pair.first, pair.second);
 	}
-
-	return result;
 }
 
 
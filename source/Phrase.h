@@ -48,6 +48,8 @@ public:
 
 
 private:
+	// Add a random sentence's text to the end of the given string.
+	void Append(std::string &result) const;
 	bool ReferencesPhrase(const Phrase *phrase) const;
 
 
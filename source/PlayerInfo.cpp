@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PlayerInfo.h"
 
 #include "AI.h"
+#include "AllocationTracker.h"
 #include "audio/Audio.h"
 #include "ConversationPanel.h"
 #include "DataFile.h"
@@ -330,6 +331,7 @@ void PlayerInfo::Load(const filesystem::path &path)
 		{
 			missions.emplace_back(child);
 			cargo.AddMissionCargo(&missions.back());
+			missionIndexIsStale = true;
 		}
 		else if((child.Token(0) == "mission cargo" || child.Token(0) == "mission passengers") && child.HasChildren())
 		{
@@ -1533,28 +1535,27 @@ void PlayerInfo::Land(UI *ui)
 	if(planet == travelDestination)
 		travelDestination = nullptr;
 
-	// Remove any ships that have been destroyed or captured.
+	// Remove any ships that have been destroyed or captured. This is done in a
+	// single pass, because a large fleet may lose many ships at once.
 	map<string, int> lostCargo;
-	vector<shared_ptr<Ship>>::iterator it = ships.begin();
-	while(it != ships.end())
-	{
-		if((*it)->IsDestroyed() || !(*it)->IsYours())
+	ships.erase(remove_if(ships.begin(), ships.end(),
+		[this, &lostCargo](const shared_ptr<Ship> &ship)
 		{
+			if(!ship->IsDestroyed() && ship->IsYours())
+				return false;
+
 			// If any of your ships are destroyed, your cargo "cost basis" should
 			// be adjusted based on what you lost.
-			for(const auto &cargo : (*it)->Cargo().Commodities())
+			for(const auto &cargo : ship->Cargo().Commodities())
 				if(cargo.second)
 					lostCargo[cargo.first] += cargo.second;
 			// Also, the ship and everything in it should be removed from your
 			// depreciation records. Transfer it to a throw-away record:
-			Depreciation().Buy(**it, date.DaysSinceEpoch(), &depreciation);
+			Depreciation().Buy(*ship, date.DaysSinceEpoch(), &depreciation);
 
-			ForgetGiftedShip(*it->get());
-			it = ships.erase(it);
-		}
-		else
-			++it;
-	}
+			ForgetGiftedShip(*ship);
+			return true;
+		}), ships.end());
 
 	// "Unload" all fighters, so they will get recharged, etc.
 	for(const shared_ptr<Ship> &ship : ships)
@@ -1759,15 +1760,35 @@ bool PlayerInfo::TakeOff(UI *ui, const bool distributeCargo)
 				{
 					return a->JumpsRemaining() < b->JumpsRemaining();
 				});
+			// Count the empty bays of each category that the carriers in each system
+			// have. Each list is in reverse order, so that the first carrier in the
+			// fleet with an empty bay is always at the back.
+			map<pair<const System *, string>, vector<pair<Ship *, int>>> emptyBays;
+			for(auto it = carriers.rbegin(); it != carriers.rend(); ++it)
+			{
+				map<string, int> bayCount;
+				for(const Ship::Bay &bay : (*it)->Bays())
+					if(!bay.ship)
+						++bayCount[bay.category];
+				for(const auto &bays : bayCount)
+					emptyBays[{(*it)->GetSystem(), bays.first}].emplace_back(*it, bays.second);
+			}
 			// We are guaranteed that each carried `ship` is not parked and not disabled, and that
 			// all possible parents are also not parked, not disabled, and not `ship`.
 			for(auto &ship : toLoad)
-				for(auto &parent : carriers)
-					if(parent->GetSystem() == ship->GetSystem() && parent->Carry(ship))
-					{
-						--uncarried;
-						break;
-					}
+			{
+				auto it = emptyBays.find({ship->GetSystem(), ship->Attributes().Category()});
+				if(it == emptyBays.end() || it->second.empty())
+					continue;
+
+				auto &parent = it->second.back();
+				if(parent.first->Carry(ship))
+				{
+					--uncarried;
+					if(!--parent.second)
+						it->second.pop_back();
+				}
+			}
 		}
 
 		if(uncarried)
@@ -2129,6 +2150,7 @@ void PlayerInfo::AcceptJob(const Mission &mission, UI *ui)
 			cargo.AddMissionCargo(&mission);
 			auto spliceIt = it->IsUnique() ? missions.begin() : missions.end();
 			missions.splice(spliceIt, availableJobs, it);
+			missionIndexIsStale = true;
 			it->Do(Mission::OFFER, *this);
 			it->Do(Mission::ACCEPT, *this, ui);
 			if(it->IsFailed(*this))
@@ -2274,6 +2296,7 @@ void PlayerInfo::MissionCallback(int response)
 		// to the front, so they appear at the top of the list if viewed.
 		auto spliceIt = mission.IsUnique() ? missions.begin() : missions.end();
 		missions.splice(spliceIt, missionList, missionList.begin());
+		missionIndexIsStale = true;
 		mission.Do(Mission::ACCEPT, *this);
 		if(shouldAutosave)
 			Autosave();
@@ -2319,6 +2342,7 @@ void PlayerInfo::RemoveMission(Mission::Trigger trigger, const Mission &mission,
 			// this first avoids the possibility of an infinite loop, e.g. if a
 			// mission's "on fail" fails the mission itself.
 			doneMissions.splice(doneMissions.end(), missions, it);
+			missionIndexIsStale = true;
 
 			it->Do(trigger, *this, ui);
 			cargo.RemoveMissionCargo(&mission);
@@ -2355,8 +2379,54 @@ void PlayerInfo::HandleEvent(const ShipEvent &event, UI *ui)
 			rating = min(maxRating, rating + (event.Target()->Cost() + 250000) / 500000);
 		}
 
-	for(Mission &mission : missions)
-		mission.Do(event, *this, ui);
+	// Events involving the flagship may concern any mission. Any other event
+	// only concerns the missions whose NPCs include its target, and if it is
+	// one of the player's ships, the missions whose cargo is on board it.
+	int type = event.Type();
+	if((type & ShipEvent::JUMP) || ((type & ShipEvent::DISABLE) && event.Target() == FlagshipPtr()))
+		for(Mission &mission : missions)
+			mission.Do(event, *this, ui);
+	else
+	{
+		if(missionIndexIsStale)
+			IndexMissionNPCs();
+
+		// Collect the missions in the same order as the list of active missions.
+		map<size_t, vector<const NPC *>> concerned;
+		auto it = missionNPCShips.find(event.Target().get());
+		if(it != missionNPCShips.end())
+			for(const auto &npcs : it->second)
+				concerned.insert(npcs);
+		if(event.TargetGovernment() && event.TargetGovernment()->IsPlayer())
+		{
+			auto addCargo = [this, &concerned](const auto &missionCargo)
+			{
+				for(const auto &cargoIt : missionCargo)
+				{
+					auto indexIt = missionIndices.find(cargoIt.first);
+					if(indexIt != missionIndices.end())
+						concerned.try_emplace(indexIt->second);
+				}
+			};
+			if(type & ShipEvent::DESTROY)
+			{
+				addCargo(event.Target()->Cargo().MissionCargo());
+				addCargo(event.Target()->Cargo().PassengerList());
+			}
+			else if((type & ShipEvent::BOARD) && event.Actor())
+				addCargo(event.Actor()->Cargo().MissionCargo());
+		}
+
+		for(const auto &missionIt : concerned)
+		{
+			Mission *mission = indexedMissions[missionIt.first];
+			// A mission may have been removed by an earlier mission's actions.
+			if(missionIndexIsStale && none_of(missions.begin(), missions.end(),
+					[mission](const Mission &active) { return &active == mission; }))
+				continue;
+			mission->Do(event, *this, ui, &missionIt.second);
+		}
+	}
 
 	// If the player's flagship was destroyed, the player is dead.
 	if((event.Type() & ShipEvent::DESTROY) && !ships.empty() && event.Target().get() == Flagship())
@@ -3230,7 +3300,10 @@ void PlayerInfo::ValidateLoad()
 	// the standard mission list, effectively pausing them until necessary data is restored.
 	auto mit = stable_partition(missions.begin(), missions.end(), mem_fn(&Mission::IsValid));
 	if(mit != missions.end())
+	{
 		inactiveMissions.splice(inactiveMissions.end(), missions, mit, missions.end());
+		missionIndexIsStale = true;
+	}
 
 	// Invalid available jobs or missions are erased (since there is no guarantee
 	// the player will be on the correct planet when a plugin is re-added).
@@ -4326,6 +4399,8 @@ void PlayerInfo::Save(const string &filePath) const
 
 void PlayerInfo::Save(DataWriter &out) const
 {
+	AllocationTracker::Scope allocationScope(AllocationTracker::Phase::SAVE);
+
 	// Basic player information and persistent UI settings:
 
 	// Pilot information:
@@ -4780,3 +4855,30 @@ bool PlayerInfo::CanBeSaved() const
 {
 	return (!isDead && planet && system && !firstName.empty() && !lastName.empty());
 }
+
+
+
+// Find which active missions' NPCs each ship belongs to. The NPCs of a mission
+// never change, so this only needs to be done when missions are added or removed.
+void PlayerInfo::IndexMissionNPCs()
+{
+	indexedMissions.clear();
+	missionIndices.clear();
+	missionNPCShips.clear();
+	for(Mission &mission : missions)
+	{
+		size_t index = indexedMissions.size();
+		indexedMissions.push_back(&mission);
+		missionIndices[&mission] = index;
+		for(const NPC &npc : mission.NPCs())
+			for(const shared_ptr<Ship> &ship : npc.Ships())
+			{
+				auto &entries = missionNPCShips[ship.get()];
+				if(entries.empty() || entries.back().first != index)
+					entries.emplace_back(index, vector<const NPC *>());
+				if(entries.back().second.empty() || entries.back().second.back() != &npc)
+					entries.back().second.push_back(&npc);
+			}
+	}
+	missionIndexIsStale = false;
+}
@@ -378,6 +378,9 @@ private:
 	// Handle the daily salaries and payments.
 	void DoAccounting();
 
+	// Find which active missions' NPCs each ship belongs to.
+	void IndexMissionNPCs();
+
 
 private:
 	std::string firstName;
@@ -427,6 +430,14 @@ private:
 	// This pointer to the most recently accepted boarding mission enables
 	// its NPCs to be placed before the player lands, and is then cleared.
 	Mission *activeBoardingMission = nullptr;
+	// The active missions in order, and for each ship that belongs to one of
+	// their NPCs, the index of each such mission and which of its NPCs the ship
+	// is in. Ship events are only sent to the missions that they concern. This
+	// must be rebuilt whenever the list of active missions changes.
+	std::vector<Mission *> indexedMissions;
+	std::map<const Mission *, size_t> missionIndices;
+	std::map<const Ship *, std::vector<std::pair<size_t, std::vector<const NPC *>>>> missionNPCShips;
+	bool missionIndexIsStale = true;
 	// How to sort availableJobs
 	bool availableSortAsc = true;
 	SortType availableSortType;
@@ -180,6 +180,8 @@ PlayerInfoPanel::PlayerInfoPanel(PlayerInfo &player, InfoPanelState panelState)
 {
 	Audio::Pause();
 	SetInterruptible(false);
+	// Nothing on this panel changes unless the player interacts with it.
+	SetRetained(true);
 }
 
 
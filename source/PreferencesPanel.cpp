@@ -701,6 +701,7 @@ void PreferencesPanel::DrawSettings()
 		"Show CPU / GPU load",
 		"Render motion blur",
 		"Reduce large graphics",
+		"Compress textures",
 		"Draw background haze",
 		"Draw starfield",
 		BACKGROUND_PARALLAX,
@@ -740,14 +741,15 @@ void PreferencesPanel::DrawSettings()
 		"Fighters transfer cargo",
 		"Rehire extra crew when lost",
 		"Automatically unpark flagship",
-		"",
+		"Simulate other systems",
+		"\t",
 		"Map",
 		"Deadline blink by distance",
 		"Hide unexplored map regions",
 		"Show escort systems on map",
 		"Show stored outfits on map",
 		"System map sends move orders",
-		"\t",
+		"",
 		"Other",
 		"Always underline shortcuts",
 		REACTIVATE_HELP,
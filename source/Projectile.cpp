@@ -90,7 +90,9 @@ Projectile::Projectile(const Projectile &parent, const Point &offset, const Angl
 	targetDisabled = parent.targetDisabled;
 	hitsRemaining = weapon->PenetrationCount();
 
-	cachedTarget = TargetPtr().get();
+	// The parent looks up its target once for all of its submunitions, rather
+	// than each of them locking the same pointer again.
+	cachedTarget = parent.cachedTarget;
 
 	// Given that submunitions inherit the velocity of the parent projectile,
 	// it is often the case that submunitions don't add any additional velocity.
@@ -128,18 +130,22 @@ void Projectile::Move(vector<Visual> &visuals, vector<Projectile> &projectiles)
 		{
 			// This projectile didn't die in a collision. Create any death effects.
 			for(const auto &it : weapon->DieEffects())
-				for(int i = 0; i < it.second; ++i)
-					visuals.emplace_back(*it.first, position, velocity, angle);
+				Visual::Spawn(visuals, it.second, *it.first, position, velocity, angle);
 
+			// Check whether the target still exists once for all the submunitions.
+			if(!weapon->Submunitions().empty())
+				cachedTarget = TargetPtr().get();
+			const bool naturalDeath = (lifetime > -100);
 			for(const auto &it : weapon->Submunitions())
-				if(lifetime > -100 ? it.spawnOnNaturalDeath : it.spawnOnAntiMissileDeath)
+				if(naturalDeath ? it.spawnOnNaturalDeath : it.spawnOnAntiMissileDeath)
+				{
+					const Weapon *const subWeapon = it.weapon;
+					const double inaccuracy = subWeapon->Inaccuracy();
+					const auto distribution = subWeapon->InaccuracyDistribution();
 					for(size_t i = 0; i < it.count; ++i)
-					{
-						const Weapon *const subWeapon = it.weapon;
-						Angle inaccuracy = Distribution::GenerateInaccuracy(subWeapon->Inaccuracy(),
-								subWeapon->InaccuracyDistribution());
-						projectiles.emplace_back(*this, it.offset, it.facing + inaccuracy, subWeapon);
-					}
+						projectiles.emplace_back(*this, it.offset,
+							it.facing + Distribution::GenerateInaccuracy(inaccuracy, distribution), subWeapon);
+				}
 		}
 		MarkForRemoval();
 		return;
@@ -276,8 +282,7 @@ void Projectile::Move(vector<Visual> &visuals, vector<Projectile> &projectiles)
 void Projectile::Explode(vector<Visual> &visuals, double intersection, Point hitVelocity)
 {
 	for(const auto &it : weapon->HitEffects())
-		for(int i = 0; i < it.second; ++i)
-			visuals.emplace_back(*it.first, position + velocity * intersection, velocity, angle, hitVelocity);
+		Visual::Spawn(visuals, it.second, *it.first, position + velocity * intersection, velocity, angle, hitVelocity);
 	// The projectile dies if it has no hits remaining.
 	if(--hitsRemaining == 0)
 	{
@@ -17,8 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "GameData.h"
 #include "shader/LineShader.h"
-#include "shader/PointerShader.h"
-#include "shader/RingShader.h"
+#include "shader/RadarShader.h"
 
 #include <cmath>
 
@@ -39,7 +38,7 @@ const int Radar::STAR = 9;
 
 void Radar::Clear()
 {
-	objects.clear();
+	rings.clear();
 	pointers.clear();
 	lines.clear();
 }
@@ -57,7 +56,7 @@ void Radar::SetCenter(const Point &center)
 // given position should be in world units (not shrunk to radar units).
 void Radar::Add(int type, Point position, double outer, double inner)
 {
-	objects.emplace_back(GetColor(type).Opaque(), position - center, outer, inner);
+	RadarShader::AddRing(rings, position - center, outer, inner, GetColor(type).Opaque());
 }
 
 
@@ -65,7 +64,7 @@ void Radar::Add(int type, Point position, double outer, double inner)
 // Add a pointer, pointing in the direction of the given vector.
 void Radar::AddPointer(int type, const Point &position)
 {
-	pointers.emplace_back(GetColor(type), position.Unit());
+	RadarShader::AddPointer(pointers, position.Unit(), GetColor(type));
 }
 
 
@@ -111,25 +110,12 @@ void Radar::Draw(const Point &center, double scale, double radius, double pointe
 		LineShader::Draw(start + center, start + v + center, 1.f, line.color);
 	}
 
-	// Draw StellarObjects and ships.
-	RingShader::Bind();
-	for(const Object &object : objects)
-	{
-		Point position = object.position * scale;
-		double length = position.Length();
-		if(length > radius)
-			position *= radius / length;
-		position += center;
-
-		RingShader::Add(position, object.outer, object.inner, object.color);
-	}
-	RingShader::Unbind();
+	// Draw StellarObjects and ships. Their positions are scaled and clamped to the
+	// radar's radius by the shader, so all of them can be drawn at once.
+	RadarShader::DrawRings(rings, center, scale, radius);
 
 	// Draw neighboring system indicators.
-	PointerShader::Bind();
-	for(const Pointer &pointer : pointers)
-		PointerShader::Add(center, pointer.unit, 10.f, 10.f, pointerRadius, pointer.color);
-	PointerShader::Unbind();
+	RadarShader::DrawPointers(pointers, center, 10.f, 10.f, pointerRadius);
 }
 
 
@@ -157,20 +143,6 @@ const Color &Radar::GetColor(int type)
 
 
 
-Radar::Object::Object(const Color &color, const Point &pos, double out, double in)
-	: color(color), position(pos), outer(out), inner(in)
-{
-}
-
-
-
-Radar::Pointer::Pointer(const Color &color, const Point &unit)
-	: color(color), unit(unit)
-{
-}
-
-
-
 // Create a line starting from "base" with length and angle described by "vector."
 Radar::Line::Line(const Color &color, const Point &base, const Point &vector)
 	: color(color), base(base), vector(vector)
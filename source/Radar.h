@@ -59,24 +59,6 @@ public:
 
 
 private:
-	class Object {
-	public:
-		Object(const Color &color, const Point &pos, double out, double in);
-
-		Color color;
-		Point position;
-		double outer;
-		double inner;
-	};
-
-	class Pointer {
-	public:
-		Pointer(const Color &color, const Point &unit);
-
-		Color color;
-		Point unit;
-	};
-
 	class Line {
 	public:
 		Line(const Color &color, const Point &base, const Point &vector);
@@ -88,7 +70,9 @@ private:
 
 private:
 	Point center;
-	std::vector<Object> objects;
-	std::vector<Pointer> pointers;
+	// The vertex data of the rings and pointers, in the format that RadarShader
+	// draws. These are cleared every step, but keep their capacity.
+	std::vector<float> rings;
+	std::vector<float> pointers;
 	std::vector<Line> lines;
 };
@@ -0,0 +1,157 @@
+/* ScratchArena.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ScratchArena.h"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+using namespace std;
+
+namespace {
+	// The size of the first block of memory that each thread's arena allocates.
+	constexpr size_t FIRST_BLOCK_SIZE = 1 << 16;
+
+	struct Block {
+		unique_ptr<char[]> data;
+		size_t size = 0;
+
+		bool Contains(const void *pointer) const
+		{
+			const char *p = static_cast<const char *>(pointer);
+			return p >= data.get() && p < data.get() + size;
+		}
+	};
+
+	struct Arena {
+		// Blocks are filled in order. Only the last one that memory was taken
+		// from has any free space; the ones after it are empty.
+		vector<Block> blocks;
+		size_t block = 0;
+		size_t offset = 0;
+		int depth = 0;
+		int64_t allocations = 0;
+
+		void *Allocate(size_t size, size_t alignment)
+		{
+			while(block < blocks.size())
+			{
+				Block &current = blocks[block];
+				size_t start = (offset + alignment - 1) & ~(alignment - 1);
+				if(start + size <= current.size)
+				{
+					offset = start + size;
+					return current.data.get() + start;
+				}
+				++block;
+				offset = 0;
+			}
+
+			// There is not enough room left, so add a new block that is big
+			// enough for this and at least as big as all the others put together.
+			size_t total = 0;
+			for(const Block &it : blocks)
+				total += it.size;
+			Block &added = blocks.emplace_back();
+			added.size = max(max(FIRST_BLOCK_SIZE, total), size + alignment);
+			added.data.reset(new char[added.size]);
+			++allocations;
+
+			block = blocks.size() - 1;
+			offset = 0;
+			return Allocate(size, alignment);
+		}
+
+		bool Deallocate(void *pointer, size_t size)
+		{
+			for(size_t i = 0; i < blocks.size(); ++i)
+				if(blocks[i].Contains(pointer))
+				{
+					// If this was the last thing allocated, its memory can be reused.
+					if(i == block && static_cast<char *>(pointer) + size == blocks[i].data.get() + offset)
+						offset -= size;
+					return true;
+				}
+			return false;
+		}
+
+		void Reset()
+		{
+			// If more than one block was needed, replace them with a single block
+			// that is big enough for everything, so that the next time through
+			// will not need to allocate anything.
+			if(blocks.size() > 1)
+			{
+				size_t total = 0;
+				for(const Block &it : blocks)
+					total += it.size;
+				blocks.clear();
+				Block &merged = blocks.emplace_back();
+				merged.size = total;
+				merged.data.reset(new char[total]);
+				++allocations;
+			}
+			block = 0;
+			offset = 0;
+		}
+	};
+
+	thread_local Arena arena;
+}
+
+
+
+ScratchArena::Scope::Scope()
+{
+	++arena.depth;
+}
+
+
+
+ScratchArena::Scope::~Scope()
+{
+	if(!--arena.depth)
+		arena.Reset();
+}
+
+
+
+void *ScratchArena::Allocate(size_t size, size_t alignment)
+{
+	if(!arena.depth)
+	{
+		++arena.allocations;
+		return ::operator new(size);
+	}
+	return arena.Allocate(size, alignment);
+}
+
+
+
+void ScratchArena::Deallocate(void *pointer, size_t size) noexcept
+{
+	if(!arena.Deallocate(pointer, size))
+		::operator delete(pointer);
+}
+
+
+
+// Get how many times containers on this thread have had to allocate memory
+// from the heap since the last time this was called.
+int64_t ScratchArena::TakeAllocationCount()
+{
+	return exchange(arena.allocations, 0);
+}
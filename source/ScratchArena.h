@@ -0,0 +1,95 @@
+/* ScratchArena.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+
+
+// Memory for short-lived containers, such as the lists of objects that are
+// built and thrown away while calculating one step of the game. Each thread has
+// its own arena. While a Scope is open on a thread, containers that use the
+// ScratchAllocator take their memory from that thread's arena, which is handed
+// out in order and all released at once when the outermost Scope closes. Once
+// the arena has grown to fit one step, later steps do not need to allocate any
+// memory at all. Outside of a Scope, the allocator simply uses the heap.
+//
+// A container that takes memory from the arena must not outlive the Scope it
+// was filled in.
+class ScratchArena {
+public:
+	// Open a scope. Everything that is allocated in the arena after this is
+	// released when the outermost scope closes.
+	class Scope {
+	public:
+		Scope();
+		~Scope();
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+	};
+
+
+public:
+	static void *Allocate(size_t size, size_t alignment);
+	static void Deallocate(void *pointer, size_t size) noexcept;
+
+	// Get how many times containers on this thread have had to allocate memory
+	// from the heap since the last time this was called.
+	static int64_t TakeAllocationCount();
+};
+
+
+
+// An allocator for standard containers that takes memory from the current
+// thread's scratch arena.
+template<class T>
+class ScratchAllocator {
+public:
+	using value_type = T;
+
+	ScratchAllocator() noexcept = default;
+	template<class U>
+	ScratchAllocator(const ScratchAllocator<U> &) noexcept {}
+
+	T *allocate(size_t count)
+	{
+		return static_cast<T *>(ScratchArena::Allocate(count * sizeof(T), alignof(T)));
+	}
+	void deallocate(T *pointer, size_t count) noexcept
+	{
+		ScratchArena::Deallocate(pointer, count * sizeof(T));
+	}
+
+	template<class U>
+	bool operator==(const ScratchAllocator<U> &) const noexcept { return true; }
+};
+
+
+
+template<class T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+template<class Key, class Value, class Compare = std::less<Key>>
+using ScratchMap = std::map<Key, Value, Compare, ScratchAllocator<std::pair<const Key, Value>>>;
+
+template<class Key, class Compare = std::less<Key>>
+using ScratchSet = std::set<Key, Compare, ScratchAllocator<Key>>;
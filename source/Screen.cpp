@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Screen.h"
 
 #include <algorithm>
+#include <atomic>
 
 using namespace std;
 
@@ -27,6 +28,8 @@ namespace {
 	int USER_ZOOM = 100;
 	int EFFECTIVE_ZOOM = 100;
 	bool HIGH_DPI = false;
+	// Images may start loading in other threads before the window is created.
+	atomic<bool> HIGH_DPI_KNOWN = false;
 }
 
 
@@ -108,6 +111,15 @@ void Screen::SetZoom(int percent)
 void Screen::SetHighDPI(bool isHighDPI)
 {
 	HIGH_DPI = isHighDPI;
+	HIGH_DPI_KNOWN = true;
+}
+
+
+
+// Check whether the window has been created and has set whether it is high DPI.
+bool Screen::IsHighDPIKnown()
+{
+	return HIGH_DPI_KNOWN;
 }
 
 
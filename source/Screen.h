@@ -53,6 +53,8 @@ public:
 
 	// Specify that this is a high-DPI window.
 	static void SetHighDPI(bool isHighDPI = true);
+	// Check whether the window has been created and has set whether it is high DPI.
+	static bool IsHighDPIKnown();
 	// This is true if the screen is high DPI, or if the zoom is above 100%.
 	static bool IsHighResolution();
 
@@ -744,6 +744,8 @@ void Ship::FinishLoading(bool isNewInstance)
 	}
 	// Add the attributes of all your outfits to the ship's base attributes.
 	attributes = baseAttributes;
+	outfitFlightChecksAreStale = true;
+	protectionIsStale = true;
 	vector<string> undefinedOutfits;
 	for(const auto &it : outfits)
 	{
@@ -1288,8 +1290,38 @@ double Ship::Deterrence() const
 // Check if this ship is configured in such a way that it would be difficult
 // or impossible to fly.
 vector<string> Ship::FlightCheck() const
+{
+	// Whether the ship overheats also depends on how much cargo it is carrying,
+	// so unlike the other checks, this cannot be cached.
+	if(IdleHeat() >= MaximumHeat())
+		return {"overheating!"};
+
+	if(outfitFlightChecksAreStale)
+	{
+		outfitFlightChecks = CalculateOutfitFlightChecks();
+		outfitFlightChecksAreStale = false;
+	}
+
+	// The fuel needed for a jump depends on this ship's mass and on whether it
+	// is being carried, so this warning cannot be cached either.
+	if(noFuelCheckIndex >= 0 && attributes.Get("fuel capacity") < navigation.JumpFuel())
+	{
+		vector<string> checks = outfitFlightChecks;
+		checks.insert(checks.begin() + noFuelCheckIndex, "no fuel?");
+		return checks;
+	}
+	return outfitFlightChecks;
+}
+
+
+
+// Check for the flight problems that are caused by this ship's outfits. These
+// are reported in the same order as by FlightCheck(). This also records where
+// the "no fuel?" warning belongs, if it can apply to this ship.
+vector<string> Ship::CalculateOutfitFlightChecks() const
 {
 	auto checks = vector<string>{};
+	noFuelCheckIndex = -1;
 
 	double generation = attributes.Get("energy generation") - attributes.Get("energy consumption");
 	double consuming = attributes.Get("fuel energy");
@@ -1309,9 +1341,7 @@ vector<string> Ship::FlightCheck() const
 	double jumpDrive = navigation.HasJumpDrive();
 
 	// Report the first error condition that will prevent takeoff:
-	if(IdleHeat() >= MaximumHeat())
-		checks.emplace_back("overheating!");
-	else if(energy <= 0.)
+	if(energy <= 0.)
 		checks.emplace_back("no energy!");
 	else if((energy - consuming <= 0.) && (fuel <= 0.))
 		checks.emplace_back("no fuel!");
@@ -1343,8 +1373,7 @@ vector<string> Ship::FlightCheck() const
 		{
 			if(!hyperDrive && !jumpDrive)
 				checks.emplace_back("no hyperdrive?");
-			if(fuelCapacity < navigation.JumpFuel())
-				checks.emplace_back("no fuel?");
+			noFuelCheckIndex = checks.size();
 		}
 		for(const auto &it : outfits)
 			if(it.first->IsWeapon() && it.first->FiringEnergy() > energy)
@@ -2121,6 +2150,20 @@ bool Ship::HasTractorBeam() const
 
 
 
+double Ship::AntiMissileRange() const
+{
+	return antiMissileRange;
+}
+
+
+
+double Ship::TractorBeamRange() const
+{
+	return tractorBeamRange;
+}
+
+
+
 // Fire an anti-missile.
 bool Ship::FireAntiMissile(const Projectile &projectile, vector<Visual> &visuals)
 {
@@ -3510,6 +3553,19 @@ const Outfit &Ship::Attributes() const
 
 
 
+// Get the attributes of this ship that protect it from damage.
+const DamageProtection &Ship::Protection() const
+{
+	if(protectionIsStale)
+	{
+		protection = DamageProtection(attributes);
+		protectionIsStale = false;
+	}
+	return protection;
+}
+
+
+
 const Outfit &Ship::BaseAttributes() const
 {
 	return baseAttributes;
@@ -3550,6 +3606,8 @@ void Ship::AddOutfit(const Outfit *outfit, int count)
 		}
 		int after = outfits.count(outfit);
 		attributes.Add(*outfit, count);
+		outfitFlightChecksAreStale = true;
+		protectionIsStale = true;
 		if(outfit->IsWeapon())
 		{
 			armament.Add(outfit, count);
@@ -4998,8 +5056,7 @@ void Ship::DoEngineVisuals(vector<Visual> &visuals, bool isUsingAfterburner)
 			// Stream the afterburner effects outward in the direction the engines are facing.
 			Point effectVelocity = velocity - 6. * afterburnerAngle.Unit();
 			for(auto &&it : Attributes().AfterburnerEffects())
-				for(int i = 0; i < it.second; ++i)
-					visuals.emplace_back(*it.first, pos, effectVelocity, afterburnerAngle, Point{}, point.zoom);
+				Visual::Spawn(visuals, it.second, *it.first, pos, effectVelocity, afterburnerAngle, Point{}, point.zoom);
 		}
 	}
 }
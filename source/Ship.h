@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Armament.h"
 #include "CargoHold.h"
 #include "Command.h"
+#include "DamageProtection.h"
 #include "EsUuid.h"
 #include "FireCommand.h"
 #include "Outfit.h"
@@ -261,6 +262,9 @@ public:
 	// Return true if any anti-missile or tractor beam systems are ready to fire.
 	bool HasAntiMissile() const;
 	bool HasTractorBeam() const;
+	// Get how far away the ready anti-missile or tractor beam systems can reach.
+	double AntiMissileRange() const;
+	double TractorBeamRange() const;
 	// Fire an anti-missile at the given missile. Returns true if the missile was killed.
 	bool FireAntiMissile(const Projectile &projectile, std::vector<Visual> &visuals);
 	// Fire tractor beams at the given flotsam. Returns a Point representing the net
@@ -470,6 +474,8 @@ public:
 
 	// Get the current attributes of this ship.
 	const Outfit &Attributes() const;
+	// Get the attributes of this ship that protect it from damage.
+	const DamageProtection &Protection() const;
 	// Get the attributes of this ship chassis before any outfits were added.
 	const Outfit &BaseAttributes() const;
 	// Get the list of all outfits installed in this ship.
@@ -578,6 +584,8 @@ private:
 	// This is only useful for the player's ships.
 	double CalculateAttraction() const;
 	double CalculateDeterrence() const;
+	// Check for the flight problems that are caused by this ship's outfits.
+	std::vector<std::string> CalculateOutfitFlightChecks() const;
 
 	// Increment the duration a thruster direction has been held.
 	void IncrementThrusterHeld(ThrustKind kind);
@@ -644,6 +652,15 @@ private:
 
 	double attraction = 0.;
 	double deterrence = 0.;
+	// The flight checks that only depend on this ship's outfits, which are
+	// recalculated the next time they are needed after the outfits change.
+	mutable std::vector<std::string> outfitFlightChecks;
+	mutable bool outfitFlightChecksAreStale = true;
+	// Where the "no fuel?" warning goes in those checks, or -1 if it cannot apply.
+	mutable int noFuelCheckIndex = -1;
+	// The protection attributes are also only looked up when they are needed.
+	mutable DamageProtection protection;
+	mutable bool protectionIsStale = true;
 
 	// Number of AI steps this ship has spent lingering
 	int lingerSteps = 0;
@@ -66,6 +66,8 @@ ShipInfoPanel::ShipInfoPanel(PlayerInfo &player, InfoPanelState state)
 	shipIt = this->panelState.Ships().begin();
 	Audio::Pause();
 	SetInterruptible(false);
+	// Nothing on this panel changes unless the player interacts with it.
+	SetRetained(true);
 
 	// If a valid ship index was given, show that ship.
 	if(static_cast<unsigned>(panelState.SelectedIndex()) < player.Ships().size())
@@ -142,6 +144,8 @@ void ShipInfoPanel::Draw()
 
 	// If the player hovers their mouse over a ship attribute, show its tooltip.
 	info.DrawTooltips();
+	if(info.IsTooltipChanging())
+		Invalidate();
 }
 
 
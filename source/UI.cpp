@@ -273,6 +273,12 @@ Point UI::GetMouse()
 // If a push or pop is queued, apply it.
 void UI::PushOrPop()
 {
+	// Any panel may draw itself differently depending on what is above it, so
+	// retained panels must be redrawn whenever the stack changes.
+	if(!toPush.empty() || !toPop.empty())
+		for(const shared_ptr<Panel> &panel : stack)
+			panel->Invalidate();
+
 	// Handle any panels that should be added.
 	for(shared_ptr<Panel> &panel : toPush)
 		if(panel)
@@ -25,6 +25,25 @@ using namespace std;
 
 // Generate a visual based on the given Effect.
 Visual::Visual(const Effect &effect, Point pos, Point vel, Angle facing, Point hitVelocity, double inheritedZoom)
+	: Visual(effect, pos, vel, facing, hitVelocity, inheritedZoom, 1)
+{
+}
+
+
+
+// Create the given number of visuals of the same effect, all starting from the
+// same position.
+void Visual::Spawn(vector<Visual> &visuals, int count, const Effect &effect, Point pos, Point vel,
+	Angle facing, Point hitVelocity, double inheritedZoom)
+{
+	for(int i = 0; i < count; ++i)
+		visuals.push_back(Visual(effect, pos, vel, facing, hitVelocity, inheritedZoom, i ? 0 : count));
+}
+
+
+
+Visual::Visual(const Effect &effect, Point pos, Point vel, Angle facing, Point hitVelocity, double inheritedZoom,
+		int soundCount)
 	: Body(effect, pos, vel, effect.hasAbsoluteAngle ? effect.absoluteAngle : facing),
 	lifetime(effect.lifetime)
 {
@@ -45,8 +64,8 @@ Visual::Visual(const Effect &effect, Point pos, Point vel, Angle facing, Point h
 	if(effect.randomVelocity)
 		velocity += angle.Unit() * Random::Real() * effect.randomVelocity;
 
-	if(effect.sound)
-		Audio::Play(effect.sound, position, effect.soundCategory);
+	if(effect.sound && soundCount)
+		Audio::Play(effect.sound, position, effect.soundCategory, soundCount);
 
 	if(effect.randomFrameRate)
 		AddFrameRate(effect.randomFrameRate * Random::Real());
@@ -20,6 +20,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Angle.h"
 #include "Point.h"
 
+#include <vector>
+
 class Effect;
 
 
@@ -32,6 +34,11 @@ public:
 	Visual(const Effect &effect, Point pos, Point vel, Angle facing, Point hitVelocity = Point(),
 		double inheritedZoom = 1.);
 
+	// Create the given number of visuals of the same effect, all starting from
+	// the same position. The effect's sound is only queued once for all of them.
+	static void Spawn(std::vector<Visual> &visuals, int count, const Effect &effect, Point pos, Point vel,
+		Angle facing, Point hitVelocity = Point(), double inheritedZoom = 1.);
+
 	// Functions provided by the Body base class:
 	// Frame GetFrame(int step = -1) const;
 	// const Point &Position() const;
@@ -44,6 +51,12 @@ public:
 	void Move();
 
 
+private:
+	// Generate a visual, playing the effect's sound as if this many visuals were created.
+	Visual(const Effect &effect, Point pos, Point vel, Angle facing, Point hitVelocity, double inheritedZoom,
+		int soundCount);
+
+
 private:
 	Angle spin;
 	int lifetime = 0;
@@ -35,6 +35,7 @@ void Weapon::LoadWeapon(const DataNode &node)
 	bool isClustered = false;
 	calculatedDamage = false;
 	doesDamage = false;
+	doesStatusDamage = false;
 	bool safeRangeOverriden = false;
 	bool disabledDamageSet = false;
 	bool minableDamageSet = false;
@@ -579,19 +580,17 @@ void Weapon::SetTurretTurn(double rate)
 
 
 
-double Weapon::TotalDamage(int index) const
+void Weapon::CalculateDamage() const
 {
-	if(!calculatedDamage)
+	calculatedDamage = true;
+	for(int i = 0; i < DAMAGE_TYPES; ++i)
 	{
-		calculatedDamage = true;
-		for(int i = 0; i < DAMAGE_TYPES; ++i)
-		{
-			for(const auto &it : submunitions)
-				damage[i] += it.weapon->TotalDamage(i) * it.count;
-			doesDamage |= (damage[i] > 0.);
-		}
+		for(const auto &it : submunitions)
+			damage[i] += it.weapon->TotalDamage(i) * it.count;
+		doesDamage |= (damage[i] > 0.);
+		if(i >= ION_DAMAGE && i <= BURN_DAMAGE)
+			doesStatusDamage |= (damage[i] != 0.);
 	}
-	return damage[index];
 }
 
 
@@ -196,6 +196,9 @@ public:
 	// Check if this weapon does damage. If not, attacking a ship with this
 	// weapon is not a provocation (even if you push or pull it).
 	bool DoesDamage() const;
+	// Check if this weapon does any of the status effect damage types, so
+	// that calculating the damage of a hit can skip them if it does not.
+	bool DoesStatusDamage() const;
 
 	bool ConsumesHull() const;
 	bool ConsumesFuel() const;
@@ -235,6 +238,8 @@ protected:
 
 private:
 	double TotalDamage(int index) const;
+	// Add the damage of all submunitions to this weapon's damage.
+	void CalculateDamage() const;
 
 
 private:
@@ -376,6 +381,7 @@ private:
 	// Cache the calculation of these values, for faster access.
 	mutable bool calculatedDamage = true;
 	mutable bool doesDamage = false;
+	mutable bool doesStatusDamage = false;
 	mutable double totalLifetime = -1.;
 };
 
@@ -477,7 +483,8 @@ inline double Weapon::RelativeFuelDamage() const { return TotalDamage(RELATIVE_F
 inline double Weapon::RelativeHeatDamage() const { return TotalDamage(RELATIVE_HEAT_DAMAGE); }
 inline double Weapon::RelativeEnergyDamage() const { return TotalDamage(RELATIVE_ENERGY_DAMAGE); }
 
-inline bool Weapon::DoesDamage() const { if(!calculatedDamage) TotalDamage(0); return doesDamage; }
+inline bool Weapon::DoesDamage() const { if(!calculatedDamage) CalculateDamage(); return doesDamage; }
+inline bool Weapon::DoesStatusDamage() const { if(!calculatedDamage) CalculateDamage(); return doesStatusDamage; }
 
 inline bool Weapon::ConsumesHull() const { return FiringHull() > 0. || RelativeFiringHull() > 0.; }
 inline bool Weapon::ConsumesFuel() const { return FiringFuel() > 0. || RelativeFiringFuel() > 0.; }
@@ -488,3 +495,10 @@ inline bool Weapon::ConsumesDisruption() const { return FiringDisruption() < 0.;
 inline bool Weapon::ConsumesSlowing() const { return FiringSlowing() < 0.; }
 
 inline bool Weapon::HasDamageDropoff() const { return hasDamageDropoff; }
+
+inline double Weapon::TotalDamage(int index) const
+{
+	if(!calculatedDamage)
+		CalculateDamage();
+	return damage[index];
+}
@@ -42,7 +42,7 @@ namespace {
 	// when those sounds actually start playing.
 	class QueueEntry {
 	public:
-		void Add(Point position, SoundCategory category);
+		void Add(Point position, SoundCategory category, int count = 1);
 		void Add(const QueueEntry &other);
 
 		Point sum;
@@ -286,7 +286,7 @@ void Audio::Play(const Sound *sound, SoundCategory category)
 
 // Play the given sound, as if it is at the given distance from the
 // "listener". This will make it softer and change the left / right balance.
-void Audio::Play(const Sound *sound, const Point &position, SoundCategory category)
+void Audio::Play(const Sound *sound, const Point &position, SoundCategory category, int count)
 {
 	if(!isInitialized || !sound || !sound->Buffer() || !volume[SoundCategory::MASTER])
 		return;
@@ -294,11 +294,11 @@ void Audio::Play(const Sound *sound, const Point &position, SoundCategory catego
 	// Place sounds from the main thread directly into the queue. They are from
 	// the UI, and the Engine may not be running right now to call Update().
 	if(this_thread::get_id() == mainThreadID)
-		soundQueue[sound].Add(position - listener, category);
+		soundQueue[sound].Add(position - listener, category, count);
 	else
 	{
 		unique_lock<mutex> lock(audioMutex);
-		deferred[sound].Add(position - listener, category);
+		deferred[sound].Add(position - listener, category, count);
 	}
 }
 
@@ -605,13 +605,13 @@ namespace {
 	// Add a new source to this queue entry. Sources are weighted based on their
 	// position, and multiple sources can be added together in the same entry.
 	// The preserved category is the category of the last source.
-	void QueueEntry::Add(Point position, SoundCategory category)
+	void QueueEntry::Add(Point position, SoundCategory category, int count)
 	{
 		// A distance of 500 counts as 1 OpenAL unit of distance.
 		position *= .002;
 		// To avoid having sources at a distance of 0 be infinitely loud, have
 		// the minimum distance be 1 unit away.
-		double d = 1. / (1. + position.Dot(position));
+		double d = count / (1. + position.Dot(position));
 		sum += d * position;
 		weight += d;
 		this->category = category;
@@ -62,7 +62,9 @@ public:
 
 	// Play the given sound, as if it is at the given distance from the
 	// "listener". This will make it softer and change the left / right balance.
-	static void Play(const Sound *sound, const Point &position, SoundCategory category);
+	// If the count is more than one, it is the same as playing the sound that
+	// many times at the same position.
+	static void Play(const Sound *sound, const Point &position, SoundCategory category, int count = 1);
 
 	// Play the given music. An empty string means to play nothing.
 	static void PlayMusic(const std::string &name);
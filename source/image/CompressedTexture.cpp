@@ -0,0 +1,556 @@
+/* CompressedTexture.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "CompressedTexture.h"
+
+#include "../Files.h"
+#include "ImageBuffer.h"
+#include "../PackedArchive.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace std;
+
+namespace {
+	// A cache file begins with a header that identifies it and the image files
+	// that it was made from:
+	//   char magic[8], uint32 version, uint32 width, uint32 height, uint32 frames, uint64 key
+	// That is followed by the compressed blocks of each frame. All values are
+	// stored in little-endian order. The version must be changed whenever the
+	// encoder changes, so that old cache files are not used.
+	const char MAGIC[8] = {'E', 'S', 'B', 'C', '7', '\0', '\0', '\0'};
+	const uint32_t VERSION = 1;
+	const size_t HEADER_SIZE = 32;
+
+	// The interpolation weights of BC7's 4-bit indices, out of 64.
+	const int WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+	atomic<bool> enabled = false;
+
+	void Put(string &out, uint64_t value, int bytes)
+	{
+		for(int i = 0; i < bytes; ++i)
+			out += static_cast<char>((value >> (8 * i)) & 0xFF);
+	}
+
+	uint64_t Get(const char *in, int bytes)
+	{
+		uint64_t value = 0;
+		for(int i = 0; i < bytes; ++i)
+			value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+		return value;
+	}
+
+	void PutBits(uint8_t *block, int &position, uint32_t value, int bits)
+	{
+		for(int i = 0; i < bits; ++i, ++position)
+			if((value >> i) & 1)
+				block[position / 8] |= 1 << (position % 8);
+	}
+
+	uint32_t GetBits(const uint8_t *block, int &position, int bits)
+	{
+		uint32_t value = 0;
+		for(int i = 0; i < bits; ++i, ++position)
+			value |= ((block[position / 8] >> (position % 8)) & 1) << i;
+		return value;
+	}
+
+	// The two endpoints of a block, each as 7-bit color and alpha values that
+	// share one extra low bit.
+	class Endpoints {
+	public:
+		int color[2][4];
+		int pBit[2];
+
+		int Value(int endpoint, int channel) const { return (color[endpoint][channel] << 1) | pBit[endpoint]; }
+	};
+
+	// Find the closest endpoint that can be represented to the given one.
+	void Quantize(const float value[4], Endpoints &endpoints, int endpoint)
+	{
+		float bestError = numeric_limits<float>::max();
+		for(int p = 0; p < 2; ++p)
+		{
+			int color[4];
+			float error = 0.f;
+			for(int channel = 0; channel < 4; ++channel)
+			{
+				color[channel] = clamp(static_cast<int>(lround((value[channel] - p) * .5f)), 0, 127);
+				float difference = (color[channel] * 2 + p) - value[channel];
+				error += difference * difference;
+			}
+			if(error < bestError)
+			{
+				bestError = error;
+				copy(color, color + 4, endpoints.color[endpoint]);
+				endpoints.pBit[endpoint] = p;
+			}
+		}
+	}
+
+	// Choose the best index for each pixel with the given endpoints, and return
+	// the total squared error.
+	int64_t ChooseIndices(const uint8_t pixels[16][4], const Endpoints &endpoints, int indices[16])
+	{
+		int palette[16][4];
+		for(int i = 0; i < 16; ++i)
+			for(int channel = 0; channel < 4; ++channel)
+				palette[i][channel] = ((64 - WEIGHTS[i]) * endpoints.Value(0, channel)
+					+ WEIGHTS[i] * endpoints.Value(1, channel) + 32) >> 6;
+
+		int64_t total = 0;
+		for(int i = 0; i < 16; ++i)
+		{
+			int bestError = numeric_limits<int>::max();
+			for(int j = 0; j < 16; ++j)
+			{
+				int error = 0;
+				for(int channel = 0; channel < 4; ++channel)
+				{
+					int difference = palette[j][channel] - pixels[i][channel];
+					error += difference * difference;
+				}
+				if(error < bestError)
+				{
+					bestError = error;
+					indices[i] = j;
+				}
+			}
+			total += bestError;
+		}
+		return total;
+	}
+
+	// Compress one block of pixels using BC7 mode 6: a single pair of RGBA
+	// endpoints, with 16 colors interpolated between them. This is not the best
+	// mode for every block, but it handles alpha well and is fast to search.
+	void EncodeBlock(const uint8_t pixels[16][4], uint8_t *block)
+	{
+		// Find the line through the colors that best fits them, using the
+		// principal axis of their covariance.
+		float mean[4] = {};
+		for(int i = 0; i < 16; ++i)
+			for(int channel = 0; channel < 4; ++channel)
+				mean[channel] += pixels[i][channel] / 16.f;
+		float covariance[4][4] = {};
+		for(int i = 0; i < 16; ++i)
+			for(int a = 0; a < 4; ++a)
+				for(int b = 0; b < 4; ++b)
+					covariance[a][b] += (pixels[i][a] - mean[a]) * (pixels[i][b] - mean[b]);
+		float axis[4] = {1.f, 1.f, 1.f, 1.f};
+		for(int iteration = 0; iteration < 8; ++iteration)
+		{
+			float next[4] = {};
+			for(int a = 0; a < 4; ++a)
+				for(int b = 0; b < 4; ++b)
+					next[a] += covariance[a][b] * axis[b];
+			float length = sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+			if(length < 1e-6f)
+				break;
+			for(int a = 0; a < 4; ++a)
+				axis[a] = next[a] / length;
+		}
+
+		// The endpoints are where the colors' projections onto that line begin and end.
+		float low = numeric_limits<float>::max();
+		float high = numeric_limits<float>::lowest();
+		for(int i = 0; i < 16; ++i)
+		{
+			float t = 0.f;
+			for(int channel = 0; channel < 4; ++channel)
+				t += (pixels[i][channel] - mean[channel]) * axis[channel];
+			low = min(low, t);
+			high = max(high, t);
+		}
+		Endpoints best;
+		float value[2][4];
+		for(int channel = 0; channel < 4; ++channel)
+		{
+			value[0][channel] = clamp(mean[channel] + low * axis[channel], 0.f, 255.f);
+			value[1][channel] = clamp(mean[channel] + high * axis[channel], 0.f, 255.f);
+		}
+		Quantize(value[0], best, 0);
+		Quantize(value[1], best, 1);
+		int bestIndices[16];
+		int64_t bestError = ChooseIndices(pixels, best, bestIndices);
+
+		// Refine the endpoints by finding the ones that best fit the chosen
+		// indices, then choosing the indices again.
+		for(int iteration = 0; iteration < 2 && bestError; ++iteration)
+		{
+			float a = 0.f;
+			float b = 0.f;
+			float c = 0.f;
+			float r0[4] = {};
+			float r1[4] = {};
+			for(int i = 0; i < 16; ++i)
+			{
+				float w = WEIGHTS[bestIndices[i]] / 64.f;
+				a += (1.f - w) * (1.f - w);
+				b += (1.f - w) * w;
+				c += w * w;
+				for(int channel = 0; channel < 4; ++channel)
+				{
+					r0[channel] += (1.f - w) * pixels[i][channel];
+					r1[channel] += w * pixels[i][channel];
+				}
+			}
+			float determinant = a * c - b * b;
+			if(fabs(determinant) < 1e-6f)
+				break;
+			for(int channel = 0; channel < 4; ++channel)
+			{
+				value[0][channel] = clamp((c * r0[channel] - b * r1[channel]) / determinant, 0.f, 255.f);
+				value[1][channel] = clamp((a * r1[channel] - b * r0[channel]) / determinant, 0.f, 255.f);
+			}
+			Endpoints refined;
+			Quantize(value[0], refined, 0);
+			Quantize(value[1], refined, 1);
+			int indices[16];
+			int64_t error = ChooseIndices(pixels, refined, indices);
+			if(error >= bestError)
+				break;
+			best = refined;
+			bestError = error;
+			copy(indices, indices + 16, bestIndices);
+		}
+
+		// The high bit of the first index is not stored, so it must be zero.
+		// If it is not, swap the endpoints and reverse the indices.
+		if(bestIndices[0] & 8)
+		{
+			for(int channel = 0; channel < 4; ++channel)
+				swap(best.color[0][channel], best.color[1][channel]);
+			swap(best.pBit[0], best.pBit[1]);
+			for(int &index : bestIndices)
+				index = 15 - index;
+		}
+
+		fill(block, block + CompressedTexture::BLOCK_BYTES, 0);
+		int position = 0;
+		PutBits(block, position, 1 << 6, 7);
+		for(int channel = 0; channel < 4; ++channel)
+		{
+			PutBits(block, position, best.color[0][channel], 7);
+			PutBits(block, position, best.color[1][channel], 7);
+		}
+		PutBits(block, position, best.pBit[0], 1);
+		PutBits(block, position, best.pBit[1], 1);
+		PutBits(block, position, bestIndices[0], 3);
+		for(int i = 1; i < 16; ++i)
+			PutBits(block, position, bestIndices[i], 4);
+	}
+
+	// Decompress one block. Only mode 6, which the encoder uses, is supported;
+	// blocks in any other mode are decoded as transparent.
+	void DecodeBlock(const uint8_t *block, uint8_t pixels[16][4])
+	{
+		if((block[0] & 0x7F) != (1 << 6))
+		{
+			fill(&pixels[0][0], &pixels[0][0] + 64, 0);
+			return;
+		}
+		int position = 7;
+		Endpoints endpoints;
+		for(int channel = 0; channel < 4; ++channel)
+		{
+			endpoints.color[0][channel] = GetBits(block, position, 7);
+			endpoints.color[1][channel] = GetBits(block, position, 7);
+		}
+		endpoints.pBit[0] = GetBits(block, position, 1);
+		endpoints.pBit[1] = GetBits(block, position, 1);
+		for(int i = 0; i < 16; ++i)
+		{
+			int weight = WEIGHTS[GetBits(block, position, i ? 4 : 3)];
+			for(int channel = 0; channel < 4; ++channel)
+				pixels[i][channel] = ((64 - weight) * endpoints.Value(0, channel)
+					+ weight * endpoints.Value(1, channel) + 32) >> 6;
+		}
+	}
+
+	size_t Blocks(int size)
+	{
+		return (size + 3) / 4;
+	}
+}
+
+
+
+// Set whether images should be compressed as they are loaded. This should
+// only be enabled if the graphics card supports BC7 textures.
+void CompressedTexture::SetEnabled(bool enable)
+{
+	enabled = enable;
+}
+
+
+
+bool CompressedTexture::IsEnabled()
+{
+	return enabled;
+}
+
+
+
+// Get the path of the cache file for the sprite with the given name.
+filesystem::path CompressedTexture::CachePath(const string &name)
+{
+	// Sprite names may contain characters that are not valid in file names,
+	// so the cache files are named by a hash of the sprite name instead.
+	uint64_t hash = 14695981039346656037ull;
+	for(char c : name)
+		hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+	static const char HEX[] = "0123456789abcdef";
+	string fileName;
+	for(int i = 60; i >= 0; i -= 4)
+		fileName += HEX[(hash >> i) & 0xF];
+	return Files::Config() / "textures" / (fileName + ".bc7");
+}
+
+
+
+// Get a key that identifies the current versions of the given image files.
+uint64_t CompressedTexture::SourceKey(const vector<filesystem::path> &paths)
+{
+	uint64_t hash = 14695981039346656037ull;
+	auto Add = [&hash](uint64_t value) {
+		for(int i = 0; i < 8; ++i)
+			hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 1099511628211ull;
+	};
+	for(const filesystem::path &path : paths)
+	{
+		for(char c : path.generic_string())
+			hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+		error_code error;
+		if(filesystem::exists(path, error))
+		{
+			Add(filesystem::file_size(path, error));
+			Add(filesystem::last_write_time(path, error).time_since_epoch().count());
+			continue;
+		}
+		// A file in a packed archive has no size or time of its own, so use
+		// those of the archive that it is in, which is rewritten whenever any
+		// of the files in it change.
+		for(filesystem::path directory = path.parent_path(); !directory.empty();
+				directory = directory.parent_path())
+		{
+			filesystem::path archive = directory / PackedArchive::FILE_NAME;
+			if(filesystem::exists(archive, error))
+			{
+				Add(filesystem::file_size(archive, error));
+				Add(filesystem::last_write_time(archive, error).time_since_epoch().count());
+				break;
+			}
+			if(directory == directory.parent_path())
+				break;
+		}
+	}
+	return hash;
+}
+
+
+
+// Get the peak signal-to-noise ratio, in decibels, between two images of the
+// same size. Higher is better; identical images give infinity.
+double CompressedTexture::PSNR(const ImageBuffer &original, const ImageBuffer &decoded)
+{
+	if(original.Width() != decoded.Width() || original.Height() != decoded.Height()
+			|| original.Frames() != decoded.Frames() || !original.Pixels() || !decoded.Pixels())
+		return 0.;
+
+	size_t count = static_cast<size_t>(original.Width()) * original.Height() * original.Frames() * 4;
+	const uint8_t *a = reinterpret_cast<const uint8_t *>(original.Pixels());
+	const uint8_t *b = reinterpret_cast<const uint8_t *>(decoded.Pixels());
+	double total = 0.;
+	for(size_t i = 0; i < count; ++i)
+	{
+		double difference = static_cast<double>(a[i]) - b[i];
+		total += difference * difference;
+	}
+	if(!total)
+		return numeric_limits<double>::infinity();
+	return 10. * log10(255. * 255. * count / total);
+}
+
+
+
+// Compress all the frames of the given image.
+void CompressedTexture::Encode(const ImageBuffer &buffer)
+{
+	width = buffer.Width();
+	height = buffer.Height();
+	frames = buffer.Pixels() ? buffer.Frames() : 0;
+	data.assign(FrameSize() * frames, 0);
+
+	uint8_t *out = data.data();
+	uint8_t pixels[16][4];
+	for(int frame = 0; frame < frames; ++frame)
+		for(int y = 0; y < height; y += 4)
+			for(int x = 0; x < width; x += 4, out += BLOCK_BYTES)
+			{
+				// Blocks that extend past the edge of the image repeat its last row or column.
+				for(int i = 0; i < 16; ++i)
+				{
+					const uint32_t *row = buffer.Begin(min(y + i / 4, height - 1), frame);
+					memcpy(pixels[i], row + min(x + i % 4, width - 1), 4);
+				}
+				EncodeBlock(pixels, out);
+			}
+}
+
+
+
+// Decompress the frames into the given image, which is allocated to the
+// right size. This is only needed to check the quality of the compression.
+void CompressedTexture::Decode(ImageBuffer &buffer) const
+{
+	buffer.Clear(frames);
+	if(IsEmpty())
+		return;
+	buffer.Allocate(width, height);
+
+	const uint8_t *in = data.data();
+	uint8_t pixels[16][4];
+	for(int frame = 0; frame < frames; ++frame)
+		for(int y = 0; y < height; y += 4)
+			for(int x = 0; x < width; x += 4, in += BLOCK_BYTES)
+			{
+				DecodeBlock(in, pixels);
+				for(int i = 0; i < 16; ++i)
+					if(y + i / 4 < height && x + i % 4 < width)
+						memcpy(buffer.Begin(y + i / 4, frame) + x + i % 4, pixels[i], 4);
+			}
+}
+
+
+
+// Read a compressed image from the given cache file. Returns false if the
+// file does not exist, is not valid, or was made from other image files.
+bool CompressedTexture::Read(const filesystem::path &path, uint64_t key)
+{
+	Clear();
+	shared_ptr<const string_view> file = Files::Map(path);
+	if(!file || file->size() < HEADER_SIZE)
+		return false;
+
+	const char *in = file->data();
+	if(memcmp(in, MAGIC, sizeof(MAGIC)) || Get(in + 8, 4) != VERSION || Get(in + 24, 8) != key)
+		return false;
+	int newWidth = Get(in + 12, 4);
+	int newHeight = Get(in + 16, 4);
+	int newFrames = Get(in + 20, 4);
+	if(newWidth <= 0 || newHeight <= 0 || newFrames <= 0
+			|| file->size() - HEADER_SIZE != Blocks(newWidth) * Blocks(newHeight) * BLOCK_BYTES * newFrames)
+		return false;
+
+	width = newWidth;
+	height = newHeight;
+	frames = newFrames;
+	data.assign(in + HEADER_SIZE, in + file->size());
+	return true;
+}
+
+
+
+// Write this compressed image to the given cache file.
+bool CompressedTexture::Write(const filesystem::path &path, uint64_t key) const
+{
+	if(IsEmpty())
+		return false;
+
+	error_code error;
+	filesystem::create_directories(path.parent_path(), error);
+	ofstream out(path, ios::out | ios::binary | ios::trunc);
+	if(!out)
+		return false;
+
+	string header(MAGIC, sizeof(MAGIC));
+	Put(header, VERSION, 4);
+	Put(header, width, 4);
+	Put(header, height, 4);
+	Put(header, frames, 4);
+	Put(header, key, 8);
+	out << header;
+	out.write(reinterpret_cast<const char *>(data.data()), data.size());
+	return static_cast<bool>(out);
+}
+
+
+
+void CompressedTexture::Clear()
+{
+	width = 0;
+	height = 0;
+	frames = 0;
+	data.clear();
+	data.shrink_to_fit();
+}
+
+
+
+bool CompressedTexture::IsEmpty() const
+{
+	return data.empty();
+}
+
+
+
+int CompressedTexture::Width() const
+{
+	return width;
+}
+
+
+
+int CompressedTexture::Height() const
+{
+	return height;
+}
+
+
+
+int CompressedTexture::Frames() const
+{
+	return frames;
+}
+
+
+
+// The compressed blocks of all the frames, one after another.
+const uint8_t *CompressedTexture::Data() const
+{
+	return data.data();
+}
+
+
+
+size_t CompressedTexture::Size() const
+{
+	return data.size();
+}
+
+
+
+// The size of the compressed blocks of each frame.
+size_t CompressedTexture::FrameSize() const
+{
+	return Blocks(width) * Blocks(height) * BLOCK_BYTES;
+}
@@ -0,0 +1,86 @@
+/* CompressedTexture.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class ImageBuffer;
+
+
+
+// The frames of an image, compressed into the BC7 block format that graphics
+// cards can sample from directly. Each 4x4 block of pixels takes 16 bytes, a
+// quarter of the memory of the uncompressed image. Compressing an image takes
+// much longer than decoding it, so compressed images are cached on disk, and
+// are only recompressed if the image files they came from change.
+class CompressedTexture {
+public:
+	// The number of bytes that each 4x4 block of pixels is compressed to.
+	static constexpr size_t BLOCK_BYTES = 16;
+
+
+public:
+	// Set whether images should be compressed as they are loaded. This should
+	// only be enabled if the graphics card supports BC7 textures.
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled();
+
+	// Get the path of the cache file for the sprite with the given name.
+	static std::filesystem::path CachePath(const std::string &name);
+	// Get a key that identifies the current versions of the given image files.
+	static uint64_t SourceKey(const std::vector<std::filesystem::path> &paths);
+	// Get the peak signal-to-noise ratio, in decibels, between two images of the
+	// same size. Higher is better; identical images give infinity.
+	static double PSNR(const ImageBuffer &original, const ImageBuffer &decoded);
+
+
+public:
+	// Compress all the frames of the given image.
+	void Encode(const ImageBuffer &buffer);
+	// Decompress the frames into the given image, which is allocated to the
+	// right size. This is only needed to check the quality of the compression.
+	void Decode(ImageBuffer &buffer) const;
+
+	// Read a compressed image from the given cache file. Returns false if the
+	// file does not exist, is not valid, or was made from other image files.
+	bool Read(const std::filesystem::path &path, uint64_t key);
+	// Write this compressed image to the given cache file.
+	bool Write(const std::filesystem::path &path, uint64_t key) const;
+
+	void Clear();
+	bool IsEmpty() const;
+
+	int Width() const;
+	int Height() const;
+	int Frames() const;
+
+	// The compressed blocks of all the frames, one after another.
+	const uint8_t *Data() const;
+	size_t Size() const;
+	// The size of the compressed blocks of each frame.
+	size_t FrameSize() const;
+
+
+private:
+	int width = 0;
+	int height = 0;
+	int frames = 0;
+	std::vector<uint8_t> data;
+};
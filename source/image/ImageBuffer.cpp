@@ -18,14 +18,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Files.h"
 #include "ImageFileData.h"
 #include "../Logger.h"
+#include "PixelKernels.h"
 
 #include <jpeglib.h>
 #include <png.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <set>
 #include <stdexcept>
-#include <vector>
+#include <string_view>
 
 using namespace std;
 
@@ -39,8 +41,8 @@ namespace {
 		return extensions;
 	}();
 
-	bool ReadPNG(const filesystem::path &path, ImageBuffer &buffer, int frame);
-	bool ReadJPG(const filesystem::path &path, ImageBuffer &buffer, int frame);
+	bool ReadPNG(const filesystem::path &path, ImageBuffer &buffer, int frame, bool premultiply, BlendingMode blend);
+	bool ReadJPG(const filesystem::path &path, ImageBuffer &buffer, int frame, bool premultiply, BlendingMode blend);
 	void Premultiply(ImageBuffer &buffer, int frame, BlendingMode additive);
 }
 
@@ -147,20 +149,11 @@ void ImageBuffer::ShrinkToHalfSize()
 	ImageBuffer result(frames);
 	result.Allocate(width / 2, height / 2);
 
-	unsigned char *begin = reinterpret_cast<unsigned char *>(pixels);
-	unsigned char *out = reinterpret_cast<unsigned char *>(result.pixels);
 	// Loop through every line of every frame of the buffer.
 	for(int y = 0; y < result.height * frames; ++y)
 	{
-		unsigned char *aIt = begin + (4 * width) * (2 * y);
-		unsigned char *aEnd = aIt + 4 * 2 * result.width;
-		unsigned char *bIt = begin + (4 * width) * (2 * y + 1);
-		for( ; aIt != aEnd; aIt += 4, bIt += 4)
-		{
-			for(int channel = 0; channel < 4; ++channel, ++aIt, ++bIt, ++out)
-				*out = (static_cast<unsigned>(aIt[0]) + static_cast<unsigned>(bIt[0])
-					+ static_cast<unsigned>(aIt[4]) + static_cast<unsigned>(bIt[4]) + 2) / 4;
-		}
+		const uint32_t *top = pixels + width * (2 * y);
+		PixelKernels::ShrinkRows(top, top + width, result.pixels + result.width * y, result.width);
 	}
 	swap(width, result.width);
 	swap(height, result.height);
@@ -178,33 +171,42 @@ bool ImageBuffer::Read(const ImageFileData &data, int frame)
 	if(!isPNG && !isJPG)
 		return false;
 
-	if(isPNG && !ReadPNG(data.path, *this, frame))
-		return false;
-	if(isJPG && !ReadJPG(data.path, *this, frame))
-		return false;
-
-	if(data.blendingMode != BlendingMode::PREMULTIPLIED_ALPHA)
-	{
-		if(isPNG || (isJPG && data.blendingMode == BlendingMode::ADDITIVE))
-			Premultiply(*this, frame, data.blendingMode);
-	}
-	return true;
+	// The conversion to premultiplied alpha is done as each row is decoded,
+	// while that row is still in the cache.
+	bool premultiply = data.blendingMode != BlendingMode::PREMULTIPLIED_ALPHA
+		&& (isPNG || data.blendingMode == BlendingMode::ADDITIVE);
+	if(isPNG)
+		return ReadPNG(data.path, *this, frame, premultiply, data.blendingMode);
+	return ReadJPG(data.path, *this, frame, premultiply, data.blendingMode);
 }
 
 
 
 namespace {
+	// The part of a mapped PNG file that libpng has not read yet.
+	class PNGInput {
+	public:
+		const char *next;
+		size_t remaining;
+	};
+
 	void ReadPNGInput(png_structp pngStruct, png_bytep outBytes, png_size_t byteCountToRead)
 	{
-		static_cast<iostream *>(png_get_io_ptr(pngStruct))->read(reinterpret_cast<char *>(outBytes), byteCountToRead);
+		PNGInput &input = *static_cast<PNGInput *>(png_get_io_ptr(pngStruct));
+		if(byteCountToRead > input.remaining)
+			png_error(pngStruct, "Unexpected end of file");
+		copy(input.next, input.next + byteCountToRead, reinterpret_cast<char *>(outBytes));
+		input.next += byteCountToRead;
+		input.remaining -= byteCountToRead;
 	}
 
-	bool ReadPNG(const filesystem::path &path, ImageBuffer &buffer, int frame)
+	bool ReadPNG(const filesystem::path &path, ImageBuffer &buffer, int frame, bool premultiply, BlendingMode blend)
 	{
-		// Open the file, and make sure it really is a PNG.
-		shared_ptr<iostream> file = Files::Open(path.string());
+		// Map the file into memory, so that it can be decoded without copying it.
+		shared_ptr<const string_view> file = Files::Map(path);
 		if(!file)
 			return false;
+		PNGInput input{file->data(), file->size()};
 
 		// Set up libpng.
 		png_struct *png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
@@ -224,7 +226,7 @@ namespace {
 			return false;
 		}
 
-		png_set_read_fn(png, file.get(), ReadPNGInput);
+		png_set_read_fn(png, &input, ReadPNGInput);
 		png_set_sig_bytes(png, 0);
 
 		png_read_info(png, info);
@@ -279,17 +281,23 @@ namespace {
 		if(colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
 			png_set_gray_to_rgb(png);
 		// Let libpng handle any interlaced image decoding.
-		png_set_interlace_handling(png);
+		int passes = png_set_interlace_handling(png);
 		png_read_update_info(png, info);
 
-		// Read the file.
-		vector<png_byte *> rows(height, nullptr);
-		for(int y = 0; y < height; ++y)
-			rows[y] = reinterpret_cast<png_byte *>(buffer.Begin(y, frame));
-
-		png_read_image(png, &rows.front());
+		// Read the file one row at a time, directly into the buffer. The rows of an
+		// interlaced image are not complete until the last pass, so those can only
+		// be converted once the whole image has been read.
+		for(int pass = 0; pass < passes; ++pass)
+			for(int y = 0; y < height; ++y)
+			{
+				png_read_row(png, reinterpret_cast<png_byte *>(buffer.Begin(y, frame)), nullptr);
+				if(premultiply && passes == 1)
+					PixelKernels::Premultiply(buffer.Begin(y, frame), width, blend);
+			}
+		if(premultiply && passes > 1)
+			Premultiply(buffer, frame, blend);
 
-		// Clean up. The file will be closed automatically.
+		// Clean up. The file will be unmapped automatically.
 		png_destroy_read_struct(&png, &info, nullptr);
 
 		return true;
@@ -297,10 +305,11 @@ namespace {
 
 
 
-	bool ReadJPG(const filesystem::path &path, ImageBuffer &buffer, int frame)
+	bool ReadJPG(const filesystem::path &path, ImageBuffer &buffer, int frame, bool premultiply, BlendingMode blend)
 	{
-		string data = Files::Read(path);
-		if(data.empty())
+		// Map the file into memory, so that it can be decoded without copying it.
+		shared_ptr<const string_view> data = Files::Map(path);
+		if(!data || data->empty())
 			return false;
 
 		jpeg_decompress_struct cinfo;
@@ -311,7 +320,7 @@ namespace {
 		jpeg_create_decompress(&cinfo);
 #pragma GCC diagnostic pop
 
-		jpeg_mem_src(&cinfo, reinterpret_cast<const unsigned char *>(data.data()), data.size());
+		jpeg_mem_src(&cinfo, reinterpret_cast<const unsigned char *>(data->data()), data->size());
 		jpeg_read_header(&cinfo, true);
 		cinfo.out_color_space = JCS_EXT_RGBA;
 
@@ -343,13 +352,14 @@ namespace {
 			return false;
 		}
 
-		// Read the file.
-		vector<JSAMPLE *> rows(height, nullptr);
-		for(int y = 0; y < height; ++y)
-			rows[y] = reinterpret_cast<JSAMPLE *>(buffer.Begin(y, frame));
-
-		while(height)
-			height -= jpeg_read_scanlines(&cinfo, &rows.front() + cinfo.output_scanline, height);
+		// Read the file one row at a time, directly into the buffer.
+		while(cinfo.output_scanline < cinfo.output_height)
+		{
+			uint32_t *begin = buffer.Begin(cinfo.output_scanline, frame);
+			JSAMPROW row = reinterpret_cast<JSAMPLE *>(begin);
+			if(jpeg_read_scanlines(&cinfo, &row, 1) && premultiply)
+				PixelKernels::Premultiply(begin, width, blend);
+		}
 
 		jpeg_finish_decompress(&cinfo);
 		jpeg_destroy_decompress(&cinfo);
@@ -361,27 +371,7 @@ namespace {
 
 	void Premultiply(ImageBuffer &buffer, int frame, BlendingMode blend)
 	{
-		for(int y = 0; y < buffer.Height(); ++y)
-		{
-			uint32_t *it = buffer.Begin(y, frame);
-
-			for(uint32_t *end = it + buffer.Width(); it != end; ++it)
-			{
-				uint64_t value = *it;
-				uint64_t alpha = (value & 0xFF000000) >> 24;
-
-				uint64_t red = (((value & 0xFF0000) * alpha) / 255) & 0xFF0000;
-				uint64_t green = (((value & 0xFF00) * alpha) / 255) & 0xFF00;
-				uint64_t blue = (((value & 0xFF) * alpha) / 255) & 0xFF;
-
-				value = red | green | blue;
-				if(blend == BlendingMode::HALF_ADDITIVE)
-					alpha >>= 2;
-				if(blend != BlendingMode::ADDITIVE)
-					value |= (alpha << 24);
-
-				*it = static_cast<uint32_t>(value);
-			}
-		}
+		// Each frame is stored contiguously, so it can be converted all at once.
+		PixelKernels::Premultiply(buffer.Begin(0, frame), static_cast<size_t>(buffer.Width()) * buffer.Height(), blend);
 	}
 }
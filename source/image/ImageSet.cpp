@@ -22,9 +22,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Mask.h"
 #include "MaskManager.h"
 #include "Sprite.h"
+#include "../TaskQueue.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <memory>
 
 using namespace std;
 
@@ -163,9 +166,165 @@ void ImageSet::ValidateFrames() noexcept(false)
 
 
 
-// Load all the frames. This should be called in one of the image-loading
-// worker threads. This also generates collision masks if needed.
-void ImageSet::Load() noexcept(false)
+// Load the 1x frames, and the @2x frames and swizzle masks if they are needed
+// now. This should be called in one of the image-loading worker threads. This
+// also generates collision masks if needed.
+void ImageSet::Load(bool load2x, bool loadSwizzleMasks) noexcept(false)
+{
+	int toLoad = BeginLoad(load2x, loadSwizzleMasks);
+
+	// Load the 1x sprites first, then the 2x sprites, because they are likely
+	// to be in separate locations on the disk.
+	int failed = 0;
+	for(int index = 0; index < 4; ++index)
+		if(toLoad & (1 << index))
+			for(size_t i = 0; i < paths[0].size() && !(failed & (1 << index)); ++i)
+				failed |= LoadFrame(i, 1 << index);
+
+	FinishLoad(toLoad, failed);
+}
+
+
+
+// Load the images in the same way as Load(), but decode each frame in its own
+// task in the given queue, so that sprites with many frames are not loaded by
+// only one thread. Once all of the frames are loaded, the given function is
+// called in the main thread.
+void ImageSet::Load(TaskQueue &queue, bool load2x, bool loadSwizzleMasks, function<void()> loaded) noexcept(false)
+{
+	int toLoad = BeginLoad(load2x, loadSwizzleMasks);
+
+	// Each image buffer is allocated once the first frame has been read, so read
+	// each set of frames in this thread until that has happened.
+	size_t frames = paths[0].size();
+	size_t next[4] = {frames, frames, frames, frames};
+	int failed = 0;
+	for(int index = 0; index < 4; ++index)
+		if(toLoad & (1 << index))
+			for(next[index] = 0; next[index] < frames && !buffer[index].Pixels() && !(failed & (1 << index)); )
+				failed |= LoadFrame(next[index]++, 1 << index);
+	size_t first = min({next[0], next[1], next[2], next[3]});
+
+	// The rest of the frames can be read in parallel, into the existing buffers.
+	// Whichever task finishes last queues up the rest of the work.
+	class Progress {
+	public:
+		atomic<size_t> remaining;
+		atomic<int> failed;
+		function<void()> loaded;
+	};
+	auto progress = make_shared<Progress>();
+	progress->remaining = frames - first;
+	progress->failed = failed;
+	progress->loaded = std::move(loaded);
+	auto finish = [this, &queue, progress, toLoad] {
+		queue.Run([this, progress, toLoad] { FinishLoad(toLoad, progress->failed); }, std::move(progress->loaded));
+	};
+	if(first == frames)
+	{
+		finish();
+		return;
+	}
+	for(size_t i = first; i < frames; ++i)
+	{
+		int toRead = 0;
+		for(int index = 0; index < 4; ++index)
+			if(i >= next[index] && !(failed & (1 << index)))
+				toRead |= 1 << index;
+		queue.Run([this, progress, finish, i, toRead]
+			{
+				progress->failed |= LoadFrame(i, toRead);
+				if(!--progress->remaining)
+					finish();
+			});
+	}
+}
+
+
+
+// Load the @2x frames or swizzle masks, if they were not loaded before. This
+// should be called in one of the image-loading worker threads, after Load().
+void ImageSet::LoadVariants(bool load2x, bool loadSwizzleMasks) noexcept(false)
+{
+	int toLoad = VariantsToLoad(load2x, loadSwizzleMasks);
+
+	int failed = 0;
+	for(int index = 1; index < 4; ++index)
+		if(toLoad & (1 << index))
+			for(size_t i = 0; i < paths[0].size() && !(failed & (1 << index)); ++i)
+				failed |= LoadFrame(i, 1 << index);
+
+	FinishVariants(toLoad, failed);
+}
+
+
+
+// Get the variants that have images which have not been loaded.
+int ImageSet::UnloadedVariants() const
+{
+	int variants = 0;
+	if(!is2xLoaded && (!paths[1].empty() || (areSwizzleMasksLoaded && !paths[3].empty())))
+		variants |= Sprite::HIGH_DPI;
+	if(!areSwizzleMasksLoaded && (!paths[2].empty() || (is2xLoaded && !paths[3].empty())))
+		variants |= Sprite::SWIZZLE_MASK;
+	return variants;
+}
+
+
+
+// Create the sprite and optionally upload the image data to the GPU. After this is
+// called, the internal image buffers and mask vector will be cleared, but
+// the paths are saved in case the sprite needs to be loaded again.
+void ImageSet::Upload(Sprite *sprite, bool enableUpload)
+{
+	// Clear all the buffers if we are not uploading the image data.
+	if(!enableUpload)
+	{
+		for(ImageBuffer &it : buffer)
+			it.Clear();
+		for(CompressedTexture &it : compressed)
+			it.Clear();
+	}
+
+	// Load the frames (this will clear the buffers).
+	sprite->AddFrames(buffer[0], false, &compressed[0]);
+	sprite->AddFrames(buffer[1], true, &compressed[1]);
+	sprite->AddSwizzleMaskFrames(buffer[2], false, &compressed[2]);
+	sprite->AddSwizzleMaskFrames(buffer[3], true, &compressed[3]);
+	sprite->SetUnloadedVariants(enableUpload ? UnloadedVariants() : 0);
+
+	GameData::GetMaskManager().SetMasks(sprite, std::move(masks));
+	masks.clear();
+}
+
+
+
+// Upload the images loaded by LoadVariants() to the sprite, which must have
+// already been created by Upload(). The image buffers will be cleared.
+void ImageSet::UploadVariants(Sprite *sprite)
+{
+	// If the sprite was unloaded while these images were loading, they are no
+	// longer needed.
+	if(!sprite->Texture(false))
+	{
+		for(ImageBuffer &it : buffer)
+			it.Clear();
+		for(CompressedTexture &it : compressed)
+			it.Clear();
+		return;
+	}
+
+	sprite->AddFrames(buffer[1], true, &compressed[1]);
+	sprite->AddSwizzleMaskFrames(buffer[2], false, &compressed[2]);
+	sprite->AddSwizzleMaskFrames(buffer[3], true, &compressed[3]);
+	sprite->SetUnloadedVariants(UnloadedVariants());
+}
+
+
+
+// Prepare to load the 1x frames, and the @2x frames and swizzle masks if they
+// are needed now. Returns a bit for each buffer that should be loaded.
+int ImageSet::BeginLoad(bool load2x, bool loadSwizzleMasks)
 {
 	assert(framePaths[0].empty() && "should call ValidateFrames before calling Load");
 
@@ -179,25 +338,10 @@ void ImageSet::Load() noexcept(false)
 	buffer[3].Clear(frames);
 
 	// Check whether we need to generate collision masks.
-	bool makeMasks = IsMasked(name);
-	if(makeMasks)
+	masks.clear();
+	if(IsMasked(name))
 		masks.resize(frames);
 
-	// Load the 1x sprites first, then the 2x sprites, because they are likely
-	// to be in separate locations on the disk. Create masks if needed.
-	for(size_t i = 0; i < frames; ++i)
-	{
-		const string fileName = "\"" + name + "\" frame #" + to_string(i);
-		if(!buffer[0].Read(paths[0][i], i))
-			Logger::LogError("Failed to read image data for " + fileName);
-		else if(makeMasks)
-		{
-			masks[i].Create(buffer[0], i, fileName);
-			if(!masks[i].IsLoaded())
-				Logger::LogError("Failed to create collision mask for " + fileName);
-		}
-	}
-
 	auto FillSwizzleMasks = [&](vector<filesystem::path> &toFill, unsigned int intendedSize) {
 		if(toFill.size() == 1 && intendedSize > 1)
 			for(unsigned int i = toFill.size(); i < intendedSize; i++)
@@ -208,21 +352,72 @@ void ImageSet::Load() noexcept(false)
 	FillSwizzleMasks(paths[2], paths[0].size());
 	FillSwizzleMasks(paths[3], paths[0].size());
 
+	// Now, determine which of the mask and 2x sprites are needed.
+	is2xLoaded = false;
+	areSwizzleMasksLoaded = false;
+	return 1 | VariantsToLoad(load2x, loadSwizzleMasks);
+}
+
+
+
+// Determine which of the @2x frames and swizzle masks need to be loaded, and
+// clear their buffers. Returns a bit for each buffer that should be loaded.
+int ImageSet::VariantsToLoad(bool load2x, bool loadSwizzleMasks)
+{
+	bool new2x = load2x && !is2xLoaded;
+	bool newSwizzleMasks = loadSwizzleMasks && !areSwizzleMasksLoaded;
+	is2xLoaded |= load2x;
+	areSwizzleMasksLoaded |= loadSwizzleMasks;
+
+	int toLoad = 0;
+	if(new2x)
+		toLoad |= 1 << 1;
+	if(newSwizzleMasks)
+		toLoad |= 1 << 2;
+	if((new2x || newSwizzleMasks) && is2xLoaded && areSwizzleMasksLoaded)
+		toLoad |= 1 << 3;
+	for(int index = 1; index < 4; ++index)
+		if(toLoad & (1 << index))
+			buffer[index].Clear(paths[0].size());
+	return toLoad;
+}
+
 
-	auto LoadSprites = [&](const vector<filesystem::path> &toLoad, ImageBuffer &buffer, const string &specifier) {
-		for(size_t i = 0; i < frames && i < toLoad.size(); ++i)
-			if(!buffer.Read(toLoad[i], i))
-			{
-				Logger::LogError("Removing " + specifier + " frames for \"" + name + "\" due to read error");
-				buffer.Clear();
-				break;
-			}
-	};
-	// Now, load the mask and 2x sprites, if they exist. Because the number of 1x frames
-	// is definitive, don't load any frames beyond the size of the 1x list.
-	LoadSprites(paths[1], buffer[1], "@2x");
-	LoadSprites(paths[2], buffer[2], "mask");
-	LoadSprites(paths[3], buffer[3], "@2x mask");
+
+// Read one frame of each of the given buffers, and create its collision mask if
+// needed. Different frames may be read in parallel, once each buffer has been
+// allocated. Returns a bit for each of the @2x or mask buffers that could not
+// be read; failures to read 1x frames are only logged.
+int ImageSet::LoadFrame(size_t frame, int toRead)
+{
+	int failed = 0;
+	if(toRead & 1)
+	{
+		const string fileName = "\"" + name + "\" frame #" + to_string(frame);
+		if(!buffer[0].Read(paths[0][frame], frame))
+			Logger::LogError("Failed to read image data for " + fileName);
+		else if(!masks.empty())
+		{
+			masks[frame].Create(buffer[0], frame, fileName);
+			if(!masks[frame].IsLoaded())
+				Logger::LogError("Failed to create collision mask for " + fileName);
+		}
+	}
+	// Because the number of 1x frames is definitive, don't load any frames
+	// beyond the size of the 1x list.
+	for(int index = 1; index < 4; ++index)
+		if((toRead & (1 << index)) && frame < paths[index].size() && !buffer[index].Read(paths[index][frame], frame))
+			failed |= 1 << index;
+	return failed;
+}
+
+
+
+// Finish loading the images once all of their frames have been read.
+void ImageSet::FinishLoad(int toLoad, int failed)
+{
+	Compress(0);
+	FinishVariants(toLoad, failed);
 
 	// Warn about a "high-profile" image that will be blurry due to rendering at 50% scale.
 	bool willBlur = (buffer[0].Width() & 1) || (buffer[0].Height() & 1);
@@ -237,22 +432,41 @@ void ImageSet::Load() noexcept(false)
 
 
 
-// Create the sprite and optionally upload the image data to the GPU. After this is
-// called, the internal image buffers and mask vector will be cleared, but
-// the paths are saved in case the sprite needs to be loaded again.
-void ImageSet::Upload(Sprite *sprite, bool enableUpload)
+// Discard any @2x frames or swizzle masks that could not all be read, and
+// compress the rest.
+void ImageSet::FinishVariants(int toLoad, int failed)
 {
-	// Clear all the buffers if we are not uploading the image data.
-	if(!enableUpload)
-		for(ImageBuffer &it : buffer)
-			it.Clear();
+	static const string SPECIFIER[4] = {"", "@2x", "mask", "@2x mask"};
+	for(int index = 1; index < 4; ++index)
+	{
+		if(!(toLoad & (1 << index)))
+			continue;
+		if(failed & (1 << index))
+		{
+			Logger::LogError("Removing " + SPECIFIER[index] + " frames for \"" + name + "\" due to read error");
+			buffer[index].Clear();
+		}
+		Compress(index);
+	}
+}
 
-	// Load the frames (this will clear the buffers).
-	sprite->AddFrames(buffer[0], false);
-	sprite->AddFrames(buffer[1], true);
-	sprite->AddSwizzleMaskFrames(buffer[2], false);
-	sprite->AddSwizzleMaskFrames(buffer[3], true);
 
-	GameData::GetMaskManager().SetMasks(sprite, std::move(masks));
-	masks.clear();
+
+// Compress the given set of frames if texture compression is enabled, unless
+// they were already compressed the last time these images were loaded.
+void ImageSet::Compress(int index)
+{
+	if(!CompressedTexture::IsEnabled() || !buffer[index].Pixels())
+		return;
+
+	static const string SUFFIX[4] = {"", "@2x", "@sw", "@2x@sw"};
+	filesystem::path cachePath = CompressedTexture::CachePath(name + SUFFIX[index]);
+	uint64_t key = CompressedTexture::SourceKey(paths[index]);
+	CompressedTexture &result = compressed[index];
+	if(result.Read(cachePath, key) && result.Width() == buffer[index].Width()
+			&& result.Height() == buffer[index].Height() && result.Frames() == buffer[index].Frames())
+		return;
+	result.Encode(buffer[index]);
+	if(!result.Write(cachePath, key))
+		Logger::LogError("Warning: unable to cache the compressed images for \"" + name + "\".");
 }
@@ -15,17 +15,20 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "CompressedTexture.h"
 #include "ImageBuffer.h"
 
 #include "ImageFileData.h"
 
 #include <filesystem>
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
 
 class Mask;
 class Sprite;
+class TaskQueue;
 
 
 
@@ -55,13 +58,44 @@ public:
 	void Add(ImageFileData data);
 	// Reduce all given paths to frame images into a sequence of consecutive frames.
 	void ValidateFrames() noexcept(false);
-	// Load all the frames. This should be called in one of the image-loading
-	// worker threads. This also generates collision masks if needed.
-	void Load() noexcept(false);
+	// Load the 1x frames, and the @2x frames and swizzle masks if they are needed
+	// now. This should be called in one of the image-loading worker threads. This
+	// also generates collision masks if needed.
+	void Load(bool load2x, bool loadSwizzleMasks) noexcept(false);
+	// Load the images in the same way, but decode each frame in its own task in
+	// the given queue. Once all of the frames are loaded, the given function is
+	// called in the main thread. It should keep this image set alive until then.
+	void Load(TaskQueue &queue, bool load2x, bool loadSwizzleMasks, std::function<void()> loaded) noexcept(false);
+	// Load the @2x frames or swizzle masks, if they were not loaded before. This
+	// should be called in one of the image-loading worker threads, after Load().
+	void LoadVariants(bool load2x, bool loadSwizzleMasks) noexcept(false);
+	// Get the variants that have images which have not been loaded.
+	int UnloadedVariants() const;
 	// Create the sprite and optionally upload the image data to the GPU. After this is
 	// called, the internal image buffers and mask vector will be cleared, but
 	// the paths are saved in case the sprite needs to be loaded again.
 	void Upload(Sprite *sprite, bool enableUpload);
+	// Upload the images loaded by LoadVariants() to the sprite, which must have
+	// already been created by Upload(). The image buffers will be cleared.
+	void UploadVariants(Sprite *sprite);
+
+
+private:
+	// Prepare to load the 1x frames, and the @2x frames and swizzle masks if they
+	// are needed now. Returns a bit for each buffer that should be loaded.
+	int BeginLoad(bool load2x, bool loadSwizzleMasks);
+	// Determine which of the @2x frames and swizzle masks need to be loaded, and
+	// clear their buffers.
+	int VariantsToLoad(bool load2x, bool loadSwizzleMasks);
+	// Read one frame of each of the given buffers. Returns a bit for each of
+	// the @2x or mask buffers that could not be read.
+	int LoadFrame(size_t frame, int toRead);
+	// Finish loading the images once all of their frames have been read.
+	void FinishLoad(int toLoad, int failed);
+	void FinishVariants(int toLoad, int failed);
+	// Compress the given set of frames if texture compression is enabled, unless
+	// they were already compressed the last time these images were loaded.
+	void Compress(int index);
 
 
 private:
@@ -73,5 +107,10 @@ private:
 	std::vector<std::filesystem::path> paths[4];
 	// Data loaded from the images:
 	ImageBuffer buffer[4];
+	// The same data compressed for the GPU, if texture compression is enabled.
+	CompressedTexture compressed[4];
+	// Whether the @2x frames and the swizzle masks were loaded.
+	bool is2xLoaded = false;
+	bool areSwizzleMasksLoaded = false;
 	std::vector<Mask> masks;
 };
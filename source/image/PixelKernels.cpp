@@ -0,0 +1,276 @@
+/* PixelKernels.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "PixelKernels.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ES_PIXEL_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+	// Get the alpha that a pixel with the given alpha should have in the given blending mode.
+	uint32_t BlendAlpha(uint32_t alpha, BlendingMode blend)
+	{
+		if(blend == BlendingMode::HALF_ADDITIVE)
+			return alpha >> 2;
+		if(blend == BlendingMode::ADDITIVE)
+			return 0;
+		return alpha;
+	}
+
+	void PremultiplyScalar(uint32_t *it, uint32_t *end, BlendingMode blend)
+	{
+		for( ; it != end; ++it)
+		{
+			uint64_t value = *it;
+			uint64_t alpha = (value & 0xFF000000) >> 24;
+
+			uint64_t red = (((value & 0xFF0000) * alpha) / 255) & 0xFF0000;
+			uint64_t green = (((value & 0xFF00) * alpha) / 255) & 0xFF00;
+			uint64_t blue = (((value & 0xFF) * alpha) / 255) & 0xFF;
+
+			value = red | green | blue | (static_cast<uint64_t>(BlendAlpha(alpha, blend)) << 24);
+			*it = static_cast<uint32_t>(value);
+		}
+	}
+
+	void ShrinkScalar(const uint32_t *top, const uint32_t *bottom, uint32_t *out, size_t outWidth)
+	{
+		const unsigned char *aIt = reinterpret_cast<const unsigned char *>(top);
+		const unsigned char *bIt = reinterpret_cast<const unsigned char *>(bottom);
+		unsigned char *outIt = reinterpret_cast<unsigned char *>(out);
+		const unsigned char *aEnd = aIt + 8 * outWidth;
+		for( ; aIt != aEnd; aIt += 4, bIt += 4)
+			for(int channel = 0; channel < 4; ++channel, ++aIt, ++bIt, ++outIt)
+				*outIt = (static_cast<unsigned>(aIt[0]) + static_cast<unsigned>(bIt[0])
+					+ static_cast<unsigned>(aIt[4]) + static_cast<unsigned>(bIt[4]) + 2) / 4;
+	}
+
+#ifdef ES_PIXEL_KERNELS_X86
+	// For any product of two bytes, (x * 0x8081) >> 23 is exactly x / 255.
+	const uint16_t DIVIDE_BY_255 = 0x8081;
+
+	// Premultiply four pixels, which have been unpacked into 16-bit channels.
+	// Only the color channels of the result matter; the alpha is replaced later.
+	__attribute__((target("sse2")))
+	__m128i PremultiplySSE2(__m128i channels)
+	{
+		__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(channels, 0xFF), 0xFF);
+		__m128i product = _mm_mullo_epi16(channels, alpha);
+		return _mm_srli_epi16(_mm_mulhi_epu16(product, _mm_set1_epi16(DIVIDE_BY_255)), 7);
+	}
+
+	__attribute__((target("sse2")))
+	__m128i BlendAlphaSSE2(__m128i pixels, BlendingMode blend)
+	{
+		if(blend == BlendingMode::HALF_ADDITIVE)
+			return _mm_and_si128(_mm_srli_epi32(pixels, 2), _mm_set1_epi32(0x3F000000));
+		if(blend == BlendingMode::ADDITIVE)
+			return _mm_setzero_si128();
+		return _mm_and_si128(pixels, _mm_set1_epi32(static_cast<int>(0xFF000000)));
+	}
+
+	__attribute__((target("sse2")))
+	void PremultiplySSE2(uint32_t *it, uint32_t *end, BlendingMode blend)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+		for( ; end - it >= 4; it += 4)
+		{
+			__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it));
+			__m128i low = PremultiplySSE2(_mm_unpacklo_epi8(pixels, zero));
+			__m128i high = PremultiplySSE2(_mm_unpackhi_epi8(pixels, zero));
+			__m128i color = _mm_and_si128(_mm_packus_epi16(low, high), colorMask);
+			__m128i result = _mm_or_si128(color, BlendAlphaSSE2(pixels, blend));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(it), result);
+		}
+		PremultiplyScalar(it, end, blend);
+	}
+
+	// Average the pairs of pixels in the given sums of two rows of two pixels
+	// each, which have been unpacked into 16-bit channels. The result is the two
+	// averaged pixels, in the low half of each 128-bit lane.
+	__attribute__((target("sse2")))
+	__m128i PairSSE2(__m128i low, __m128i high)
+	{
+		low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+		high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+		__m128i sum = _mm_unpacklo_epi64(low, high);
+		return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+	}
+
+	// Average four input pixels from each row into two output pixels.
+	__attribute__((target("sse2")))
+	__m128i ShrinkSSE2(const uint32_t *top, const uint32_t *bottom)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(top));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bottom));
+		__m128i low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+		__m128i high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+		return PairSSE2(low, high);
+	}
+
+	__attribute__((target("sse2")))
+	void ShrinkSSE2(const uint32_t *top, const uint32_t *bottom, uint32_t *out, size_t outWidth)
+	{
+		size_t x = 0;
+		for( ; x + 4 <= outWidth; x += 4)
+		{
+			__m128i first = ShrinkSSE2(top + 2 * x, bottom + 2 * x);
+			__m128i second = ShrinkSSE2(top + 2 * x + 4, bottom + 2 * x + 4);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), _mm_packus_epi16(first, second));
+		}
+		ShrinkScalar(top + 2 * x, bottom + 2 * x, out + x, outWidth - x);
+	}
+
+	// The AVX2 versions do the same thing as the SSE2 versions, but on each
+	// 128-bit lane of the 256-bit registers at the same time.
+	__attribute__((target("avx2")))
+	__m256i PremultiplyAVX2(__m256i channels)
+	{
+		__m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(channels, 0xFF), 0xFF);
+		__m256i product = _mm256_mullo_epi16(channels, alpha);
+		return _mm256_srli_epi16(_mm256_mulhi_epu16(product, _mm256_set1_epi16(DIVIDE_BY_255)), 7);
+	}
+
+	__attribute__((target("avx2")))
+	__m256i BlendAlphaAVX2(__m256i pixels, BlendingMode blend)
+	{
+		if(blend == BlendingMode::HALF_ADDITIVE)
+			return _mm256_and_si256(_mm256_srli_epi32(pixels, 2), _mm256_set1_epi32(0x3F000000));
+		if(blend == BlendingMode::ADDITIVE)
+			return _mm256_setzero_si256();
+		return _mm256_and_si256(pixels, _mm256_set1_epi32(static_cast<int>(0xFF000000)));
+	}
+
+	__attribute__((target("avx2")))
+	void PremultiplyAVX2(uint32_t *it, uint32_t *end, BlendingMode blend)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i colorMask = _mm256_set1_epi32(0x00FFFFFF);
+		for( ; end - it >= 8; it += 8)
+		{
+			__m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(it));
+			__m256i low = PremultiplyAVX2(_mm256_unpacklo_epi8(pixels, zero));
+			__m256i high = PremultiplyAVX2(_mm256_unpackhi_epi8(pixels, zero));
+			__m256i color = _mm256_and_si256(_mm256_packus_epi16(low, high), colorMask);
+			__m256i result = _mm256_or_si256(color, BlendAlphaAVX2(pixels, blend));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(it), result);
+		}
+		PremultiplySSE2(it, end, blend);
+	}
+
+	__attribute__((target("avx2")))
+	__m256i ShrinkAVX2(const uint32_t *top, const uint32_t *bottom)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(top));
+		__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bottom));
+		__m256i low = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+		__m256i high = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+		low = _mm256_add_epi16(low, _mm256_srli_si256(low, 8));
+		high = _mm256_add_epi16(high, _mm256_srli_si256(high, 8));
+		__m256i sum = _mm256_unpacklo_epi64(low, high);
+		return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(2)), 2);
+	}
+
+	__attribute__((target("avx2")))
+	void ShrinkAVX2(const uint32_t *top, const uint32_t *bottom, uint32_t *out, size_t outWidth)
+	{
+		size_t x = 0;
+		for( ; x + 8 <= outWidth; x += 8)
+		{
+			__m256i first = ShrinkAVX2(top + 2 * x, bottom + 2 * x);
+			__m256i second = ShrinkAVX2(top + 2 * x + 8, bottom + 2 * x + 8);
+			// Packing works within each 128-bit lane, so the output pixels end up
+			// in the order 0, 1, 4, 5, 2, 3, 6, 7 and need to be put back in order.
+			__m256i packed = _mm256_packus_epi16(first, second);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), _mm256_permute4x64_epi64(packed, 0xD8));
+		}
+		ShrinkSSE2(top + 2 * x, bottom + 2 * x, out + x, outWidth - x);
+	}
+#endif
+}
+
+
+
+// Get the best instruction set that this processor supports.
+PixelKernels::InstructionSet PixelKernels::Best()
+{
+#ifdef ES_PIXEL_KERNELS_X86
+	static const InstructionSet best = []() -> InstructionSet {
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx2"))
+			return InstructionSet::AVX2;
+		if(__builtin_cpu_supports("sse2"))
+			return InstructionSet::SSE2;
+		return InstructionSet::SCALAR;
+	}();
+	return best;
+#else
+	return InstructionSet::SCALAR;
+#endif
+}
+
+
+
+// Convert the given pixels to premultiplied alpha, and then to the given
+// blending mode. If the given instruction set is not supported, the best
+// one that is will be used instead.
+void PixelKernels::Premultiply(uint32_t *pixels, size_t count, BlendingMode blend, InstructionSet instructions)
+{
+	uint32_t *end = pixels + count;
+	switch(min(instructions, Best()))
+	{
+#ifdef ES_PIXEL_KERNELS_X86
+		case InstructionSet::AVX2:
+			PremultiplyAVX2(pixels, end, blend);
+			break;
+		case InstructionSet::SSE2:
+			PremultiplySSE2(pixels, end, blend);
+			break;
+#endif
+		default:
+			PremultiplyScalar(pixels, end, blend);
+	}
+}
+
+
+
+// Average each square of four pixels in the given two rows into one pixel
+// of the output row, which is half as wide.
+void PixelKernels::ShrinkRows(const uint32_t *top, const uint32_t *bottom, uint32_t *out, size_t outWidth,
+	InstructionSet instructions)
+{
+	switch(min(instructions, Best()))
+	{
+#ifdef ES_PIXEL_KERNELS_X86
+		case InstructionSet::AVX2:
+			ShrinkAVX2(top, bottom, out, outWidth);
+			break;
+		case InstructionSet::SSE2:
+			ShrinkSSE2(top, bottom, out, outWidth);
+			break;
+#endif
+		default:
+			ShrinkScalar(top, bottom, out, outWidth);
+	}
+}
@@ -0,0 +1,51 @@
+/* PixelKernels.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "BlendingMode.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+
+// The per-pixel conversions that are applied to every image after it is decoded.
+// Each has a plain version, and on x86 processors also versions that use SSE2
+// or AVX2 vector instructions. The best version that the processor supports is
+// chosen at runtime. All versions give exactly the same results.
+class PixelKernels {
+public:
+	enum class InstructionSet {
+		SCALAR,
+		SSE2,
+		AVX2
+	};
+
+
+public:
+	// Get the best instruction set that this processor supports.
+	static InstructionSet Best();
+
+	// Convert the given pixels to premultiplied alpha, and then to the given
+	// blending mode. If the given instruction set is not supported, the best
+	// one that is will be used instead.
+	static void Premultiply(uint32_t *pixels, size_t count, BlendingMode blend,
+		InstructionSet instructions = Best());
+	// Average each square of four pixels in the given two rows into one pixel
+	// of the output row, which is half as wide.
+	static void ShrinkRows(const uint32_t *top, const uint32_t *bottom, uint32_t *out, size_t outWidth,
+		InstructionSet instructions = Best());
+};
@@ -15,9 +15,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Sprite.h"
 
+#include "CompressedTexture.h"
 #include "ImageBuffer.h"
 #include "../Preferences.h"
 #include "../Screen.h"
+#include "SpriteSet.h"
 
 #include "../opengl.h"
 
@@ -28,11 +30,20 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
-	void AddBuffer(ImageBuffer &buffer, uint32_t *target)
+	// The internal format of BC7 textures. This has the same value in the ARB and
+	// EXT extensions that add it, and in OpenGL 4.2, but not all headers define it.
+	const GLenum COMPRESSED_RGBA_BPTC_UNORM = 0x8E8C;
+
+	void AddBuffer(ImageBuffer &buffer, CompressedTexture *compressed, uint32_t *target)
 	{
 		// Check whether this sprite is large enough to require size reduction.
+		// The compressed version is full size, so it cannot be used if so.
+		bool useCompressed = compressed && !compressed->IsEmpty();
 		if(Preferences::Has("Reduce large graphics") && buffer.Width() * buffer.Height() >= 1000000)
+		{
 			buffer.ShrinkToHalfSize();
+			useCompressed = false;
+		}
 
 		// Upload the images as a single array texture.
 		glGenTextures(1, target);
@@ -45,15 +56,22 @@ namespace {
 		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 		// Upload the image data.
-		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, // target, mipmap level, internal format,
-			buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
-			0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
+		if(useCompressed)
+			glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, COMPRESSED_RGBA_BPTC_UNORM, // target, mipmap level, format,
+				compressed->Width(), compressed->Height(), compressed->Frames(), // width, height, depth,
+				0, compressed->Size(), compressed->Data()); // border, data size, data.
+		else
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, // target, mipmap level, internal format,
+				buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
+				0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
 
 		// Unbind the texture.
 		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
 		// Free the ImageBuffer memory.
 		buffer.Clear();
+		if(compressed)
+			compressed->Clear();
 	}
 }
 
@@ -74,7 +92,8 @@ const string &Sprite::Name() const
 
 
 // Add the given frames, optionally uploading them. The given buffer will be cleared afterwards.
-void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
+// If a compressed version of the frames is given, it is uploaded instead, and also cleared.
+void Sprite::AddFrames(ImageBuffer &buffer, bool is2x, CompressedTexture *compressed)
 {
 	// If this is the 1x image, its dimensions determine the sprite's size.
 	if(!is2x)
@@ -86,19 +105,19 @@ void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
 
 	// Only non-empty buffers need to be added to the sprite.
 	if(buffer.Pixels())
-		AddBuffer(buffer, &texture[is2x]);
+		AddBuffer(buffer, compressed, &texture[is2x]);
 }
 
 
 
 // Upload the given frames. The given buffer will be cleared afterwards.
-void Sprite::AddSwizzleMaskFrames(ImageBuffer &buffer, bool is2x)
+void Sprite::AddSwizzleMaskFrames(ImageBuffer &buffer, bool is2x, CompressedTexture *compressed)
 {
 	// Do nothing if the buffer is empty.
 	if(!buffer.Pixels())
 		return;
 
-	AddBuffer(buffer, &swizzleMask[is2x]);
+	AddBuffer(buffer, compressed, &swizzleMask[is2x]);
 }
 
 
@@ -121,6 +140,26 @@ void Sprite::Unload()
 	width = 0.f;
 	height = 0.f;
 	frames = 0;
+	unloadedVariants = 0;
+	requestedVariants = 0;
+}
+
+
+
+// Set which variants of this sprite have images that are not loaded yet.
+// Drawing the sprite in a way that needs one of them will request it.
+void Sprite::SetUnloadedVariants(int variants)
+{
+	unloadedVariants = variants;
+	requestedVariants &= variants;
+}
+
+
+
+// Get the variants that have been requested since this was last called.
+int Sprite::TakeRequestedVariants()
+{
+	return requestedVariants.exchange(0);
 }
 
 
@@ -169,6 +208,8 @@ uint32_t Sprite::Texture() const
 // Get the index of the texture for the given high DPI mode.
 uint32_t Sprite::Texture(bool isHighDPI) const
 {
+	if(isHighDPI)
+		Request(HIGH_DPI);
 	return (isHighDPI && texture[1]) ? texture[1] : texture[0];
 }
 
@@ -185,5 +226,17 @@ uint32_t Sprite::SwizzleMask() const
 // Get the index of the texture for the given high DPI mode.
 uint32_t Sprite::SwizzleMask(bool isHighDPI) const
 {
+	Request(SWIZZLE_MASK);
 	return (isHighDPI && swizzleMask[1]) ? swizzleMask[1] : swizzleMask[0];
 }
+
+
+
+// Request that the given variants be loaded, if they have not been.
+void Sprite::Request(int variants) const
+{
+	variants &= unloadedVariants;
+	// Only the first request for each variant needs to be passed on.
+	if(variants && (requestedVariants.fetch_or(variants) & variants) != variants)
+		SpriteSet::Request(this);
+}
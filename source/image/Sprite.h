@@ -17,9 +17,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Point.h"
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 
+class CompressedTexture;
 class ImageBuffer;
 
 
@@ -29,16 +31,32 @@ class ImageBuffer;
 // not be as efficient as sprite sheets, but with modern graphics cards it will
 // not matter much and it makes working with the graphics a lot simpler.
 class Sprite {
+public:
+	// Images of a sprite that are only loaded once they are needed.
+	enum Variant : int {
+		HIGH_DPI = 1,
+		SWIZZLE_MASK = 2
+	};
+
+
 public:
 	explicit Sprite(const std::string &name = "");
+	Sprite(const Sprite &) = delete;
+	Sprite &operator=(const Sprite &) = delete;
 
 	const std::string &Name() const;
 
 	// Add the given frames, optionally uploading them. The given buffer will be cleared afterwards.
-	void AddFrames(ImageBuffer &buffer, bool is2x);
-	void AddSwizzleMaskFrames(ImageBuffer &buffer, bool is2x);
+	// If a compressed version of the frames is given, it is uploaded instead, and also cleared.
+	void AddFrames(ImageBuffer &buffer, bool is2x, CompressedTexture *compressed = nullptr);
+	void AddSwizzleMaskFrames(ImageBuffer &buffer, bool is2x, CompressedTexture *compressed = nullptr);
 	// Free up all textures loaded for this sprite.
 	void Unload();
+	// Set which variants of this sprite have images that are not loaded yet.
+	// Drawing the sprite in a way that needs one of them will request it.
+	void SetUnloadedVariants(int variants);
+	// Get the variants that have been requested since this was last called.
+	int TakeRequestedVariants();
 
 	// Image dimensions, in pixels.
 	float Width() const;
@@ -56,9 +74,16 @@ public:
 	uint32_t Texture() const;
 	uint32_t Texture(bool isHighDPI) const;
 
+	// The swizzle mask is only needed for swizzles that change some colors.
 	uint32_t SwizzleMask() const;
 	uint32_t SwizzleMask(bool isHighDPI) const;
 
+
+private:
+	// Request that the given variants be loaded, if they have not been.
+	void Request(int variants) const;
+
+
 private:
 	std::string name;
 
@@ -68,4 +93,9 @@ private:
 	float width = 0.f;
 	float height = 0.f;
 	int frames = 0;
+
+	// The variants that have images that are not loaded, and the ones of those
+	// that something has tried to draw. Drawing may happen in other threads.
+	std::atomic<int> unloadedVariants = 0;
+	mutable std::atomic<int> requestedVariants = 0;
 };
@@ -27,6 +27,10 @@ namespace {
 	map<string, Sprite> sprites;
 
 	mutex modifyMutex;
+
+	// Sprites that need more of their images loaded.
+	mutex requestMutex;
+	vector<Sprite *> requests;
 }
 
 
@@ -58,6 +62,28 @@ Sprite *SpriteSet::Modify(const string &name)
 
 	auto it = sprites.find(name);
 	if(it == sprites.end())
-		it = sprites.emplace(name, Sprite(name)).first;
+		it = sprites.try_emplace(name, name).first;
 	return &it->second;
 }
+
+
+
+// Note that the given sprite needs images that are not loaded yet. This may
+// be called from any thread.
+void SpriteSet::Request(const Sprite *sprite)
+{
+	lock_guard<mutex> guard(requestMutex);
+	// Only sprites in this set can have images that are not loaded yet.
+	requests.push_back(const_cast<Sprite *>(sprite));
+}
+
+
+
+// Get the sprites that have needed more images since this was last called.
+vector<Sprite *> SpriteSet::TakeRequests()
+{
+	lock_guard<mutex> guard(requestMutex);
+	vector<Sprite *> result;
+	result.swap(requests);
+	return result;
+}
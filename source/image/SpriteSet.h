@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <set>
 #include <string>
+#include <vector>
 
 class Sprite;
 
@@ -34,4 +35,10 @@ public:
 	static void CheckReferences();
 
 	static Sprite *Modify(const std::string &name);
+
+	// Note that the given sprite needs images that are not loaded yet. This may
+	// be called from any thread.
+	static void Request(const Sprite *sprite);
+	// Get the sprites that have needed more images since this was last called.
+	static std::vector<Sprite *> TakeRequests();
 };
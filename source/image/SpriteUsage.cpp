@@ -0,0 +1,196 @@
+/* SpriteUsage.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SpriteUsage.h"
+
+#include "../DataWriter.h"
+#include "../Effect.h"
+#include "../Fleet.h"
+#include "../Hardpoint.h"
+#include "../Hazard.h"
+#include "../Minable.h"
+#include "../Outfit.h"
+#include "../Planet.h"
+#include "../Ship.h"
+#include "Sprite.h"
+#include "SpriteSet.h"
+#include "../StellarObject.h"
+#include "../System.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	const map<const Sprite *, int64_t> EMPTY;
+
+	void AddSprite(set<const Sprite *> &sprites, const Sprite *sprite)
+	{
+		if(sprite)
+			sprites.insert(sprite);
+	}
+
+	void AddEffects(set<const Sprite *> &sprites, const map<const Effect *, int> &effects)
+	{
+		for(const auto &it : effects)
+			AddSprite(sprites, it.first->GetSprite());
+	}
+
+	// Add everything that may be drawn when the given weapon is fired.
+	void AddWeapon(set<const Sprite *> &sprites, const Weapon &weapon)
+	{
+		AddSprite(sprites, weapon.WeaponSprite().GetSprite());
+		AddSprite(sprites, weapon.HardpointSprite().GetSprite());
+		AddEffects(sprites, weapon.FireEffects());
+		AddEffects(sprites, weapon.LiveEffects());
+		AddEffects(sprites, weapon.HitEffects());
+		AddEffects(sprites, weapon.DieEffects());
+	}
+
+	void AddHazard(set<const Sprite *> &sprites, const Hazard &hazard)
+	{
+		AddWeapon(sprites, hazard);
+		for(const auto &it : hazard.EnvironmentalEffects())
+			AddSprite(sprites, it.first->GetSprite());
+	}
+}
+
+
+
+// Get the sprites that the given system's data says may be drawn in it:
+// its stellar objects and landscapes, the ships of any fleets that spawn
+// there, the effects of its hazards, and its asteroids and minables.
+set<const Sprite *> SpriteUsage::Predict(const System &system)
+{
+	set<const Sprite *> sprites;
+	for(const StellarObject &object : system.Objects())
+	{
+		AddSprite(sprites, object.GetSprite());
+		if(object.HasValidPlanet())
+			AddSprite(sprites, object.GetPlanet()->Landscape());
+		for(const auto &hazard : object.Hazards())
+			AddHazard(sprites, *hazard.Get());
+	}
+	for(const auto &hazard : system.Hazards())
+		AddHazard(sprites, *hazard.Get());
+
+	for(const auto &fleet : system.Fleets())
+		for(const Variant &variant : fleet.Get()->Variants())
+			for(const Ship *ship : variant.Ships())
+			{
+				AddSprite(sprites, ship->GetSprite());
+				for(const Hardpoint &hardpoint : ship->Weapons())
+					if(hardpoint.GetOutfit())
+						AddWeapon(sprites, *hardpoint.GetOutfit());
+			}
+
+	for(const System::Asteroid &asteroid : system.Asteroids())
+	{
+		if(asteroid.Type())
+			AddSprite(sprites, asteroid.Type()->GetSprite());
+		else
+			AddSprite(sprites, SpriteSet::Get("asteroid/" + asteroid.Name() + "/spin"));
+	}
+
+	return sprites;
+}
+
+
+
+// Choose the system that subsequent draws will be attributed to.
+void SpriteUsage::SetSystem(const System *system)
+{
+	current = system ? &histograms[system] : nullptr;
+}
+
+
+
+// Record that the given sprite was drawn once more in the current system.
+void SpriteUsage::Add(const Sprite *sprite)
+{
+	if(current && sprite)
+		++(*current)[sprite];
+}
+
+
+
+// Forget all the recorded usage.
+void SpriteUsage::Clear()
+{
+	histograms.clear();
+	current = nullptr;
+}
+
+
+
+// Get the recorded draw counts of each sprite in the given system.
+const map<const Sprite *, int64_t> &SpriteUsage::Get(const System *system) const
+{
+	auto it = histograms.find(system);
+	return (it == histograms.end()) ? EMPTY : it->second;
+}
+
+
+
+bool SpriteUsage::IsEmpty() const
+{
+	return histograms.empty();
+}
+
+
+
+// Write the recorded histograms, sorted by system and then by sprite name.
+void SpriteUsage::Save(DataWriter &out) const
+{
+	vector<pair<string, const map<const Sprite *, int64_t> *>> systems;
+	for(const auto &it : histograms)
+		if(!it.second.empty())
+			systems.emplace_back(it.first->TrueName(), &it.second);
+	sort(systems.begin(), systems.end());
+
+	out.Write("sprite usage");
+	out.BeginChild();
+	{
+		for(const auto &system : systems)
+		{
+			// List the sprites by name so that profiles from different runs can
+			// be compared with a simple diff.
+			vector<pair<string, int64_t>> counts;
+			counts.reserve(system.second->size());
+			for(const auto &it : *system.second)
+				counts.emplace_back(it.first->Name(), it.second);
+			sort(counts.begin(), counts.end());
+
+			out.Write("system", system.first);
+			out.BeginChild();
+			{
+				for(const auto &it : counts)
+					out.Write(it.first, it.second);
+			}
+			out.EndChild();
+		}
+	}
+	out.EndChild();
+}
+
+
+
+void SpriteUsage::Save(const filesystem::path &path) const
+{
+	DataWriter out(path);
+	Save(out);
+}
@@ -0,0 +1,63 @@
+/* SpriteUsage.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <set>
+
+class DataWriter;
+class Sprite;
+class System;
+
+
+
+// Class that records how many times each sprite is drawn in each star system.
+// A DrawList or BatchDrawList that is given a SpriteUsage will count every
+// sprite that it accepts. The resulting histograms can be used to predict which
+// sprites a system is going to need before the player arrives there, and can be
+// saved as a profile for tuning how many sprites should be kept in memory.
+class SpriteUsage {
+public:
+	// Get the sprites that the given system's data says may be drawn in it:
+	// its stellar objects and landscapes, the ships of any fleets that spawn
+	// there, the effects of its hazards, and its asteroids and minables.
+	static std::set<const Sprite *> Predict(const System &system);
+
+
+public:
+	// Choose the system that subsequent draws will be attributed to.
+	void SetSystem(const System *system);
+	// Record that the given sprite was drawn once more in the current system.
+	void Add(const Sprite *sprite);
+	// Forget all the recorded usage.
+	void Clear();
+
+	// Get the recorded draw counts of each sprite in the given system.
+	const std::map<const Sprite *, int64_t> &Get(const System *system) const;
+	bool IsEmpty() const;
+
+	// Write the recorded histograms, sorted by system and then by sprite name.
+	void Save(DataWriter &out) const;
+	void Save(const std::filesystem::path &path) const;
+
+
+private:
+	std::map<const System *, std::map<const Sprite *, int64_t>> histograms;
+	// The histogram of the system that is currently being recorded.
+	std::map<const Sprite *, int64_t> *current = nullptr;
+};
@@ -15,6 +15,7 @@ You should have received a copy of the GNU General Public License along with
 this program. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "AllocationTracker.h"
 #include "audio/Audio.h"
 #include "Command.h"
 #include "Conversation.h"
@@ -30,6 +31,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Logger.h"
 #include "MainPanel.h"
 #include "MenuPanel.h"
+#include "PackedArchive.h"
 #include "Panel.h"
 #include "PlayerInfo.h"
 #include "Plugins.h"
@@ -50,7 +52,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <cassert>
 #include <future>
 #include <exception>
+#include <filesystem>
 #include <string>
+#include <vector>
 
 #ifdef _WIN32
 #define STRICT
@@ -67,6 +71,7 @@ void PrintVersion();
 void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversation,
 	const string &testToRun, bool debugMode);
 Conversation LoadConversation();
+bool PackAssets(const filesystem::path &directory);
 void PrintTestsTable();
 #ifdef _WIN32
 void InitConsole();
@@ -90,6 +95,7 @@ int main(int argc, char *argv[])
 	bool printData = false;
 	bool noTestMute = false;
 	string testToRunName;
+	string packDirectory;
 
 	// Whether the game has encountered errors while loading.
 	bool hasErrors = false;
@@ -128,10 +134,15 @@ int main(int argc, char *argv[])
 			printTests = true;
 		else if(arg == "--nomute")
 			noTestMute = true;
+		else if(arg == "--pack" && *++it)
+			packDirectory = *it;
 	}
 	printData = PrintData::IsPrintDataArgument(argv);
 	Files::Init(argv);
 
+	if(!packDirectory.empty())
+		return !PackAssets(packDirectory);
+
 	// Whether we are running an integration test.
 	const bool isTesting = !testToRunName.empty();
 	try {
@@ -197,6 +208,7 @@ int main(int argc, char *argv[])
 			cout << "Parse completed with " << (hasErrors ? "at least one" : "no") << " error(s)." << endl;
 			if(checkAssets)
 				Audio::Quit();
+			AllocationTracker::Report();
 			return hasErrors;
 		}
 		assert(!isConsoleOnly && "Attempting to use UI when only data was loaded!");
@@ -257,6 +269,7 @@ int main(int argc, char *argv[])
 	Audio::Quit();
 	GameWindow::Quit();
 
+	AllocationTracker::Report();
 	return 0;
 }
 
@@ -394,6 +407,14 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 			if(Preferences::Has("Interrupt fast-forward") && !inFlight && isFastForward && !allowFastForward)
 				isFastForward = false;
 
+			// Load any images that the sprites drawn in the last frame needed but
+			// did not have, and upload any that have finished loading.
+			if(dataFinishedLoading)
+			{
+				GameData::LoadRequestedVariants(queue);
+				queue.ProcessSyncTasks();
+			}
+
 			// Tell all the panels to step forward, then draw them.
 			((!isDebugPaused && menuPanels.IsEmpty()) ? gamePanels : menuPanels).StepAll();
 
@@ -427,7 +448,10 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 
 			// Events in this frame may have cleared out the menu, in which case
 			// we should draw the game panels instead:
-			(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
+			{
+				AllocationTracker::Scope drawScope(AllocationTracker::Phase::DRAW);
+				(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
+			}
 
 			MainPanel *mainPanel = static_cast<MainPanel *>(gamePanels.Root().get());
 			if(mainPanel && mainPanel->GetEngine().IsPaused())
@@ -491,7 +515,10 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 
 				// Events in this frame may have cleared out the menu, in which case
 				// we should draw the game panels instead:
-				(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
+				{
+					AllocationTracker::Scope drawScope(AllocationTracker::Phase::DRAW);
+					(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
+				}
 
 				GameWindow::Step();
 
@@ -525,6 +552,8 @@ void PrintHelp()
 	cerr << "    --tests: print table of available tests, then exit." << endl;
 	cerr << "    --test <name>: run given test from resources directory." << endl;
 	cerr << "    --nomute: don't mute the game while running tests." << endl;
+	cerr << "    --pack <path>: pack the data, images, and sounds in the given resources"
+		" or plugin directory into a single archive." << endl;
 	PrintData::Help();
 	cerr << endl;
 	cerr << "Report bugs to: <https://github.com/endless-sky/endless-sky/issues>" << endl;
@@ -582,6 +611,32 @@ Conversation LoadConversation()
 
 
 
+// Pack the data, images, and sounds of the given resources or plugin directory
+// into an archive within that directory. Once the archive is in place, the
+// original files can be removed.
+bool PackAssets(const filesystem::path &directory)
+{
+	vector<filesystem::path> files;
+	for(const char *folder : {"data", "images", "sounds"})
+	{
+		vector<filesystem::path> list = Files::RecursiveList(directory / folder);
+		files.insert(files.end(), list.begin(), list.end());
+	}
+	if(files.empty())
+	{
+		Logger::LogError("Error: \"" + directory.string() + "\" has no data, images, or sounds to pack.");
+		return false;
+	}
+
+	filesystem::path archive = directory / PackedArchive::FILE_NAME;
+	if(!PackedArchive::Write(archive, directory, files))
+		return false;
+	cout << "Packed " << files.size() << " files into \"" << archive.string() << "\"." << endl;
+	return true;
+}
+
+
+
 // This prints out the list of tests that are available and their status
 // (active/missing feature/known failure)..
 void PrintTestsTable()
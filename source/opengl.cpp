@@ -62,3 +62,17 @@ bool OpenGL::HasAdaptiveVSyncSupport()
 	return GLX_EXT_swap_control_tear;
 #endif
 }
+
+
+
+bool OpenGL::HasTextureCompressionSupport()
+{
+#ifdef __APPLE__
+	// macOS doesn't support BC7 textures for OpenGL.
+	return false;
+#elif defined(ES_GLES)
+	return HasOpenGLExtension("_texture_compression_bptc");
+#else
+	return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+#endif
+}
@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Body.h"
 #include "../Screen.h"
 #include "../image/Sprite.h"
+#include "../image/SpriteUsage.h"
 
 #include <cmath>
 
@@ -56,6 +57,14 @@ void BatchDrawList::SetCenter(const Point &center)
 
 
 
+// Record every sprite that is added to this list in the given profile.
+void BatchDrawList::SetUsage(SpriteUsage *usage)
+{
+	this->usage = usage;
+}
+
+
+
 // Add an unswizzled object based on the Body class.
 bool BatchDrawList::Add(const Body &body, float clip)
 {
@@ -123,6 +132,9 @@ bool BatchDrawList::Add(const Body &body, Point position, float clip)
 	if(Cull(body, position))
 		return false;
 
+	if(usage)
+		usage->Add(body.GetSprite());
+
 	// Get the data vector for this particular sprite.
 	vector<float> &v = data[body.GetSprite()];
 	// The sprite frame is the same for every vertex.
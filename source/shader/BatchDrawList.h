@@ -22,6 +22,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 class Body;
 class Sprite;
+class SpriteUsage;
 
 
 
@@ -32,6 +33,8 @@ public:
 	// Clear the list, also setting the global time step for animation.
 	void Clear(int step = 0, double zoom = 1.);
 	void SetCenter(const Point &center);
+	// Record every sprite that is added to this list in the given profile.
+	void SetUsage(SpriteUsage *usage);
 
 	// Add an unswizzled object based on the Body class.
 	bool Add(const Body &body, float clip = 1.f);
@@ -54,6 +57,7 @@ private:
 	double zoom = 1.;
 	bool isHighDPI = false;
 	Point center;
+	SpriteUsage *usage = nullptr;
 
 	// Each sprite consists of six vertices (four vertices to form a quad and
 	// two dummy vertices to mark the break in between them). Each of those
@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Screen.h"
 #include "../image/Sprite.h"
 #include "SpriteShader.h"
+#include "../image/SpriteUsage.h"
 
 #include <cmath>
 
@@ -46,6 +47,14 @@ void DrawList::SetCenter(const Point &center, const Point &centerVelocity)
 
 
 
+// Record every sprite that is added to this list in the given profile.
+void DrawList::SetUsage(SpriteUsage *usage)
+{
+	this->usage = usage;
+}
+
+
+
 // Add an object based on the Body class.
 bool DrawList::Add(const Body &body, double cloak)
 {
@@ -96,13 +105,17 @@ bool DrawList::AddSwizzled(const Body &body, int swizzle, double cloak)
 // Draw all the items in this list.
 void DrawList::Draw() const
 {
-	SpriteShader::Bind();
+	SpriteShader::DrawBatched(items, Preferences::Has("Render motion blur"));
+}
 
-	bool withBlur = Preferences::Has("Render motion blur");
-	for(const SpriteShader::Item &item : items)
-		SpriteShader::Add(item, withBlur);
 
-	SpriteShader::Unbind();
+
+// Get the area, in the same coordinates as the objects that are added, that is on screen.
+Rectangle DrawList::VisibleArea() const
+{
+	Point margin(.5 * fabs(centerVelocity.X()), .5 * fabs(centerVelocity.Y()));
+	return Rectangle::WithCorners(center + Screen::TopLeft() / zoom - margin,
+		center + Screen::BottomRight() / zoom + margin);
 }
 
 
@@ -135,7 +148,7 @@ void DrawList::Push(const Body &body, Point pos, Point blur, double cloak, int s
 	SpriteShader::Item item;
 
 	item.texture = body.GetSprite()->Texture(isHighDPI);
-	item.swizzleMask = body.GetSprite()->SwizzleMask(isHighDPI);
+	item.swizzleMask = SpriteShader::UsesSwizzleMask(swizzle) ? body.GetSprite()->SwizzleMask(isHighDPI) : 0;
 	item.frame = body.GetFrame(step);
 	item.frameCount = body.GetSprite()->Frames();
 
@@ -167,4 +180,6 @@ void DrawList::Push(const Body &body, Point pos, Point blur, double cloak, int s
 	item.clip = 1.;
 
 	items.push_back(item);
+	if(usage)
+		usage->Add(body.GetSprite());
 }
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include "../Point.h"
+#include "../Rectangle.h"
 #include "SpriteShader.h"
 
 #include <cstdint>
@@ -23,6 +24,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 class Body;
 class Sprite;
+class SpriteUsage;
 
 
 
@@ -36,6 +38,8 @@ public:
 	// Clear the list, also setting the global time step for animation.
 	void Clear(int step = 0, double zoom = 1.);
 	void SetCenter(const Point &center, const Point &centerVelocity = Point());
+	// Record every sprite that is added to this list in the given profile.
+	void SetUsage(SpriteUsage *usage);
 
 	// Add an object based on the Body class.
 	bool Add(const Body &body, double cloak = 0.);
@@ -50,6 +54,11 @@ public:
 	// Draw all the items in this list.
 	void Draw() const;
 
+	// Get the area, in the same coordinates as the objects that are added, that
+	// is on screen. This includes a margin for the motion blur of the view, so
+	// an object that is not moving and is entirely outside this area is culled.
+	Rectangle VisibleArea() const;
+
 
 private:
 	// Determine if the given object should be drawn at all.
@@ -63,6 +72,7 @@ private:
 	double zoom = 1.;
 	bool isHighDPI = false;
 	std::vector<SpriteShader::Item> items;
+	SpriteUsage *usage = nullptr;
 
 	Point center;
 	Point centerVelocity;
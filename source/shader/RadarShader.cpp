@@ -0,0 +1,301 @@
+/* RadarShader.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "RadarShader.h"
+
+#include "../Color.h"
+#include "../Point.h"
+#include "../Screen.h"
+#include "Shader.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+	// Each ring is a quad made of two triangles. Each of its vertices has a
+	// corner (x, y), a position (x, y), a radius, a width, and a color (r, g, b, a).
+	constexpr int RING_VERTEX_SIZE = 10;
+	// Each pointer is a single triangle. Each of its vertices has a corner
+	// (x, y), a direction (x, y), and a color (r, g, b, a).
+	constexpr int POINTER_VERTEX_SIZE = 8;
+
+	const float RING_CORNERS[6][2] = {
+		{-1.f, -1.f}, {-1.f, 1.f}, {1.f, -1.f},
+		{1.f, -1.f}, {-1.f, 1.f}, {1.f, 1.f}
+	};
+	const float POINTER_CORNERS[3][2] = {
+		{0.f, 0.f}, {0.f, 1.f}, {1.f, 0.f}
+	};
+
+	Shader ringShader;
+	GLint ringScaleI;
+	GLint ringCenterI;
+	GLint ringZoomI;
+	GLint ringLimitI;
+
+	Shader pointerShader;
+	GLint pointerScaleI;
+	GLint pointerCenterI;
+	GLint pointerSizeI;
+	GLint pointerOffsetI;
+
+	GLuint ringVao;
+	GLuint ringVbo;
+	GLsizeiptr ringCapacity = 0;
+	GLuint pointerVao;
+	GLuint pointerVbo;
+	GLsizeiptr pointerCapacity = 0;
+
+	// Enable the given vertex attribute in the currently bound VAO.
+	void EnableAttrib(const Shader &shader, const char *name, int size, int stride, int offset)
+	{
+		GLuint index = shader.Attrib(name);
+		glEnableVertexAttribArray(index);
+		glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride * sizeof(float),
+			reinterpret_cast<const GLvoid *>(offset * sizeof(float)));
+	}
+
+	// Copy the given data into the given buffer. The buffer's storage is only
+	// reallocated if the data no longer fits in it, so it stays the same from one
+	// frame to the next unless the radar gets more crowded.
+	void Upload(GLuint vbo, GLsizeiptr &capacity, const vector<float> &data)
+	{
+		GLsizeiptr size = sizeof(float) * data.size();
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		if(size > capacity)
+		{
+			capacity = max(size, 2 * capacity);
+			glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_DYNAMIC_DRAW);
+		}
+		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void AppendColor(vector<float> &data, const Color &color)
+	{
+		const float *rgba = color.Get();
+		data.insert(data.end(), rgba, rgba + 4);
+	}
+}
+
+
+
+void RadarShader::Init()
+{
+	static const char *ringVertexCode =
+		"// vertex radar ring shader\n"
+		"uniform vec2 scale;\n"
+		"uniform vec2 center;\n"
+		"uniform float zoom;\n"
+		"uniform float limit;\n"
+
+		"in vec2 vert;\n"
+		"in vec2 position;\n"
+		"in vec2 size;\n"
+		"in vec4 color;\n"
+		"out vec2 coord;\n"
+		"out vec2 ringSize;\n"
+		"out vec4 ringColor;\n"
+
+		"void main() {\n"
+		"  vec2 offset = position * zoom;\n"
+		"  float len = length(offset);\n"
+		"  if(len > limit)\n"
+		"    offset *= limit / len;\n"
+		"  coord = (size.x + size.y) * vert;\n"
+		"  ringSize = size;\n"
+		"  ringColor = color;\n"
+		"  gl_Position = vec4((coord + center + offset) * scale, 0.f, 1.f);\n"
+		"}\n";
+
+	static const char *ringFragmentCode =
+		"// fragment radar ring shader\n"
+		"precision mediump float;\n"
+
+		"in vec2 coord;\n"
+		"in vec2 ringSize;\n"
+		"in vec4 ringColor;\n"
+		"out vec4 finalColor;\n"
+
+		"void main() {\n"
+		"  float lenFalloff = ringSize.y - abs(length(coord) - ringSize.x);\n"
+		"  finalColor = ringColor * clamp(lenFalloff, 0.f, 1.f);\n"
+		"}\n";
+
+	static const char *pointerVertexCode =
+		"// vertex radar pointer shader\n"
+		"uniform vec2 scale;\n"
+		"uniform vec2 center;\n"
+		"uniform vec2 size;\n"
+		"uniform float offset;\n"
+
+		"in vec2 vert;\n"
+		"in vec2 angle;\n"
+		"in vec4 color;\n"
+		"out vec2 coord;\n"
+		"out vec4 pointerColor;\n"
+
+		"void main() {\n"
+		"  coord = vert * size.x;\n"
+		"  pointerColor = color;\n"
+		"  vec2 base = center + angle * (offset - size.y * (vert.x + vert.y));\n"
+		"  vec2 wing = vec2(angle.y, -angle.x) * (size.x * .5 * (vert.x - vert.y));\n"
+		"  gl_Position = vec4((base + wing) * scale, 0, 1);\n"
+		"}\n";
+
+	static const char *pointerFragmentCode =
+		"// fragment radar pointer shader\n"
+		"precision mediump float;\n"
+		"uniform vec2 size;\n"
+
+		"in vec2 coord;\n"
+		"in vec4 pointerColor;\n"
+		"out vec4 finalColor;\n"
+
+		"void main() {\n"
+		"  float height = (coord.x + coord.y) / size.x;\n"
+		"  float taper = height * height * height;\n"
+		"  taper *= taper * .5 * size.x;\n"
+		"  float alpha = clamp(.8 * min(coord.x, coord.y) - taper, 0.f, 1.f);\n"
+		"  alpha *= clamp(1.8 * (1. - height), 0.f, 1.f);\n"
+		"  finalColor = pointerColor * alpha;\n"
+		"}\n";
+
+	ringShader = Shader(ringVertexCode, ringFragmentCode);
+	ringScaleI = ringShader.Uniform("scale");
+	ringCenterI = ringShader.Uniform("center");
+	ringZoomI = ringShader.Uniform("zoom");
+	ringLimitI = ringShader.Uniform("limit");
+
+	pointerShader = Shader(pointerVertexCode, pointerFragmentCode);
+	pointerScaleI = pointerShader.Uniform("scale");
+	pointerCenterI = pointerShader.Uniform("center");
+	pointerSizeI = pointerShader.Uniform("size");
+	pointerOffsetI = pointerShader.Uniform("offset");
+
+	// Generate the persistent buffers. Their storage is allocated on first use.
+	glGenVertexArrays(1, &ringVao);
+	glBindVertexArray(ringVao);
+	glGenBuffers(1, &ringVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, ringVbo);
+	EnableAttrib(ringShader, "vert", 2, RING_VERTEX_SIZE, 0);
+	EnableAttrib(ringShader, "position", 2, RING_VERTEX_SIZE, 2);
+	EnableAttrib(ringShader, "size", 2, RING_VERTEX_SIZE, 4);
+	EnableAttrib(ringShader, "color", 4, RING_VERTEX_SIZE, 6);
+
+	glGenVertexArrays(1, &pointerVao);
+	glBindVertexArray(pointerVao);
+	glGenBuffers(1, &pointerVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, pointerVbo);
+	EnableAttrib(pointerShader, "vert", 2, POINTER_VERTEX_SIZE, 0);
+	EnableAttrib(pointerShader, "angle", 2, POINTER_VERTEX_SIZE, 2);
+	EnableAttrib(pointerShader, "color", 4, POINTER_VERTEX_SIZE, 4);
+
+	// Unbind the VBO and VAO, but leave the vertex attrib arrays enabled in the
+	// VAOs so they will be used when they are bound.
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+
+
+// Add a ring or a dot at the given position, in world units relative to the
+// center of the radar.
+void RadarShader::AddRing(vector<float> &data, const Point &position, float out, float in, const Color &color)
+{
+	// This is the same conversion that RingShader uses for an outer and inner radius.
+	float width = .5f * (1.f + out - in);
+	float radius = out - width;
+	for(const float *corner : RING_CORNERS)
+	{
+		data.insert(data.end(), {corner[0], corner[1],
+			static_cast<float>(position.X()), static_cast<float>(position.Y()), radius, width});
+		AppendColor(data, color);
+	}
+}
+
+
+
+// Add a pointer in the direction of the given unit vector.
+void RadarShader::AddPointer(vector<float> &data, const Point &unit, const Color &color)
+{
+	for(const float *corner : POINTER_CORNERS)
+	{
+		data.insert(data.end(), {corner[0], corner[1],
+			static_cast<float>(unit.X()), static_cast<float>(unit.Y())});
+		AppendColor(data, color);
+	}
+}
+
+
+
+// Draw all of the given rings, scaling their positions into a radar display
+// at the given center and keeping them within the given radius.
+void RadarShader::DrawRings(const vector<float> &data, const Point &center, double scale, double radius)
+{
+	if(!ringShader.Object())
+		throw runtime_error("RadarShader: DrawRings() called before Init().");
+	if(data.empty())
+		return;
+
+	Upload(ringVbo, ringCapacity, data);
+
+	glUseProgram(ringShader.Object());
+	glBindVertexArray(ringVao);
+
+	GLfloat screenScale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(ringScaleI, 1, screenScale);
+	GLfloat position[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
+	glUniform2fv(ringCenterI, 1, position);
+	glUniform1f(ringZoomI, scale);
+	glUniform1f(ringLimitI, radius);
+
+	glDrawArrays(GL_TRIANGLES, 0, data.size() / RING_VERTEX_SIZE);
+
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
+
+
+
+// Draw all of the given pointers around the given center.
+void RadarShader::DrawPointers(const vector<float> &data, const Point &center,
+	float width, float height, float offset)
+{
+	if(!pointerShader.Object())
+		throw runtime_error("RadarShader: DrawPointers() called before Init().");
+	if(data.empty())
+		return;
+
+	Upload(pointerVbo, pointerCapacity, data);
+
+	glUseProgram(pointerShader.Object());
+	glBindVertexArray(pointerVao);
+
+	GLfloat screenScale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(pointerScaleI, 1, screenScale);
+	GLfloat position[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
+	glUniform2fv(pointerCenterI, 1, position);
+	GLfloat size[2] = {width, height};
+	glUniform2fv(pointerSizeI, 1, size);
+	glUniform1f(pointerOffsetI, offset);
+
+	glDrawArrays(GL_TRIANGLES, 0, data.size() / POINTER_VERTEX_SIZE);
+
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
@@ -0,0 +1,46 @@
+/* RadarShader.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+class Color;
+class Point;
+
+
+
+// Class for drawing all the rings and pointers of the radar display with one
+// draw call each. The vertex data is built up by the Radar as objects are added
+// to it, and is uploaded into buffers that are kept from one frame to the next.
+// The rings are drawn the same way RingShader draws full, undashed rings, and
+// the pointers the same way PointerShader draws them.
+class RadarShader {
+public:
+	static void Init();
+
+	// Add a ring or a dot at the given position, in world units relative to the
+	// center of the radar.
+	static void AddRing(std::vector<float> &data, const Point &position, float out, float in, const Color &color);
+	// Add a pointer in the direction of the given unit vector.
+	static void AddPointer(std::vector<float> &data, const Point &unit, const Color &color);
+
+	// Draw all of the given rings, scaling their positions into a radar display
+	// at the given center and keeping them within the given radius.
+	static void DrawRings(const std::vector<float> &data, const Point &center, double scale, double radius);
+	// Draw all of the given pointers around the given center.
+	static void DrawPointers(const std::vector<float> &data, const Point &center,
+		float width, float height, float offset);
+};
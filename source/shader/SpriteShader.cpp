@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Shader.h"
 #include "../image/Sprite.h"
 
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
@@ -48,7 +49,36 @@ namespace {
 	GLuint vao;
 	GLuint vbo;
 
+	Shader batchShader;
+	GLint batchScaleI;
+	GLint batchTexI;
+	GLint batchSwizzleMaskI;
+
+	GLuint batchVao;
+	GLuint batchVbo;
+	GLsizeiptr batchCapacity = 0;
+
 	const int SWIZZLES = 29;
+
+	// Each sprite in a batch is a quad made of two triangles. Each of its vertices
+	// has a corner (x, y), followed by all of the sprite's parameters: a position
+	// (x, y), a transform (4), a blur (x, y), a clip, an alpha, a frame, a frame
+	// count, a swizzle, and whether to use the swizzle mask.
+	constexpr int VERTEX_SIZE = 16;
+	constexpr int VERTICES_PER_ITEM = 6;
+	const float CORNERS[VERTICES_PER_ITEM][2] = {
+		{-.5f, -.5f}, {-.5f, .5f}, {.5f, -.5f},
+		{.5f, -.5f}, {-.5f, .5f}, {.5f, .5f}
+	};
+
+	// Enable the given vertex attribute in the currently bound VAO.
+	void EnableAttrib(const char *name, int size, int offset)
+	{
+		GLuint index = batchShader.Attrib(name);
+		glEnableVertexAttribArray(index);
+		glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(float),
+			reinterpret_cast<const GLvoid *>(offset * sizeof(float)));
+	}
 }
 
 // Initialize the shaders.
@@ -74,6 +104,43 @@ void SpriteShader::Init()
 		"  fragTexCoord = vec2(texCoord.x, min(clip, texCoord.y)) + blurOff;\n"
 		"}\n";
 
+	static const char *batchVertexCode =
+		"// vertex batch sprite shader\n"
+		"precision mediump float;\n"
+		"uniform vec2 scale;\n"
+
+		"in vec2 vert;\n"
+		"in vec2 itemPosition;\n"
+		"in vec4 itemTransform;\n"
+		"in vec2 itemBlur;\n"
+		"in float itemClip;\n"
+		"in float itemAlpha;\n"
+		"in float itemFrame;\n"
+		"in float itemFrameCount;\n"
+		"in float itemSwizzle;\n"
+		"in float itemUseSwizzleMask;\n"
+		"out vec2 fragTexCoord;\n"
+		"flat out int useSwizzleMask;\n"
+		"flat out float frame;\n"
+		"flat out float frameCount;\n"
+		"flat out vec2 blur;\n"
+		"flat out int swizzler;\n"
+		"flat out float alpha;\n"
+
+		"void main() {\n"
+		"  mat2 transform = mat2(itemTransform.xy, itemTransform.zw);\n"
+		"  vec2 blurOff = 2.f * vec2(vert.x * abs(itemBlur.x), vert.y * abs(itemBlur.y));\n"
+		"  gl_Position = vec4((transform * (vert + blurOff) + itemPosition) * scale, 0, 1);\n"
+		"  vec2 texCoord = vert + vec2(.5, .5);\n"
+		"  fragTexCoord = vec2(texCoord.x, min(itemClip, texCoord.y)) + blurOff;\n"
+		"  useSwizzleMask = int(itemUseSwizzleMask);\n"
+		"  frame = itemFrame;\n"
+		"  frameCount = itemFrameCount;\n"
+		"  blur = itemBlur;\n"
+		"  swizzler = int(itemSwizzle);\n"
+		"  alpha = itemAlpha;\n"
+		"}\n";
+
 	static const char *fragmentCode =
 		"// fragment sprite shader\n"
 		"precision mediump float;\n"
@@ -87,7 +154,27 @@ void SpriteShader::Init()
 		"uniform float frameCount;\n"
 		"uniform vec2 blur;\n"
 		"uniform int swizzler;\n"
-		"uniform float alpha;\n"
+		"uniform float alpha;\n";
+
+	// The batched shader gets the same parameters from its vertex shader, rather
+	// than as uniforms, so that each sprite in the batch can have its own.
+	static const char *batchFragmentCode =
+		"// fragment batch sprite shader\n"
+		"precision mediump float;\n"
+#ifdef ES_GLES
+		"precision mediump sampler2DArray;\n"
+#endif
+		"uniform sampler2DArray tex;\n"
+		"uniform sampler2DArray swizzleMask;\n"
+		"flat in int useSwizzleMask;\n"
+		"flat in float frame;\n"
+		"flat in float frameCount;\n"
+		"flat in vec2 blur;\n"
+		"flat in int swizzler;\n"
+		"flat in float alpha;\n";
+
+	// Both shaders share the same code for sampling and swizzling the sprite.
+	static const char *fragmentBody =
 		"const int range = 5;\n"
 
 		"in vec2 fragTexCoord;\n"
@@ -253,7 +340,7 @@ void SpriteShader::Init()
 		"  finalColor = color * alpha;\n"
 		"}\n";
 
-	shader = Shader(vertexCode, fragmentCode);
+	shader = Shader(vertexCode, (string(fragmentCode) + fragmentBody).c_str());
 	scaleI = shader.Uniform("scale");
 	texI = shader.Uniform("tex");
 	frameI = shader.Uniform("frame");
@@ -288,6 +375,32 @@ void SpriteShader::Init()
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
+
+	batchShader = Shader(batchVertexCode, (string(batchFragmentCode) + fragmentBody).c_str());
+	batchScaleI = batchShader.Uniform("scale");
+	batchTexI = batchShader.Uniform("tex");
+	batchSwizzleMaskI = batchShader.Uniform("swizzleMask");
+
+	// Generate the persistent buffer for batches. Its storage is allocated on first use.
+	glGenVertexArrays(1, &batchVao);
+	glBindVertexArray(batchVao);
+
+	glGenBuffers(1, &batchVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, batchVbo);
+
+	EnableAttrib("vert", 2, 0);
+	EnableAttrib("itemPosition", 2, 2);
+	EnableAttrib("itemTransform", 4, 4);
+	EnableAttrib("itemBlur", 2, 8);
+	EnableAttrib("itemClip", 1, 10);
+	EnableAttrib("itemAlpha", 1, 11);
+	EnableAttrib("itemFrame", 1, 12);
+	EnableAttrib("itemFrameCount", 1, 13);
+	EnableAttrib("itemSwizzle", 1, 14);
+	EnableAttrib("itemUseSwizzleMask", 1, 15);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
 }
 
 
@@ -313,7 +426,7 @@ SpriteShader::Item SpriteShader::Prepare(const Sprite *sprite, const Point &posi
 
 	Item item;
 	item.texture = sprite->Texture();
-	item.swizzleMask = sprite->SwizzleMask();
+	item.swizzleMask = UsesSwizzleMask(swizzle) ? sprite->SwizzleMask() : 0;
 	item.frame = frame;
 	item.frameCount = sprite->Frames();
 	// Position.
@@ -335,6 +448,16 @@ SpriteShader::Item SpriteShader::Prepare(const Sprite *sprite, const Point &posi
 
 
 
+// Check whether drawing with the given swizzle uses the sprite's swizzle
+// mask. The mask has no effect on swizzle 0, which does not change any
+// colors, or on the full color swizzles, which apply to the whole sprite.
+bool SpriteShader::UsesSwizzleMask(int swizzle)
+{
+	return swizzle > 0 && swizzle < 27;
+}
+
+
+
 void SpriteShader::Bind()
 {
 	glUseProgram(shader.Object());
@@ -386,3 +509,96 @@ void SpriteShader::Unbind()
 	glBindVertexArray(0);
 	glUseProgram(0);
 }
+
+
+
+// Draw all of the given items, in order, with as few draw calls as possible.
+void SpriteShader::DrawBatched(const vector<Item> &items, bool withBlur)
+{
+	if(items.empty())
+		return;
+
+	// Reuse the same vertex data from one frame to the next, to avoid reallocating it.
+	static vector<float> data;
+	data.clear();
+	data.reserve(items.size() * VERTICES_PER_ITEM * VERTEX_SIZE);
+	for(const Item &item : items)
+		AppendVertices(data, item, withBlur);
+
+	GLsizeiptr size = sizeof(float) * data.size();
+	glBindBuffer(GL_ARRAY_BUFFER, batchVbo);
+	if(size > batchCapacity)
+	{
+		batchCapacity = max(size, 2 * batchCapacity);
+		glBufferData(GL_ARRAY_BUFFER, batchCapacity, nullptr, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, data.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glUseProgram(batchShader.Object());
+	glBindVertexArray(batchVao);
+
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(batchScaleI, 1, scale);
+	glUniform1i(batchTexI, 0);
+	glUniform1i(batchSwizzleMaskI, 1);
+
+	for(const auto &group : Group(items))
+	{
+		const Item &item = items[group.first];
+		glBindTexture(GL_TEXTURE_2D_ARRAY, item.texture);
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, item.swizzleMask);
+		glActiveTexture(GL_TEXTURE0);
+
+		glDrawArrays(GL_TRIANGLES, group.first * VERTICES_PER_ITEM, group.second * VERTICES_PER_ITEM);
+	}
+
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
+
+
+
+// Split the given items into runs of consecutive items that use the same
+// textures, as (first item, item count) pairs. The items are not reordered,
+// because later items must be drawn on top of earlier ones.
+vector<pair<size_t, size_t>> SpriteShader::Group(const vector<Item> &items)
+{
+	vector<pair<size_t, size_t>> groups;
+	for(size_t i = 0; i < items.size(); ++i)
+	{
+		if(!groups.empty())
+		{
+			const Item &previous = items[groups.back().first];
+			if(previous.texture == items[i].texture && previous.swizzleMask == items[i].swizzleMask)
+			{
+				++groups.back().second;
+				continue;
+			}
+		}
+		groups.emplace_back(i, 1);
+	}
+	return groups;
+}
+
+
+
+// Add the vertices for drawing the given item as part of a batch. The parameters
+// are adjusted the same way Add() adjusts them.
+void SpriteShader::AppendVertices(vector<float> &data, const Item &item, bool withBlur)
+{
+	// Bounds check for the swizzle value:
+	int swizzle = (static_cast<size_t>(item.swizzle) >= SWIZZLES ? 0 : item.swizzle);
+	// Don't mask full color swizzles that always apply to the whole ship sprite.
+	float useSwizzleMask = (item.swizzle < 27 && item.swizzleMask) ? 1.f : 0.f;
+	float blurX = withBlur ? item.blur[0] : 0.f;
+	float blurY = withBlur ? item.blur[1] : 0.f;
+
+	for(const float *corner : CORNERS)
+		data.insert(data.end(), {corner[0], corner[1],
+			item.position[0], item.position[1],
+			item.transform[0], item.transform[1], item.transform[2], item.transform[3],
+			blurX, blurY, item.clip, item.alpha, item.frame, item.frameCount,
+			static_cast<float>(swizzle), useSwizzleMask});
+}
@@ -17,7 +17,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Point.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 class Sprite;
 
@@ -54,8 +57,22 @@ public:
 		int swizzle = 0, float frame = 0.f, const Point &unit = Point(0., -1.));
 	static Item Prepare(const Sprite *sprite, const Point &position, float zoom = 1.f,
 		int swizzle = 0, float frame = 0.f, const Point &unit = Point(0., -1.));
+	// Check whether drawing with the given swizzle uses the sprite's swizzle
+	// mask. The mask has no effect on swizzle 0, which does not change any
+	// colors, or on the full color swizzles, which apply to the whole sprite.
+	static bool UsesSwizzleMask(int swizzle);
 
 	static void Bind();
 	static void Add(const Item &item, bool withBlur = false);
 	static void Unbind();
+
+	// Draw all of the given items, in order, with as few draw calls as possible.
+	static void DrawBatched(const std::vector<Item> &items, bool withBlur = false);
+	// Split the given items into runs of consecutive items that use the same
+	// textures, as (first item, item count) pairs. The items are not reordered,
+	// because later items must be drawn on top of earlier ones.
+	static std::vector<std::pair<size_t, size_t>> Group(const std::vector<Item> &items);
+	// Add the vertices for drawing the given item as part of a batch. The parameters
+	// are adjusted the same way Add() adjusts them.
+	static void AppendVertices(std::vector<float> &data, const Item &item, bool withBlur);
 };
@@ -25,16 +25,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Screen.h"
 #include "../image/Sprite.h"
 #include "../image/SpriteSet.h"
+#include "StarTiles.h"
 #include "../System.h"
 
 #include <algorithm>
 #include <cmath>
-#include <numeric>
 
 using namespace std;
 
 namespace {
-	const int TILE_SIZE = 256;
+	const int TILE_SIZE = StarTiles::TILE_SIZE;
 	// The star field tiles in 4000 pixel increments. Have the tiling of the haze
 	// field be as different from that as possible. (Note: this may need adjusting
 	// in the future if monitors larger than this width ever become commonplace.)
@@ -50,6 +50,18 @@ namespace {
 	const double STAR_ZOOM = 0.70;
 	const double HAZE_ZOOM = 0.90;
 
+	// Each star consists of six vertices, each with five data elements.
+	const int VERTEX_SIZE = 5;
+	const int STAR_SIZE = 6 * VERTEX_SIZE;
+	const float CORNER[6] = {
+		static_cast<float>(0. * PI),
+		static_cast<float>(.5 * PI),
+		static_cast<float>(1.5 * PI),
+		static_cast<float>(.5 * PI),
+		static_cast<float>(1.5 * PI),
+		static_cast<float>(1. * PI)
+	};
+
 	void AddHaze(DrawList &drawList, const std::vector<Body> &haze,
 		const Point &topLeft, const Point &bottomRight, double transparency)
 	{
@@ -166,6 +178,14 @@ void StarField::Draw(const Point &pos, const Point &vel, double zoom, const Syst
 
 			glUniform1f(elongationI, length * zoom);
 			glUniform1f(brightnessI, min(1., pow(zoom, .5)));
+			// Only the bands of stars that are ranked below the fraction of the stars
+			// that should be visible are drawn, and the shader hides the rest of the
+			// stars in the last of those bands.
+			double visible = density * StarTiles::LevelOfDetail(zoom) / (pass * layers);
+			glUniform1f(visibleI, visible);
+			int bands = 1;
+			while(bands < StarTiles::BANDS && StarTiles::BandEnd(bands - 1) < visible)
+				++bands;
 
 			// Stars this far beyond the border may still overlap the screen.
 			double borderX = fabs(vel.X()) + 1.;
@@ -175,15 +195,20 @@ void StarField::Draw(const Point &pos, const Point &vel, double zoom, const Syst
 			int minY = pos.Y() + (Screen::Top() - borderY) / zoom;
 			int maxX = pos.X() + (Screen::Right() + borderX) / zoom;
 			int maxY = pos.Y() + (Screen::Bottom() + borderY) / zoom;
-			// Round down to the start of the nearest tile.
-			minX &= ~(TILE_SIZE - 1l);
-			minY &= ~(TILE_SIZE - 1l);
 
-			for(int gy = minY; gy < maxY; gy += TILE_SIZE)
+			// The stars are stored with their positions within the whole pattern, so
+			// each run of tiles in a row of a copy of the pattern can be drawn at once.
+			int width = widthMod + 1;
+			float shove = pow(-5., pass);
+			for(int gy = minY & ~widthMod; gy < maxY; gy += width)
 			{
-				float shove = pow(-5., pass);
-				for(int gx = minX; gx < maxX; gx += TILE_SIZE)
+				int firstRow = max(minY - gy, 0) / TILE_SIZE;
+				int lastRow = (min(maxY - gy, width) - 1) / TILE_SIZE;
+				for(int gx = minX & ~widthMod; gx < maxX; gx += width)
 				{
+					int firstColumn = max(minX - gx, 0) / TILE_SIZE;
+					int lastColumn = (min(maxX - gx, width) - 1) / TILE_SIZE;
+
 					Point off = Point(gx + shove, gy + shove) - pos;
 					GLfloat translate[2] = {
 						static_cast<float>(off.X()),
@@ -191,10 +216,18 @@ void StarField::Draw(const Point &pos, const Point &vel, double zoom, const Syst
 					};
 					glUniform2fv(translateI, 1, translate);
 
-					int index = (gx & widthMod) / TILE_SIZE + ((gy & widthMod) / TILE_SIZE) * tileCols;
-					int first = 6 * tileIndex[index];
-					int count = 6 * tileIndex[index + 1] - first;
-					glDrawArrays(GL_TRIANGLES, first, density * count / (pass * layers));
+					for(int row = firstRow; row <= lastRow; ++row)
+					{
+						for(int column = firstColumn; column <= lastColumn; ++column)
+							GenerateTile(column, row);
+						for(int band = 0; band < bands; ++band)
+						{
+							int first = 6 * TileIndex(firstColumn, row, band);
+							int count = 6 * TileIndex(lastColumn + 1, row, band) - first;
+							if(count)
+								glDrawArrays(GL_TRIANGLES, first, count);
+						}
+					}
 				}
 			}
 		}
@@ -245,10 +278,12 @@ void StarField::SetUpGraphics()
 		"uniform vec2 scale;\n"
 		"uniform float elongation;\n"
 		"uniform float brightness;\n"
+		"uniform float visible;\n"
 
 		"in vec2 offset;\n"
 		"in float size;\n"
 		"in float corner;\n"
+		"in float rank;\n"
 		"out float fragmentAlpha;\n"
 		"out vec2 coord;\n"
 
@@ -257,6 +292,10 @@ void StarField::SetUpGraphics()
 		"  coord = vec2(sin(corner), cos(corner));\n"
 		"  vec2 elongated = vec2(coord.x * size, coord.y * (size + elongation));\n"
 		"  gl_Position = vec4((rotate * elongated + translate + offset) * scale, 0, 1);\n"
+		// Move every vertex of a hidden star to the same point off screen, so
+		// that its triangles have no area and are clipped.
+		"  if(rank >= visible)\n"
+		"    gl_Position = vec4(2, 2, 2, 1);\n"
 		"}\n";
 
 	static const char *fragmentCode =
@@ -284,12 +323,14 @@ void StarField::SetUpGraphics()
 	offsetI = shader.Attrib("offset");
 	sizeI = shader.Attrib("size");
 	cornerI = shader.Attrib("corner");
+	rankI = shader.Attrib("rank");
 
 	scaleI = shader.Uniform("scale");
 	rotateI = shader.Uniform("rotate");
 	elongationI = shader.Uniform("elongation");
 	translateI = shader.Uniform("translate");
 	brightnessI = shader.Uniform("brightness");
+	visibleI = shader.Uniform("visible");
 }
 
 
@@ -302,95 +343,33 @@ void StarField::MakeStars(int stars, int width)
 
 	widthMod = width - 1;
 
-	tileCols = (width / TILE_SIZE);
+	// Each tile is generated independently, from its own seed, so the stars do
+	// not need to be generated until they are drawn. Only the number of stars in
+	// each band of each tile is needed to know where they will go.
+	tiles = StarTiles(width, stars, (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int());
+	tileCols = tiles.Columns();
 	tileIndex.clear();
-	tileIndex.resize(static_cast<size_t>(tileCols) * tileCols, 0);
-
-	vector<int> off;
-	static const int MAX_OFF = 50;
-	static const int MAX_D = MAX_OFF * MAX_OFF;
-	static const int MIN_D = MAX_D / 4;
-	off.reserve(MAX_OFF * MAX_OFF * 5);
-	for(int x = -MAX_OFF; x <= MAX_OFF; ++x)
-		for(int y = -MAX_OFF; y <= MAX_OFF; ++y)
-		{
-			int d = x * x + y * y;
-			if(d < MIN_D || d > MAX_D)
-				continue;
-
-			off.push_back(x);
-			off.push_back(y);
-		}
-
-	// Generate random points in a temporary vector.
-	// Keep track of how many fall into each tile, for sorting out later.
-	vector<int> temp;
-	temp.reserve(2 * stars);
-
-	int x = Random::Int(width);
-	int y = Random::Int(width);
-	for(int i = 0; i < stars; ++i)
-	{
-		for(int j = 0; j < 10; ++j)
-		{
-			int index = Random::Int(static_cast<uint32_t>(off.size())) & ~1;
-			x += off[index];
-			y += off[index + 1];
-			x &= widthMod;
-			y &= widthMod;
-		}
-		temp.push_back(x);
-		temp.push_back(y);
-		int index = (x / TILE_SIZE) + (y / TILE_SIZE) * tileCols;
-		++tileIndex[index];
-	}
-
-	// Accumulate item counts so that tileIndex[i] is the index in the array of
-	// the first star that falls within tile i, and tileIndex.back() == stars.
-	tileIndex.insert(tileIndex.begin(), 0);
-	tileIndex.pop_back();
-	partial_sum(tileIndex.begin(), tileIndex.end(), tileIndex.begin());
-
-	// Each star consists of five vertices, each with four data elements.
-	vector<GLfloat> data(6 * 4 * stars, 0.f);
-	for(auto it = temp.begin(); it != temp.end(); )
-	{
-		// Figure out what tile this star is in.
-		int x = *it++;
-		int y = *it++;
-		int index = (x / TILE_SIZE) + (y / TILE_SIZE) * tileCols;
-
-		// Randomize its sub-pixel position and its size / brightness.
-		int random = Random::Int(4096);
-		float fx = (x & (TILE_SIZE - 1)) + (random & 15) * 0.0625f;
-		float fy = (y & (TILE_SIZE - 1)) + (random >> 8) * 0.0625f;
-		float size = (((random >> 4) & 15) + 20) * 0.0625f;
-
-		// Fill in the data array.
-		auto dataIt = data.begin() + 6 * 4 * tileIndex[index]++;
-		const float CORNER[6] = {
-			static_cast<float>(0. * PI),
-			static_cast<float>(.5 * PI),
-			static_cast<float>(1.5 * PI),
-			static_cast<float>(.5 * PI),
-			static_cast<float>(1.5 * PI),
-			static_cast<float>(1. * PI)
-		};
-		for(float corner : CORNER)
+	tileIndex.reserve(static_cast<size_t>(tileCols) * StarTiles::BANDS * (tileCols + 1));
+	int count = 0;
+	for(int row = 0; row < tileCols; ++row)
+		for(int band = 0; band < StarTiles::BANDS; ++band)
 		{
-			*dataIt++ = fx;
-			*dataIt++ = fy;
-			*dataIt++ = size;
-			*dataIt++ = corner;
+			for(int column = 0; column < tileCols; ++column)
+			{
+				tileIndex.push_back(count);
+				count += tiles.CountBelow(column, row, StarTiles::BandEnd(band));
+				if(band)
+					count -= tiles.CountBelow(column, row, StarTiles::BandEnd(band - 1));
+			}
+			// Mark the end of the band, so that a run of tiles can end with the last one.
+			tileIndex.push_back(count);
 		}
-	}
-	// Adjust the tile indices so that tileIndex[i] is the start of tile i.
-	tileIndex.insert(tileIndex.begin(), 0);
+	isGenerated.assign(static_cast<size_t>(tileCols) * tileCols, false);
 
-	glBufferData(GL_ARRAY_BUFFER, sizeof(data.front()) * data.size(), data.data(), GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * STAR_SIZE * count, nullptr, GL_STATIC_DRAW);
 
 	// Connect the xy to the "vert" attribute of the vertex shader.
-	constexpr auto stride = 4 * sizeof(GLfloat);
+	constexpr auto stride = VERTEX_SIZE * sizeof(GLfloat);
 	glEnableVertexAttribArray(offsetI);
 	glVertexAttribPointer(offsetI, 2, GL_FLOAT, GL_FALSE,
 		stride, nullptr);
@@ -403,7 +382,56 @@ void StarField::MakeStars(int stars, int width)
 	glVertexAttribPointer(cornerI, 1, GL_FLOAT, GL_FALSE,
 		stride, reinterpret_cast<const GLvoid *>(3 * sizeof(GLfloat)));
 
+	glEnableVertexAttribArray(rankI);
+	glVertexAttribPointer(rankI, 1, GL_FLOAT, GL_FALSE,
+		stride, reinterpret_cast<const GLvoid *>(4 * sizeof(GLfloat)));
+
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 }
+
+
+
+// Generate the stars of the given tile if this is the first time it is drawn.
+void StarField::GenerateTile(int column, int row) const
+{
+	size_t index = column + static_cast<size_t>(row) * tileCols;
+	if(isGenerated[index])
+		return;
+	isGenerated[index] = true;
+
+	vector<GLfloat> data;
+	data.reserve(STAR_SIZE * tiles.Count(column, row));
+	for(const StarTiles::Star &star : tiles.Generate(column, row))
+	{
+		// Store the star's position within the whole pattern, rather than within
+		// its tile, so that many tiles can be drawn at once.
+		float x = star.x + column * TILE_SIZE;
+		float y = star.y + row * TILE_SIZE;
+		for(float corner : CORNER)
+			data.insert(data.end(), {x, y, star.size, corner, star.rank});
+	}
+
+	// The stars are generated in order of their rank, so each band of them is
+	// a run of stars that goes in its own place in the buffer.
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	int first = 0;
+	for(int band = 0; band < StarTiles::BANDS; ++band)
+	{
+		int last = tiles.CountBelow(column, row, StarTiles::BandEnd(band));
+		if(last > first)
+			glBufferSubData(GL_ARRAY_BUFFER, sizeof(GLfloat) * STAR_SIZE * TileIndex(column, row, band),
+				sizeof(GLfloat) * STAR_SIZE * (last - first), data.data() + STAR_SIZE * first);
+		first = last;
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+
+
+// Get the index of the first star of the given tile within the given band.
+int StarField::TileIndex(int column, int row, int band) const
+{
+	return tileIndex[(row * StarTiles::BANDS + band) * (tileCols + 1) + column];
+}
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include "Shader.h"
+#include "StarTiles.h"
 
 #include "../opengl.h"
 
@@ -29,11 +30,12 @@ class System;
 
 
 // Object to hold a set of "stars" to be drawn as a backdrop. The star pattern
-// repeats every 4096 pixels. The pattern is generated by a random walk method
-// so that some parts will be much denser than others, which is visually more
-// interesting than if the stars were evenly spread out in perfectly random
-// noise. If the view is moving, the stars are elongated in a motion blur to
-// match the motion; otherwise they would seem to jitter around.
+// repeats every 4096 pixels. The pattern is generated by StarTiles so that some
+// parts will be much denser than others, which is visually more interesting than
+// if the stars were evenly spread out in perfectly random noise. Each tile is only
+// generated the first time that it is drawn. If the view is moving, the stars are
+// elongated in a motion blur to match the motion; otherwise they would seem to
+// jitter around.
 class StarField {
 public:
 	void Init(int stars, int width);
@@ -45,12 +47,21 @@ public:
 private:
 	void SetUpGraphics();
 	void MakeStars(int stars, int width);
+	// Generate the stars of the given tile if this is the first time it is drawn.
+	void GenerateTile(int column, int row) const;
+	// Get the index of the first star of the given tile within the given band.
+	int TileIndex(int column, int row, int band) const;
 
 
 private:
 	int widthMod;
 	int tileCols;
+	StarTiles tiles;
+	// The index of the first star of each tile. The stars are stored a row of tiles
+	// at a time, and within each row, a band of ranks at a time, so that the stars
+	// of any run of tiles in a row that are in the same band are next to each other.
 	std::vector<int> tileIndex;
+	mutable std::vector<bool> isGenerated;
 
 	// Track the haze sprite, so we can animate the transition between different hazes.
 	const Sprite *lastSprite;
@@ -64,10 +75,12 @@ private:
 	GLuint offsetI;
 	GLuint sizeI;
 	GLuint cornerI;
+	GLuint rankI;
 
 	GLuint scaleI;
 	GLuint rotateI;
 	GLuint elongationI;
 	GLuint translateI;
 	GLuint brightnessI;
+	GLuint visibleI;
 };
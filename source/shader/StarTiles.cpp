@@ -0,0 +1,226 @@
+/* StarTiles.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "StarTiles.h"
+
+#include "../pi.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace std;
+
+namespace {
+	// The density of the field varies smoothly over this many tiles.
+	const int NOISE_CELL = 4;
+	// The least and greatest density of a tile, relative to the average.
+	const double MIN_WEIGHT = .2;
+	const double MAX_WEIGHT = 2.;
+	// How many stars there are per cluster within a tile, how spread out each
+	// cluster is, and what fraction of the stars belong to a cluster.
+	const int STARS_PER_CLUSTER = 48;
+	const double CLUSTER_SIGMA = 32.;
+	const double CLUSTER_FRACTION = .7;
+	// At this zoom level or above all the stars are drawn. Each halving of the
+	// zoom below it halves the stars that are drawn, down to this fraction.
+	// These must both be the end of a band.
+	const double FULL_DETAIL_ZOOM = .5;
+	const double MIN_DETAIL = .25;
+
+	// Scramble the bits of the given value (the "splitmix64" finalizer).
+	uint64_t Mix(uint64_t x)
+	{
+		x += 0x9E3779B97F4A7C15ull;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	// The standard distributions may give different results on different
+	// platforms, so do the conversions by hand to keep the field reproducible.
+	double Unit(mt19937_64 &gen)
+	{
+		return (gen() >> 11) * (1. / 9007199254740992.);
+	}
+
+	double Normal(mt19937_64 &gen)
+	{
+		double u = 1. - Unit(gen);
+		double v = Unit(gen);
+		return sqrt(-2. * log(u)) * cos(2. * PI * v);
+	}
+
+	float Wrap(double value)
+	{
+		value = fmod(value, StarTiles::TILE_SIZE);
+		if(value < 0.)
+			value += StarTiles::TILE_SIZE;
+		return (value < StarTiles::TILE_SIZE) ? value : 0.;
+	}
+}
+
+
+
+// Split a square field of the given width, which must be a power of two that
+// is at least as large as a tile, into tiles with the given total number of stars.
+StarTiles::StarTiles(int width, int stars, uint64_t seed)
+	: seed(seed)
+{
+	if(width < TILE_SIZE || (width & (width - 1)) || stars <= 0)
+		return;
+
+	columns = width / TILE_SIZE;
+
+	// Pick random values on a coarse wrapping lattice, and interpolate between
+	// them to get the relative density of each tile.
+	int lattice = max(1, columns / NOISE_CELL);
+	mt19937_64 gen(Mix(seed));
+	vector<double> noise(static_cast<size_t>(lattice) * lattice);
+	for(double &value : noise)
+		value = Unit(gen);
+
+	vector<double> weights(static_cast<size_t>(columns) * columns);
+	double total = 0.;
+	for(int row = 0; row < columns; ++row)
+		for(int column = 0; column < columns; ++column)
+		{
+			double x = (column + .5) / NOISE_CELL;
+			double y = (row + .5) / NOISE_CELL;
+			int x0 = static_cast<int>(x);
+			int y0 = static_cast<int>(y);
+			double fx = x - x0;
+			double fy = y - y0;
+			auto at = [&noise, lattice](int x, int y) { return noise[(x % lattice) + (y % lattice) * lattice]; };
+			double top = at(x0, y0) * (1. - fx) + at(x0 + 1, y0) * fx;
+			double bottom = at(x0, y0 + 1) * (1. - fx) + at(x0 + 1, y0 + 1) * fx;
+			double value = top * (1. - fy) + bottom * fy;
+
+			double &weight = weights[column + row * columns];
+			weight = MIN_WEIGHT + (MAX_WEIGHT - MIN_WEIGHT) * value * value;
+			total += weight;
+		}
+
+	// Round the running total rather than each tile's share, so that the tiles
+	// add up to exactly the requested number of stars.
+	counts.resize(weights.size());
+	double sum = 0.;
+	int previous = 0;
+	for(size_t i = 0; i < weights.size(); ++i)
+	{
+		sum += weights[i];
+		int next = lround(stars * sum / total);
+		counts[i] = next - previous;
+		previous = next;
+	}
+}
+
+
+
+// Get the number of tiles in each row and column of the field.
+int StarTiles::Columns() const
+{
+	return columns;
+}
+
+
+
+// Get the number of stars in the given tile.
+int StarTiles::Count(int column, int row) const
+{
+	if(column < 0 || row < 0 || column >= columns || row >= columns)
+		return 0;
+	return counts[column + row * columns];
+}
+
+
+
+// Get the number of stars in the given tile that are ranked below the given
+// value. Those are always the first stars that Generate() returns.
+int StarTiles::CountBelow(int column, int row, double rank) const
+{
+	// The star at index i has a rank of (i + .5) / count.
+	int count = Count(column, row);
+	return clamp(static_cast<int>(ceil(rank * count - .5)), 0, count);
+}
+
+
+
+// Generate the stars in the given tile. The same tile always has the same stars.
+vector<StarTiles::Star> StarTiles::Generate(int column, int row) const
+{
+	vector<Star> stars;
+	int count = Count(column, row);
+	if(!count)
+		return stars;
+
+	mt19937_64 gen(TileSeed(column, row));
+
+	int clusterCount = 1 + count / STARS_PER_CLUSTER;
+	vector<pair<double, double>> clusters;
+	clusters.reserve(clusterCount);
+	for(int i = 0; i < clusterCount; ++i)
+		clusters.emplace_back(Unit(gen) * TILE_SIZE, Unit(gen) * TILE_SIZE);
+
+	stars.reserve(count);
+	for(int i = 0; i < count; ++i)
+	{
+		Star star;
+		if(Unit(gen) < CLUSTER_FRACTION)
+		{
+			const auto &center = clusters[gen() % clusters.size()];
+			star.x = Wrap(center.first + CLUSTER_SIGMA * Normal(gen));
+			star.y = Wrap(center.second + CLUSTER_SIGMA * Normal(gen));
+		}
+		else
+		{
+			star.x = Wrap(Unit(gen) * TILE_SIZE);
+			star.y = Wrap(Unit(gen) * TILE_SIZE);
+		}
+		star.size = ((gen() & 15) + 20) * .0625f;
+		// The stars are independent of each other, so the order they are generated
+		// in is already random.
+		star.rank = (i + .5f) / count;
+		stars.push_back(star);
+	}
+	return stars;
+}
+
+
+
+// Get the fraction of the stars that should be drawn at the given zoom level.
+// Zoomed out views show more tiles, so they get by with fewer stars in each.
+double StarTiles::LevelOfDetail(double zoom)
+{
+	double fraction = 1.;
+	for( ; zoom < FULL_DETAIL_ZOOM && fraction > MIN_DETAIL; zoom *= 2.)
+		fraction *= .5;
+	return fraction;
+}
+
+
+
+// Get the rank that the given band ends at.
+double StarTiles::BandEnd(int band)
+{
+	return ldexp(1., band + 1 - BANDS);
+}
+
+
+
+uint64_t StarTiles::TileSeed(int column, int row) const
+{
+	return Mix(seed ^ Mix((static_cast<uint64_t>(row) << 32) | static_cast<uint32_t>(column)));
+}
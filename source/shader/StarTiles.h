@@ -0,0 +1,81 @@
+/* StarTiles.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+
+
+// Class that procedurally generates the stars of a StarField, one square tile at
+// a time. Each tile's stars depend only on the seed and on the tile's column and
+// row, so any tile can be generated on its own, in any order. The number of stars
+// in each tile follows a smooth noise pattern across the whole field, so that
+// some areas are much denser than others, and within a tile the stars are drawn
+// towards a few random clusters. The stars of a tile are in random order, and
+// each is given a rank between 0 and 1, so that drawing only the stars below a
+// certain rank gives an evenly thinned out version of the same field.
+class StarTiles {
+public:
+	static constexpr int TILE_SIZE = 256;
+	// The stars of each tile can be split by rank into this many bands. Each band
+	// has half the ranks of the one after it, and every level of detail ends at
+	// the end of a band.
+	static constexpr int BANDS = 4;
+
+	class Star {
+	public:
+		// The position of this star within its tile, in pixels.
+		float x;
+		float y;
+		float size;
+		float rank;
+	};
+
+
+public:
+	// Create an empty field, with no tiles.
+	StarTiles() = default;
+	// Split a square field of the given width, which must be a power of two that
+	// is at least as large as a tile, into tiles with the given total number of stars.
+	StarTiles(int width, int stars, uint64_t seed);
+
+	// Get the number of tiles in each row and column of the field.
+	int Columns() const;
+	// Get the number of stars in the given tile.
+	int Count(int column, int row) const;
+	// Get the number of stars in the given tile that are ranked below the given
+	// value. Those are always the first stars that Generate() returns.
+	int CountBelow(int column, int row, double rank) const;
+	// Generate the stars in the given tile. The same tile always has the same stars.
+	std::vector<Star> Generate(int column, int row) const;
+
+	// Get the fraction of the stars that should be drawn at the given zoom level.
+	// Zoomed out views show more tiles, so they get by with fewer stars in each.
+	static double LevelOfDetail(double zoom);
+	// Get the rank that the given band ends at.
+	static double BandEnd(int band);
+
+
+private:
+	uint64_t TileSeed(int column, int row) const;
+
+
+private:
+	int columns = 0;
+	uint64_t seed = 0;
+	std::vector<int> counts;
+};
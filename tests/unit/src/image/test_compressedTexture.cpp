@@ -0,0 +1,307 @@
+/* test_compressedTexture.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/image/CompressedTexture.h"
+
+// Include the helpers for holding the uncompressed images and naming archives.
+#include "../../../../source/image/ImageBuffer.h"
+#include "../../../../source/PackedArchive.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// A temporary directory that is removed when it goes out of scope.
+class TemporaryDirectory {
+public:
+	explicit TemporaryDirectory(const std::string &name)
+		: path(std::filesystem::temp_directory_path() / ("es-test-" + name))
+	{
+		std::filesystem::remove_all(path);
+		std::filesystem::create_directories(path);
+	}
+	~TemporaryDirectory() { std::filesystem::remove_all(path); }
+
+	std::filesystem::path path;
+};
+
+uint32_t Pixel(int red, int green, int blue, int alpha)
+{
+	return red | (green << 8) | (blue << 16) | (static_cast<uint32_t>(alpha) << 24);
+}
+
+// Sprite-like frames, with premultiplied alpha: a smoothly shaded hull with
+// some fine detail, surrounded by soft and then fully transparent edges.
+void MakeSprite(ImageBuffer &buffer, int width, int height, int frames)
+{
+	buffer.Clear(frames);
+	buffer.Allocate(width, height);
+	for(int frame = 0; frame < frames; ++frame)
+		for(int y = 0; y < height; ++y)
+			for(int x = 0; x < width; ++x)
+			{
+				double dx = (x - .5 * width) / (.4 * width);
+				double dy = (y - .5 * height) / (.4 * height);
+				double distance = std::sqrt(dx * dx + dy * dy);
+				int alpha = std::clamp(static_cast<int>((1.2 - distance) * 5. * 255.), 0, 255);
+				int shade = 100 + static_cast<int>(80. * std::sin(.05 * x + .07 * y + frame));
+				int detail = ((x / 3 + y / 5 + frame) % 4) * 12;
+				int red = std::min(255, shade + detail) * alpha / 255;
+				int green = std::min(255, shade + detail / 2) * alpha / 255;
+				int blue = std::min(255, shade + 40) * alpha / 255;
+				buffer.Begin(y, frame)[x] = Pixel(red, green, blue, alpha);
+			}
+}
+
+// A block in mode 6, with the given 7-bit endpoints and p-bits, and the
+// given 4-bit index for every pixel but the first, which is 3 bits.
+std::vector<uint8_t> MakeBlock(int low, int lowBit, int high, int highBit, int firstIndex, int index)
+{
+	std::vector<uint8_t> block(CompressedTexture::BLOCK_BYTES, 0);
+	int position = 0;
+	auto Put = [&block, &position](uint32_t value, int bits) {
+		for(int i = 0; i < bits; ++i, ++position)
+			if((value >> i) & 1)
+				block[position / 8] |= 1 << (position % 8);
+	};
+	Put(1 << 6, 7);
+	for(int channel = 0; channel < 4; ++channel)
+	{
+		Put(low, 7);
+		Put(high, 7);
+	}
+	Put(lowBit, 1);
+	Put(highBit, 1);
+	Put(firstIndex, 3);
+	for(int i = 1; i < 16; ++i)
+		Put(index, 4);
+	return block;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Compressing images", "[CompressedTexture]" ) {
+	GIVEN( "an image of a single color" ) {
+		ImageBuffer buffer;
+		buffer.Allocate(8, 8);
+		std::fill(buffer.Pixels(), buffer.Pixels() + 64, Pixel(0, 0, 0, 0));
+		CompressedTexture compressed;
+		compressed.Encode(buffer);
+		THEN( "it is stored in one block per 4x4 pixels" ) {
+			CHECK( compressed.Width() == 8 );
+			CHECK( compressed.Height() == 8 );
+			CHECK( compressed.Frames() == 1 );
+			CHECK( compressed.Size() == 4 * CompressedTexture::BLOCK_BYTES );
+		}
+		THEN( "fully transparent pixels stay exactly transparent" ) {
+			ImageBuffer decoded;
+			compressed.Decode(decoded);
+			CHECK( std::isinf(CompressedTexture::PSNR(buffer, decoded)) );
+		}
+	}
+	GIVEN( "an image whose size is not a multiple of the block size" ) {
+		ImageBuffer buffer;
+		MakeSprite(buffer, 37, 22, 3);
+		CompressedTexture compressed;
+		compressed.Encode(buffer);
+		THEN( "the blocks cover the whole image" ) {
+			CHECK( compressed.FrameSize() == 10 * 6 * CompressedTexture::BLOCK_BYTES );
+			CHECK( compressed.Size() == 3 * compressed.FrameSize() );
+		}
+		THEN( "it decodes to an image of the same size" ) {
+			ImageBuffer decoded;
+			compressed.Decode(decoded);
+			CHECK( decoded.Width() == 37 );
+			CHECK( decoded.Height() == 22 );
+			CHECK( decoded.Frames() == 3 );
+			CHECK( CompressedTexture::PSNR(buffer, decoded) > 35. );
+		}
+	}
+	GIVEN( "a sprite-like image" ) {
+		ImageBuffer buffer;
+		MakeSprite(buffer, 128, 96, 2);
+		CompressedTexture compressed;
+		compressed.Encode(buffer);
+		THEN( "it takes a quarter of the memory" ) {
+			CHECK( compressed.Size() * 4 == static_cast<size_t>(128 * 96 * 2 * 4) );
+		}
+		THEN( "the quality is high" ) {
+			ImageBuffer decoded;
+			compressed.Decode(decoded);
+			CHECK( CompressedTexture::PSNR(buffer, decoded) > 38. );
+		}
+	}
+	GIVEN( "an empty image" ) {
+		ImageBuffer buffer;
+		CompressedTexture compressed;
+		compressed.Encode(buffer);
+		THEN( "nothing is compressed" ) {
+			CHECK( compressed.IsEmpty() );
+		}
+	}
+}
+
+SCENARIO( "Decoding compressed blocks", "[CompressedTexture][Decode]" ) {
+	GIVEN( "blocks laid out as the BC7 format describes" ) {
+		CompressedTexture compressed;
+		ImageBuffer buffer;
+		buffer.Allocate(4, 4);
+		compressed.Encode(buffer);
+		TemporaryDirectory directory("compressed-texture-blocks");
+		const std::filesystem::path path = directory.path / "block.bc7";
+		REQUIRE( compressed.Write(path, 0) );
+
+		// Replace the encoded block with a hand-made one.
+		auto Decode = [&path](const std::vector<uint8_t> &block) {
+			std::string contents = std::string(std::filesystem::file_size(path), '\0');
+			{
+				std::ifstream in(path, std::ios::binary);
+				in.read(contents.data(), contents.size());
+			}
+			std::copy(block.begin(), block.end(), contents.end() - CompressedTexture::BLOCK_BYTES);
+			std::ofstream(path, std::ios::binary) << contents;
+			CompressedTexture loaded;
+			ImageBuffer decoded;
+			if(loaded.Read(path, 0))
+				loaded.Decode(decoded);
+			return decoded.Pixels() ? std::vector<uint32_t>(decoded.Pixels(), decoded.Pixels() + 16)
+				: std::vector<uint32_t>();
+		};
+		THEN( "endpoints with the highest values decode to white" ) {
+			const std::vector<uint32_t> pixels = Decode(MakeBlock(127, 1, 127, 1, 0, 0));
+			REQUIRE( pixels.size() == 16 );
+			CHECK( std::all_of(pixels.begin(), pixels.end(), [](uint32_t pixel) { return pixel == 0xFFFFFFFF; }) );
+		}
+		THEN( "the indices interpolate between the endpoints" ) {
+			const std::vector<uint32_t> pixels = Decode(MakeBlock(0, 0, 127, 1, 7, 15));
+			REQUIRE( pixels.size() == 16 );
+			// Index 7 has a weight of 30 out of 64: (34 * 0 + 30 * 255 + 32) / 64 = 120.
+			CHECK( pixels[0] == Pixel(120, 120, 120, 120) );
+			CHECK( pixels[1] == 0xFFFFFFFF );
+			CHECK( pixels[15] == 0xFFFFFFFF );
+		}
+	}
+}
+
+SCENARIO( "Caching compressed images", "[CompressedTexture][Cache]" ) {
+	TemporaryDirectory directory("compressed-texture-cache");
+	ImageBuffer buffer;
+	MakeSprite(buffer, 20, 16, 2);
+	CompressedTexture compressed;
+	compressed.Encode(buffer);
+	const std::filesystem::path path = directory.path / "cache" / "sprite.bc7";
+	REQUIRE( compressed.Write(path, 1234) );
+
+	GIVEN( "the key the cache file was written with" ) {
+		CompressedTexture loaded;
+		REQUIRE( loaded.Read(path, 1234) );
+		THEN( "the same compressed image is read back" ) {
+			CHECK( loaded.Width() == 20 );
+			CHECK( loaded.Height() == 16 );
+			CHECK( loaded.Frames() == 2 );
+			CHECK( std::equal(loaded.Data(), loaded.Data() + loaded.Size(), compressed.Data(),
+				compressed.Data() + compressed.Size()) );
+		}
+	}
+	GIVEN( "a different key" ) {
+		THEN( "the cache file is not used" ) {
+			CompressedTexture loaded;
+			CHECK_FALSE( loaded.Read(path, 4321) );
+			CHECK( loaded.IsEmpty() );
+		}
+	}
+	GIVEN( "a cache file that has been cut short" ) {
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+		THEN( "it is not used" ) {
+			CompressedTexture loaded;
+			CHECK_FALSE( loaded.Read(path, 1234) );
+		}
+	}
+	GIVEN( "image files that change" ) {
+		const std::filesystem::path image = directory.path / "image.png";
+		std::ofstream(image, std::ios::binary) << "first";
+		const uint64_t key = CompressedTexture::SourceKey({image});
+		THEN( "the key changes too" ) {
+			CHECK( CompressedTexture::SourceKey({image}) == key );
+			std::ofstream(image, std::ios::binary) << "second version";
+			CHECK( CompressedTexture::SourceKey({image}) != key );
+			CHECK( CompressedTexture::SourceKey({}) != key );
+		}
+	}
+	GIVEN( "image files in a packed archive" ) {
+		const std::filesystem::path archive = directory.path / PackedArchive::FILE_NAME;
+		std::ofstream(archive, std::ios::binary) << "first";
+		const std::filesystem::path image = directory.path / "images" / "image.png";
+		const uint64_t key = CompressedTexture::SourceKey({image});
+		THEN( "the key changes when the archive is rewritten" ) {
+			CHECK( CompressedTexture::SourceKey({image}) == key );
+			std::ofstream(archive, std::ios::binary) << "second version";
+			CHECK( CompressedTexture::SourceKey({image}) != key );
+		}
+	}
+	GIVEN( "different sprite names" ) {
+		THEN( "they have different cache files" ) {
+			CHECK( CompressedTexture::CachePath("ship/a") != CompressedTexture::CachePath("ship/b") );
+			CHECK( CompressedTexture::CachePath("ship/a").extension() == ".bc7" );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark CompressedTexture", "[!benchmark][CompressedTexture]" ) {
+	// An animated sprite about the size of a large ship's, with 16 frames.
+	ImageBuffer buffer;
+	MakeSprite(buffer, 256, 256, 16);
+	CompressedTexture compressed;
+	compressed.Encode(buffer);
+	ImageBuffer decoded;
+	compressed.Decode(decoded);
+
+	const size_t original = static_cast<size_t>(buffer.Width()) * buffer.Height() * buffer.Frames() * 4;
+	WARN( "PSNR: " << CompressedTexture::PSNR(buffer, decoded) << " dB; texture memory: " << original
+		<< " bytes uncompressed, " << compressed.Size() << " bytes compressed" );
+
+	BENCHMARK( "CompressedTexture::Encode" ) {
+		CompressedTexture result;
+		result.Encode(buffer);
+		return result.Size();
+	};
+	BENCHMARK( "CompressedTexture::Decode" ) {
+		ImageBuffer result;
+		compressed.Decode(result);
+		return result.Pixels()[0];
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
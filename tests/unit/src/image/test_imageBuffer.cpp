@@ -0,0 +1,262 @@
+/* test_imageBuffer.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/image/ImageBuffer.h"
+
+// Include a helper for describing the image files to read.
+#include "../../../../source/image/ImageFileData.h"
+
+// ... and any system includes needed for the test file.
+#include <jpeglib.h>
+#include <png.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// A temporary directory that is removed when it goes out of scope.
+class TemporaryDirectory {
+public:
+	explicit TemporaryDirectory(const std::string &name)
+		: path(std::filesystem::temp_directory_path() / ("es-test-" + name))
+	{
+		std::filesystem::remove_all(path);
+		std::filesystem::create_directories(path);
+	}
+	~TemporaryDirectory() { std::filesystem::remove_all(path); }
+
+	std::filesystem::path path;
+};
+
+// A frame with every alpha value, and colors that differ in every channel.
+std::vector<uint32_t> MakePixels(int width, int height, uint32_t seed)
+{
+	std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+	for(uint32_t &pixel : pixels)
+	{
+		seed = seed * 1664525 + 1013904223;
+		pixel = seed;
+	}
+	return pixels;
+}
+
+// The conversion that ImageBuffer did after reading the whole frame, before
+// the conversion was done as each row was read.
+std::vector<uint32_t> ReferencePremultiply(std::vector<uint32_t> pixels, BlendingMode blend)
+{
+	for(uint32_t &pixel : pixels)
+	{
+		uint64_t value = pixel;
+		uint64_t alpha = (value & 0xFF000000) >> 24;
+
+		uint64_t red = (((value & 0xFF0000) * alpha) / 255) & 0xFF0000;
+		uint64_t green = (((value & 0xFF00) * alpha) / 255) & 0xFF00;
+		uint64_t blue = (((value & 0xFF) * alpha) / 255) & 0xFF;
+
+		value = red | green | blue;
+		if(blend == BlendingMode::HALF_ADDITIVE)
+			alpha >>= 2;
+		if(blend != BlendingMode::ADDITIVE)
+			value |= (alpha << 24);
+
+		pixel = static_cast<uint32_t>(value);
+	}
+	return pixels;
+}
+
+// Write the given pixels, which are stored in memory in RGBA order, as a PNG.
+void WritePNG(const std::filesystem::path &path, const std::vector<uint32_t> &pixels, int width, int height,
+	bool interlaced)
+{
+	FILE *file = std::fopen(path.string().c_str(), "wb");
+	png_struct *png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+	png_info *info = png_create_info_struct(png);
+	png_init_io(png, file);
+	png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGB_ALPHA,
+		interlaced ? PNG_INTERLACE_ADAM7 : PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_write_info(png, info);
+	std::vector<png_byte *> rows;
+	for(int y = 0; y < height; ++y)
+		rows.push_back(const_cast<png_byte *>(reinterpret_cast<const png_byte *>(pixels.data() + y * width)));
+	png_write_image(png, rows.data());
+	png_write_end(png, nullptr);
+	png_destroy_write_struct(&png, &info);
+	std::fclose(file);
+}
+
+// Write an opaque image as a JPEG, using only the red, green, and blue channels.
+void WriteJPG(const std::filesystem::path &path, const std::vector<uint32_t> &pixels, int width, int height)
+{
+	FILE *file = std::fopen(path.string().c_str(), "wb");
+	jpeg_compress_struct cinfo;
+	jpeg_error_mgr jerr;
+	cinfo.err = jpeg_std_error(&jerr);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+	jpeg_create_compress(&cinfo);
+#pragma GCC diagnostic pop
+	jpeg_stdio_dest(&cinfo, file);
+	cinfo.image_width = width;
+	cinfo.image_height = height;
+	cinfo.input_components = 4;
+	cinfo.in_color_space = JCS_EXT_RGBA;
+	jpeg_set_defaults(&cinfo);
+	jpeg_start_compress(&cinfo, true);
+	while(cinfo.next_scanline < cinfo.image_height)
+	{
+		JSAMPROW row = const_cast<JSAMPLE *>(
+			reinterpret_cast<const JSAMPLE *>(pixels.data() + cinfo.next_scanline * width));
+		jpeg_write_scanlines(&cinfo, &row, 1);
+	}
+	jpeg_finish_compress(&cinfo);
+	jpeg_destroy_compress(&cinfo);
+	std::fclose(file);
+}
+
+std::vector<uint32_t> Frame(const ImageBuffer &buffer, int frame)
+{
+	return std::vector<uint32_t>(buffer.Begin(0, frame), buffer.Begin(buffer.Height(), frame));
+}
+
+const std::vector<BlendingMode> BLENDING_MODES = {BlendingMode::ALPHA, BlendingMode::PREMULTIPLIED_ALPHA,
+	BlendingMode::HALF_ADDITIVE, BlendingMode::ADDITIVE};
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Reading PNG images", "[ImageBuffer][Read]" ) {
+	TemporaryDirectory directory("image-buffer-png");
+	const int width = 37;
+	const int height = 23;
+	const std::vector<uint32_t> pixels = MakePixels(width, height, 17);
+
+	GIVEN( "an image in each blending mode, with and without interlacing" ) {
+		for(bool interlaced : {false, true})
+			for(BlendingMode blend : BLENDING_MODES)
+			{
+				const std::filesystem::path path = directory.path / ("ship" + std::string(1, static_cast<char>(blend))
+					+ (interlaced ? "1.png" : "0.png"));
+				WritePNG(path, pixels, width, height, interlaced);
+				const ImageFileData data(path, directory.path);
+				REQUIRE( data.blendingMode == blend );
+
+				ImageBuffer buffer;
+				REQUIRE( buffer.Read(data) );
+				CHECK( buffer.Width() == width );
+				CHECK( buffer.Height() == height );
+				const std::vector<uint32_t> expected = blend == BlendingMode::PREMULTIPLIED_ALPHA
+					? pixels : ReferencePremultiply(pixels, blend);
+				CHECK( Frame(buffer, 0) == expected );
+			}
+	}
+	GIVEN( "several frames of an animation" ) {
+		ImageBuffer buffer(3);
+		for(int frame = 0; frame < 3; ++frame)
+		{
+			const std::filesystem::path path = directory.path / ("ship-" + std::to_string(frame) + ".png");
+			WritePNG(path, MakePixels(width, height, frame), width, height, frame == 1);
+			REQUIRE( buffer.Read(ImageFileData(path, directory.path), frame) );
+		}
+		THEN( "each frame is read into its own part of the buffer" ) {
+			for(int frame = 0; frame < 3; ++frame)
+				CHECK( Frame(buffer, frame) == ReferencePremultiply(MakePixels(width, height, frame),
+					BlendingMode::ALPHA) );
+		}
+	}
+	GIVEN( "a file that has been cut short" ) {
+		const std::filesystem::path path = directory.path / "ship.png";
+		WritePNG(path, pixels, width, height, false);
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+		THEN( "it cannot be read" ) {
+			ImageBuffer buffer;
+			CHECK_FALSE( buffer.Read(ImageFileData(path, directory.path)) );
+		}
+	}
+	GIVEN( "a file that does not exist" ) {
+		THEN( "it cannot be read" ) {
+			ImageBuffer buffer;
+			CHECK_FALSE( buffer.Read(ImageFileData(directory.path / "missing.png", directory.path)) );
+		}
+	}
+}
+
+SCENARIO( "Reading JPEG images", "[ImageBuffer][Read]" ) {
+	TemporaryDirectory directory("image-buffer-jpg");
+	const int width = 40;
+	const int height = 19;
+	const std::vector<uint32_t> pixels = MakePixels(width, height, 5);
+	WriteJPG(directory.path / "haze.jpg", pixels, width, height);
+	WriteJPG(directory.path / "haze+0.jpg", pixels, width, height);
+
+	GIVEN( "an image with normal blending" ) {
+		ImageBuffer buffer;
+		REQUIRE( buffer.Read(ImageFileData(directory.path / "haze.jpg", directory.path)) );
+		THEN( "it is opaque" ) {
+			CHECK( buffer.Width() == width );
+			CHECK( buffer.Height() == height );
+			bool opaque = true;
+			for(uint32_t pixel : Frame(buffer, 0))
+				opaque &= (pixel >> 24) == 0xFF;
+			CHECK( opaque );
+		}
+		AND_GIVEN( "the same image with additive blending" ) {
+			ImageBuffer additive;
+			REQUIRE( additive.Read(ImageFileData(directory.path / "haze+0.jpg", directory.path)) );
+			THEN( "it has the same colors, but no alpha" ) {
+				std::vector<uint32_t> expected = Frame(buffer, 0);
+				for(uint32_t &pixel : expected)
+					pixel &= 0xFFFFFF;
+				CHECK( Frame(additive, 0) == expected );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark ImageBuffer::Read", "[!benchmark][ImageBuffer]" ) {
+	// An animated sprite about the size of a large ship's, with 16 frames.
+	TemporaryDirectory directory("image-buffer-benchmark");
+	const int width = 256;
+	const int height = 256;
+	const int frames = 16;
+	for(int frame = 0; frame < frames; ++frame)
+		WritePNG(directory.path / ("ship-" + std::to_string(frame) + ".png"), MakePixels(width, height, frame),
+			width, height, false);
+
+	BENCHMARK( "ImageBuffer::Read (16 PNG frames)" ) {
+		ImageBuffer buffer(frames);
+		for(int frame = 0; frame < frames; ++frame)
+			buffer.Read(ImageFileData(directory.path / ("ship-" + std::to_string(frame) + ".png"), directory.path),
+				frame);
+		return buffer.Pixels()[0];
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
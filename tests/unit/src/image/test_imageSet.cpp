@@ -0,0 +1,277 @@
+/* test_imageSet.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/image/ImageSet.h"
+
+// Include helpers for requesting the images that a sprite needs.
+#include "../../../../source/image/Mask.h"
+#include "../../../../source/image/Sprite.h"
+#include "../../../../source/image/SpriteSet.h"
+#include "../../../../source/TaskQueue.h"
+
+// ... and any system includes needed for the test file.
+#include <png.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// A temporary directory that is removed when it goes out of scope.
+class TemporaryDirectory {
+public:
+	explicit TemporaryDirectory(const std::string &name)
+		: path(std::filesystem::temp_directory_path() / ("es-test-" + name))
+	{
+		std::filesystem::remove_all(path);
+		std::filesystem::create_directories(path);
+	}
+	~TemporaryDirectory() { std::filesystem::remove_all(path); }
+
+	std::filesystem::path path;
+};
+
+void WritePNG(const std::filesystem::path &path, int width, int height)
+{
+	std::filesystem::create_directories(path.parent_path());
+	std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+	uint32_t seed = width;
+	for(uint32_t &pixel : pixels)
+	{
+		seed = seed * 1664525 + 1013904223;
+		pixel = seed;
+	}
+	FILE *file = std::fopen(path.string().c_str(), "wb");
+	png_struct *png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+	png_info *info = png_create_info_struct(png);
+	png_init_io(png, file);
+	png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE,
+		PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_write_info(png, info);
+	for(int y = 0; y < height; ++y)
+		png_write_row(png, reinterpret_cast<png_const_bytep>(pixels.data() + y * width));
+	png_write_end(png, nullptr);
+	png_destroy_write_struct(&png, &info);
+	std::fclose(file);
+}
+
+// Write the frames of an animated sprite, with the given variants, and
+// collect them into an image set.
+std::shared_ptr<ImageSet> MakeImageSet(const std::filesystem::path &root, const std::string &name, int size,
+	int frames, bool has2x, bool hasSwizzleMask)
+{
+	auto imageSet = std::make_shared<ImageSet>(name);
+	for(int frame = 0; frame < frames; ++frame)
+	{
+		const std::string base = name + "-" + std::to_string(frame);
+		std::vector<std::filesystem::path> files = {root / (base + ".png")};
+		WritePNG(files.back(), size, size);
+		if(has2x)
+		{
+			files.push_back(root / (base + "@2x.png"));
+			WritePNG(files.back(), 2 * size, 2 * size);
+		}
+		if(hasSwizzleMask)
+		{
+			files.push_back(root / (base + "@sw.png"));
+			WritePNG(files.back(), size, size);
+		}
+		if(has2x && hasSwizzleMask)
+		{
+			files.push_back(root / (base + "@sw@2x.png"));
+			WritePNG(files.back(), 2 * size, 2 * size);
+		}
+		for(const auto &file : files)
+			imageSet->Add(ImageFileData(file, root));
+	}
+	imageSet->ValidateFrames();
+	return imageSet;
+}
+
+// Run the queue's main thread tasks until the given count of loaded sprites is not zero.
+void WaitUntilLoaded(TaskQueue &queue, const int &loaded)
+{
+	while(!loaded)
+	{
+		queue.ProcessSyncTasks();
+		std::this_thread::yield();
+	}
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Loading only the images that are needed", "[ImageSet]" ) {
+	TemporaryDirectory directory("image-set");
+	const std::filesystem::path &root = directory.path;
+
+	GIVEN( "a sprite with @2x frames and swizzle masks" ) {
+		auto imageSet = MakeImageSet(root, "effect/blast", 8, 2, true, true);
+		WHEN( "only the 1x frames are loaded" ) {
+			imageSet->Load(false, false);
+			THEN( "both of the other variants are still unloaded" ) {
+				CHECK( imageSet->UnloadedVariants() == (Sprite::HIGH_DPI | Sprite::SWIZZLE_MASK) );
+			}
+			AND_WHEN( "the @2x frames are loaded later" ) {
+				imageSet->LoadVariants(true, false);
+				THEN( "only the swizzle masks are still unloaded" ) {
+					CHECK( imageSet->UnloadedVariants() == Sprite::SWIZZLE_MASK );
+				}
+				AND_WHEN( "the swizzle masks are loaded too" ) {
+					imageSet->LoadVariants(false, true);
+					THEN( "nothing is left to load" ) {
+						CHECK( imageSet->UnloadedVariants() == 0 );
+					}
+				}
+			}
+		}
+		WHEN( "every variant is loaded at once" ) {
+			imageSet->Load(true, true);
+			THEN( "nothing is left to load" ) {
+				CHECK( imageSet->UnloadedVariants() == 0 );
+			}
+		}
+	}
+	GIVEN( "a sprite with only 1x frames" ) {
+		auto imageSet = MakeImageSet(root, "effect/spark", 8, 1, false, false);
+		imageSet->Load(false, false);
+		THEN( "there is nothing to load later" ) {
+			CHECK( imageSet->UnloadedVariants() == 0 );
+		}
+	}
+	GIVEN( "a sprite with swizzle masks but no @2x frames" ) {
+		auto imageSet = MakeImageSet(root, "effect/flare", 8, 1, false, true);
+		imageSet->Load(true, false);
+		THEN( "only the swizzle masks are left to load" ) {
+			CHECK( imageSet->UnloadedVariants() == Sprite::SWIZZLE_MASK );
+		}
+	}
+}
+
+SCENARIO( "Requesting images that a sprite does not have yet", "[ImageSet][Sprite]" ) {
+	SpriteSet::TakeRequests();
+	Sprite sprite("test");
+
+	GIVEN( "a sprite that has every image it could need" ) {
+		THEN( "drawing it requests nothing" ) {
+			sprite.Texture(true);
+			sprite.SwizzleMask(true);
+			CHECK( sprite.TakeRequestedVariants() == 0 );
+			CHECK( SpriteSet::TakeRequests().empty() );
+		}
+	}
+	GIVEN( "a sprite whose @2x frames and swizzle masks are not loaded" ) {
+		sprite.SetUnloadedVariants(Sprite::HIGH_DPI | Sprite::SWIZZLE_MASK);
+		THEN( "drawing it at 1x without a mask requests nothing" ) {
+			sprite.Texture(false);
+			CHECK( sprite.TakeRequestedVariants() == 0 );
+		}
+		THEN( "drawing it at high resolution requests the @2x frames once" ) {
+			sprite.Texture(true);
+			sprite.Texture(true);
+			const std::vector<Sprite *> requests = SpriteSet::TakeRequests();
+			CHECK( requests == std::vector<Sprite *>{&sprite} );
+			CHECK( sprite.TakeRequestedVariants() == Sprite::HIGH_DPI );
+		}
+		THEN( "drawing it with a swizzle mask requests the masks" ) {
+			sprite.SwizzleMask(false);
+			CHECK( sprite.TakeRequestedVariants() == Sprite::SWIZZLE_MASK );
+			CHECK( SpriteSet::TakeRequests().size() == 1 );
+		}
+		THEN( "nothing is requested once the sprite is unloaded" ) {
+			sprite.Unload();
+			sprite.Texture(true);
+			CHECK( sprite.TakeRequestedVariants() == 0 );
+		}
+	}
+}
+
+SCENARIO( "Loading the frames of a sprite in parallel", "[ImageSet][TaskQueue]" ) {
+	TemporaryDirectory directory("image-set-parallel");
+	TaskQueue queue;
+	GIVEN( "a sprite with many frames" ) {
+		auto imageSet = MakeImageSet(directory.path, "effect/parallel", 16, 12, true, true);
+		int loaded = 0;
+		imageSet->Load(queue, true, false, [&loaded] { ++loaded; });
+		WaitUntilLoaded(queue, loaded);
+		THEN( "it is only reported as loaded once" ) {
+			queue.Wait();
+			queue.ProcessSyncTasks();
+			CHECK( loaded == 1 );
+		}
+		THEN( "the same images are loaded as when loading it in one thread" ) {
+			CHECK( imageSet->UnloadedVariants() == Sprite::SWIZZLE_MASK );
+		}
+	}
+	GIVEN( "a sprite with only one frame" ) {
+		auto imageSet = MakeImageSet(directory.path, "effect/single", 16, 1, false, false);
+		int loaded = 0;
+		imageSet->Load(queue, true, true, [&loaded] { ++loaded; });
+		WaitUntilLoaded(queue, loaded);
+		THEN( "it is still reported as loaded" ) {
+			CHECK( loaded == 1 );
+			CHECK( imageSet->UnloadedVariants() == 0 );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark ImageSet::Load", "[!benchmark][ImageSet]" ) {
+	// A ship-sized sprite with 4 frames, @2x frames, and swizzle masks.
+	TemporaryDirectory directory("image-set-benchmark");
+	auto imageSet = MakeImageSet(directory.path, "effect/benchmark", 128, 4, true, true);
+
+	BENCHMARK( "ImageSet::Load (1x only)" ) {
+		imageSet->Load(false, false);
+		return imageSet->UnloadedVariants();
+	};
+	BENCHMARK( "ImageSet::Load (every variant)" ) {
+		imageSet->Load(true, true);
+		return imageSet->UnloadedVariants();
+	};
+
+	// A long animation, which used to be loaded by a single thread.
+	auto animation = MakeImageSet(directory.path, "effect/animation", 128, 32, false, false);
+	BENCHMARK( "ImageSet::Load (32 frames, one thread)" ) {
+		animation->Load(false, false);
+		return animation->UnloadedVariants();
+	};
+	TaskQueue queue;
+	BENCHMARK( "ImageSet::Load (32 frames, in parallel)" ) {
+		int loaded = 0;
+		animation->Load(queue, false, false, [&loaded] { ++loaded; });
+		WaitUntilLoaded(queue, loaded);
+		return animation->UnloadedVariants();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
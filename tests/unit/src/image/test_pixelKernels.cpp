@@ -0,0 +1,227 @@
+/* test_pixelKernels.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/image/PixelKernels.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+using InstructionSet = PixelKernels::InstructionSet;
+
+// The conversions as ImageBuffer did them before they were vectorized. Every
+// version of the kernels must match these exactly.
+void ReferencePremultiply(std::vector<uint32_t> &pixels, BlendingMode blend)
+{
+	for(uint32_t &pixel : pixels)
+	{
+		uint64_t value = pixel;
+		uint64_t alpha = (value & 0xFF000000) >> 24;
+
+		uint64_t red = (((value & 0xFF0000) * alpha) / 255) & 0xFF0000;
+		uint64_t green = (((value & 0xFF00) * alpha) / 255) & 0xFF00;
+		uint64_t blue = (((value & 0xFF) * alpha) / 255) & 0xFF;
+
+		value = red | green | blue;
+		if(blend == BlendingMode::HALF_ADDITIVE)
+			alpha >>= 2;
+		if(blend != BlendingMode::ADDITIVE)
+			value |= (alpha << 24);
+
+		pixel = static_cast<uint32_t>(value);
+	}
+}
+
+std::vector<uint32_t> ReferenceShrink(const std::vector<uint32_t> &top, const std::vector<uint32_t> &bottom,
+	size_t outWidth)
+{
+	std::vector<uint32_t> result(outWidth);
+	const unsigned char *aIt = reinterpret_cast<const unsigned char *>(top.data());
+	const unsigned char *bIt = reinterpret_cast<const unsigned char *>(bottom.data());
+	unsigned char *out = reinterpret_cast<unsigned char *>(result.data());
+	const unsigned char *aEnd = aIt + 4 * 2 * outWidth;
+	for( ; aIt != aEnd; aIt += 4, bIt += 4)
+		for(int channel = 0; channel < 4; ++channel, ++aIt, ++bIt, ++out)
+			*out = (static_cast<unsigned>(aIt[0]) + static_cast<unsigned>(bIt[0])
+				+ static_cast<unsigned>(aIt[4]) + static_cast<unsigned>(bIt[4]) + 2) / 4;
+	return result;
+}
+
+std::vector<uint32_t> MakePixels(size_t count, uint32_t seed)
+{
+	std::vector<uint32_t> pixels(count);
+	for(uint32_t &pixel : pixels)
+	{
+		seed = seed * 1664525 + 1013904223;
+		pixel = seed;
+	}
+	return pixels;
+}
+
+// Every combination of one color channel value and one alpha value, with the
+// other channels set to different values so that each is checked.
+std::vector<uint32_t> MakeAllCombinations()
+{
+	std::vector<uint32_t> pixels;
+	for(uint32_t alpha = 0; alpha < 256; ++alpha)
+		for(uint32_t color = 0; color < 256; ++color)
+			pixels.push_back((alpha << 24) | (color << 16) | ((255 - color) << 8) | (color ^ 0x5A));
+	return pixels;
+}
+
+// A sprite-like frame: an opaque middle surrounded by soft, then fully transparent edges.
+std::vector<uint32_t> MakeSprite(int width, int height, uint32_t seed)
+{
+	std::vector<uint32_t> pixels = MakePixels(static_cast<size_t>(width) * height, seed);
+	for(int y = 0; y < height; ++y)
+		for(int x = 0; x < width; ++x)
+		{
+			int edge = std::min(std::min(x, width - 1 - x), std::min(y, height - 1 - y));
+			uint32_t alpha = edge < width / 8 ? 0 : edge < width / 4 ? (pixels[x + y * width] >> 24) : 255;
+			uint32_t &pixel = pixels[x + y * width];
+			pixel = (pixel & 0xFFFFFF) | (alpha << 24);
+		}
+	return pixels;
+}
+
+const std::vector<InstructionSet> INSTRUCTION_SETS = {InstructionSet::SCALAR, InstructionSet::SSE2,
+	InstructionSet::AVX2};
+const std::vector<BlendingMode> BLENDING_MODES = {BlendingMode::ALPHA, BlendingMode::HALF_ADDITIVE,
+	BlendingMode::ADDITIVE};
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Converting pixels to premultiplied alpha", "[PixelKernels][Premultiply]" ) {
+	GIVEN( "every combination of color and alpha" ) {
+		const std::vector<uint32_t> pixels = MakeAllCombinations();
+		for(BlendingMode blend : BLENDING_MODES)
+		{
+			std::vector<uint32_t> expected = pixels;
+			ReferencePremultiply(expected, blend);
+			for(InstructionSet instructions : INSTRUCTION_SETS)
+			{
+				std::vector<uint32_t> result = pixels;
+				PixelKernels::Premultiply(result.data(), result.size(), blend, instructions);
+				CHECK( result == expected );
+			}
+		}
+	}
+	GIVEN( "runs of pixels that do not fill a whole vector" ) {
+		for(size_t count = 0; count < 20; ++count)
+		{
+			const std::vector<uint32_t> pixels = MakePixels(count, count);
+			std::vector<uint32_t> expected = pixels;
+			ReferencePremultiply(expected, BlendingMode::ALPHA);
+			for(InstructionSet instructions : INSTRUCTION_SETS)
+			{
+				std::vector<uint32_t> result = pixels;
+				PixelKernels::Premultiply(result.data(), result.size(), BlendingMode::ALPHA, instructions);
+				CHECK( result == expected );
+			}
+		}
+	}
+}
+
+SCENARIO( "Shrinking rows of pixels to half size", "[PixelKernels][ShrinkRows]" ) {
+	GIVEN( "rows of many different widths" ) {
+		for(size_t outWidth = 0; outWidth < 40; ++outWidth)
+		{
+			const std::vector<uint32_t> top = MakePixels(2 * outWidth + 1, 2 * outWidth);
+			const std::vector<uint32_t> bottom = MakePixels(2 * outWidth + 1, 3 * outWidth + 7);
+			const std::vector<uint32_t> expected = ReferenceShrink(top, bottom, outWidth);
+			for(InstructionSet instructions : INSTRUCTION_SETS)
+			{
+				std::vector<uint32_t> result(outWidth);
+				PixelKernels::ShrinkRows(top.data(), bottom.data(), result.data(), outWidth, instructions);
+				CHECK( result == expected );
+			}
+		}
+	}
+	GIVEN( "rows with extreme values" ) {
+		const std::vector<uint32_t> top(64, 0xFFFFFFFF);
+		const std::vector<uint32_t> bottom(64, 0xFF00FF01);
+		const std::vector<uint32_t> expected = ReferenceShrink(top, bottom, 32);
+		for(InstructionSet instructions : INSTRUCTION_SETS)
+		{
+			std::vector<uint32_t> result(32);
+			PixelKernels::ShrinkRows(top.data(), bottom.data(), result.data(), 32, instructions);
+			CHECK( result == expected );
+		}
+	}
+}
+
+SCENARIO( "Choosing the instruction set", "[PixelKernels][Best]" ) {
+	GIVEN( "any processor" ) {
+		THEN( "the choice is the same every time" ) {
+			CHECK( PixelKernels::Best() == PixelKernels::Best() );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark PixelKernels", "[!benchmark][PixelKernels]" ) {
+	// An animated sprite about the size of a large ship's, with 16 frames.
+	const int width = 256;
+	const int height = 256;
+	std::vector<uint32_t> frames;
+	for(int frame = 0; frame < 16; ++frame)
+	{
+		std::vector<uint32_t> sprite = MakeSprite(width, height, frame);
+		frames.insert(frames.end(), sprite.begin(), sprite.end());
+	}
+
+	for(InstructionSet instructions : INSTRUCTION_SETS)
+	{
+		if(instructions > PixelKernels::Best())
+			continue;
+		const std::string name = instructions == InstructionSet::SCALAR ? "scalar"
+			: instructions == InstructionSet::SSE2 ? "SSE2" : "AVX2";
+
+		BENCHMARK_ADVANCED( "PixelKernels::Premultiply (" + name + ")" )(Catch::Benchmark::Chronometer meter) {
+			std::vector<uint32_t> pixels = frames;
+			meter.measure([&pixels, instructions] {
+				PixelKernels::Premultiply(pixels.data(), pixels.size(), BlendingMode::ALPHA, instructions);
+				return pixels[0];
+			});
+		};
+		BENCHMARK( "PixelKernels::ShrinkRows (" + name + ")" ) {
+			std::vector<uint32_t> result(frames.size() / 4);
+			for(size_t y = 0; y < frames.size() / width / 2; ++y)
+			{
+				const uint32_t *top = frames.data() + width * (2 * y);
+				PixelKernels::ShrinkRows(top, top + width, result.data() + width / 2 * y, width / 2, instructions);
+			}
+			return result[0];
+		};
+	}
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
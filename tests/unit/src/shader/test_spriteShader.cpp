@@ -0,0 +1,182 @@
+/* test_spriteShader.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/shader/SpriteShader.h"
+
+// ... and any system includes needed for the test file.
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+SpriteShader::Item MakeItem(uint32_t texture, uint32_t swizzleMask, uint32_t swizzle = 0)
+{
+	SpriteShader::Item item;
+	item.texture = texture;
+	item.swizzleMask = swizzleMask;
+	item.swizzle = swizzle;
+	item.frame = 2.5f;
+	item.frameCount = 4.f;
+	item.position[0] = 10.f;
+	item.position[1] = -20.f;
+	item.transform[0] = 1.f;
+	item.transform[1] = 2.f;
+	item.transform[2] = 3.f;
+	item.transform[3] = 4.f;
+	item.blur[0] = 5.f;
+	item.blur[1] = 6.f;
+	item.clip = .75f;
+	item.alpha = .5f;
+	return item;
+}
+
+// The number of floats in each vertex, and the number of vertices in each item.
+constexpr size_t VERTEX_SIZE = 16;
+constexpr size_t VERTICES = 6;
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Grouping sprites into batches", "[SpriteShader][Group]" ) {
+	GIVEN( "no items" ) {
+		THEN( "there are no groups" ) {
+			CHECK( SpriteShader::Group({}).empty() );
+		}
+	}
+	GIVEN( "items that all use the same textures" ) {
+		const std::vector<SpriteShader::Item> items(5, MakeItem(1, 2));
+		THEN( "they are all in one group" ) {
+			const auto groups = SpriteShader::Group(items);
+			REQUIRE( groups.size() == 1 );
+			CHECK( groups[0].first == 0 );
+			CHECK( groups[0].second == 5 );
+		}
+	}
+	GIVEN( "items with interleaved textures" ) {
+		const std::vector<SpriteShader::Item> items = {
+			MakeItem(1, 0), MakeItem(1, 0), MakeItem(2, 0), MakeItem(1, 0), MakeItem(1, 3)
+		};
+		THEN( "only consecutive items are grouped, in the original order" ) {
+			const auto groups = SpriteShader::Group(items);
+			REQUIRE( groups.size() == 4 );
+			CHECK( groups[0] == std::pair<size_t, size_t>(0, 2) );
+			CHECK( groups[1] == std::pair<size_t, size_t>(2, 1) );
+			CHECK( groups[2] == std::pair<size_t, size_t>(3, 1) );
+			CHECK( groups[3] == std::pair<size_t, size_t>(4, 1) );
+		}
+	}
+}
+
+SCENARIO( "Building the vertices of a batch", "[SpriteShader][AppendVertices]" ) {
+	GIVEN( "an item" ) {
+		const SpriteShader::Item item = MakeItem(1, 2, 3);
+		std::vector<float> data;
+		WHEN( "it is added with blur" ) {
+			SpriteShader::AppendVertices(data, item, true);
+			REQUIRE( data.size() == VERTICES * VERTEX_SIZE );
+			THEN( "every vertex has the same parameters as the single sprite path" ) {
+				for(size_t i = 0; i < VERTICES; ++i)
+				{
+					const float *vertex = data.data() + i * VERTEX_SIZE;
+					CHECK( (vertex[0] == -.5f || vertex[0] == .5f) );
+					CHECK( (vertex[1] == -.5f || vertex[1] == .5f) );
+					CHECK( vertex[2] == item.position[0] );
+					CHECK( vertex[3] == item.position[1] );
+					for(int j = 0; j < 4; ++j)
+						CHECK( vertex[4 + j] == item.transform[j] );
+					CHECK( vertex[8] == item.blur[0] );
+					CHECK( vertex[9] == item.blur[1] );
+					CHECK( vertex[10] == item.clip );
+					CHECK( vertex[11] == item.alpha );
+					CHECK( vertex[12] == item.frame );
+					CHECK( vertex[13] == item.frameCount );
+					CHECK( vertex[14] == 3.f );
+					CHECK( vertex[15] == 1.f );
+				}
+			}
+			THEN( "the vertices form two triangles covering the whole quad" ) {
+				float area = 0.f;
+				for(size_t t = 0; t < 2; ++t)
+				{
+					const float *a = data.data() + (3 * t) * VERTEX_SIZE;
+					const float *b = a + VERTEX_SIZE;
+					const float *c = b + VERTEX_SIZE;
+					float cross = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+					area += (cross < 0.f ? -cross : cross) * .5f;
+				}
+				CHECK( area == 1.f );
+			}
+		}
+		WHEN( "it is added without blur" ) {
+			SpriteShader::AppendVertices(data, item, false);
+			THEN( "the blur is zero" ) {
+				CHECK( data[8] == 0.f );
+				CHECK( data[9] == 0.f );
+			}
+		}
+	}
+	GIVEN( "an item with a full color swizzle" ) {
+		std::vector<float> data;
+		SpriteShader::AppendVertices(data, MakeItem(1, 2, 27), false);
+		THEN( "the swizzle mask is not used" ) {
+			CHECK( data[14] == 27.f );
+			CHECK( data[15] == 0.f );
+		}
+	}
+	GIVEN( "an item without a swizzle mask" ) {
+		std::vector<float> data;
+		SpriteShader::AppendVertices(data, MakeItem(1, 0, 3), false);
+		THEN( "the swizzle mask is not used" ) {
+			CHECK( data[15] == 0.f );
+		}
+	}
+	GIVEN( "an item with an invalid swizzle" ) {
+		std::vector<float> data;
+		SpriteShader::AppendVertices(data, MakeItem(1, 2, 100), false);
+		THEN( "the swizzle is reset to the default" ) {
+			CHECK( data[14] == 0.f );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark SpriteShader batching", "[!benchmark][SpriteShader]" ) {
+	// A typical busy frame: runs of ships, projectiles, and effects sharing sprites.
+	std::vector<SpriteShader::Item> items;
+	for(uint32_t i = 0; i < 2000; ++i)
+		items.push_back(MakeItem(1 + (i / 8) % 40, (i / 8) % 2, i % 7));
+
+	BENCHMARK( "SpriteShader::Group" ) {
+		return SpriteShader::Group(items).size();
+	};
+	BENCHMARK( "SpriteShader::AppendVertices" ) {
+		std::vector<float> data;
+		for(const SpriteShader::Item &item : items)
+			SpriteShader::AppendVertices(data, item, true);
+		return data.size();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,178 @@
+/* test_starTiles.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/shader/StarTiles.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Generating the tiles of a star field", "[StarTiles]" ) {
+	GIVEN( "a valid field" ) {
+		const StarTiles tiles(4096, 16384, 1234);
+		const int columns = tiles.Columns();
+		REQUIRE( columns == 4096 / StarTiles::TILE_SIZE );
+
+		THEN( "the tiles add up to the requested number of stars" ) {
+			int total = 0;
+			for(int row = 0; row < columns; ++row)
+				for(int column = 0; column < columns; ++column)
+					total += tiles.Count(column, row);
+			CHECK( total == 16384 );
+		}
+		THEN( "some tiles are denser than others" ) {
+			int least = tiles.Count(0, 0);
+			int most = least;
+			for(int row = 0; row < columns; ++row)
+				for(int column = 0; column < columns; ++column)
+				{
+					least = std::min(least, tiles.Count(column, row));
+					most = std::max(most, tiles.Count(column, row));
+				}
+			CHECK( most > 2 * least );
+		}
+		THEN( "tiles outside the field are empty" ) {
+			CHECK( tiles.Count(-1, 0) == 0 );
+			CHECK( tiles.Count(0, columns) == 0 );
+			CHECK( tiles.Generate(columns, 0).empty() );
+		}
+		WHEN( "a tile is generated" ) {
+			const std::vector<StarTiles::Star> stars = tiles.Generate(3, 5);
+			THEN( "it has the expected number of stars" ) {
+				CHECK( static_cast<int>(stars.size()) == tiles.Count(3, 5) );
+			}
+			THEN( "every star is within the tile" ) {
+				for(const StarTiles::Star &star : stars)
+				{
+					CHECK( star.x >= 0.f );
+					CHECK( star.x < StarTiles::TILE_SIZE );
+					CHECK( star.y >= 0.f );
+					CHECK( star.y < StarTiles::TILE_SIZE );
+					CHECK( star.size > 0.f );
+				}
+			}
+			THEN( "the ranks increase from 0 to 1" ) {
+				float previous = 0.f;
+				for(const StarTiles::Star &star : stars)
+				{
+					CHECK( star.rank > previous );
+					CHECK( star.rank < 1.f );
+					previous = star.rank;
+				}
+			}
+			THEN( "the stars ranked below any value come first" ) {
+				for(double rank : {0., StarTiles::BandEnd(0), .3, StarTiles::BandEnd(StarTiles::BANDS - 1)})
+				{
+					const int below = tiles.CountBelow(3, 5, rank);
+					for(int i = 0; i < static_cast<int>(stars.size()); ++i)
+						CHECK( (stars[i].rank < rank) == (i < below) );
+				}
+			}
+			THEN( "generating it again gives the same stars" ) {
+				const std::vector<StarTiles::Star> again = tiles.Generate(3, 5);
+				REQUIRE( again.size() == stars.size() );
+				for(size_t i = 0; i < stars.size(); ++i)
+				{
+					CHECK( again[i].x == stars[i].x );
+					CHECK( again[i].y == stars[i].y );
+					CHECK( again[i].size == stars[i].size );
+				}
+			}
+			THEN( "another field with the same seed has the same stars" ) {
+				const StarTiles copy(4096, 16384, 1234);
+				const std::vector<StarTiles::Star> again = copy.Generate(3, 5);
+				REQUIRE( again.size() == stars.size() );
+				for(size_t i = 0; i < stars.size(); ++i)
+					CHECK( again[i].x == stars[i].x );
+			}
+		}
+	}
+	GIVEN( "a field that is not a power of two wide" ) {
+		const StarTiles tiles(1000, 100, 1);
+		THEN( "it has no tiles" ) {
+			CHECK( tiles.Columns() == 0 );
+			CHECK( tiles.Generate(0, 0).empty() );
+		}
+	}
+}
+
+SCENARIO( "Choosing the level of detail of a star field", "[StarTiles][LevelOfDetail]" ) {
+	GIVEN( "a zoom level at or above one half" ) {
+		THEN( "all the stars are drawn" ) {
+			CHECK( StarTiles::LevelOfDetail(1.) == 1. );
+			CHECK( StarTiles::LevelOfDetail(.5) == 1. );
+		}
+	}
+	GIVEN( "a zoomed out view" ) {
+		THEN( "fewer stars are drawn the further out it is" ) {
+			CHECK( StarTiles::LevelOfDetail(.4) == .5 );
+			CHECK( StarTiles::LevelOfDetail(.2) == .25 );
+		}
+		THEN( "at least a quarter of the stars are drawn" ) {
+			CHECK( StarTiles::LevelOfDetail(.01) == .25 );
+			CHECK( StarTiles::LevelOfDetail(0.) == .25 );
+		}
+	}
+	GIVEN( "any zoom level" ) {
+		THEN( "the stars that are drawn end at the end of a band" ) {
+			for(double zoom : {2., 1., .4, .2, 0.})
+			{
+				const double detail = StarTiles::LevelOfDetail(zoom);
+				bool isBandEnd = false;
+				for(int band = 0; band < StarTiles::BANDS; ++band)
+					isBandEnd |= (StarTiles::BandEnd(band) == detail);
+				CHECK( isBandEnd );
+			}
+			CHECK( StarTiles::BandEnd(StarTiles::BANDS - 1) == 1. );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark StarTiles", "[!benchmark][StarTiles]" ) {
+	// The star field only needs to split the field into tiles at startup. Each tile
+	// is generated the first time it is drawn, instead of all of them at once.
+	BENCHMARK( "StarTiles::StarTiles(4096, 16384)" ) {
+		return StarTiles(4096, 16384, 1234).Columns();
+	};
+	const StarTiles tiles(4096, 16384, 1234);
+	BENCHMARK( "StarTiles::Generate (all tiles)" ) {
+		size_t count = 0;
+		for(int row = 0; row < tiles.Columns(); ++row)
+			for(int column = 0; column < tiles.Columns(); ++column)
+				count += tiles.Generate(column, row).size();
+		return count;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,267 @@
+/* test_backgroundSimulation.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// Include only the tested class's header.
+#include "../../../source/BackgroundSimulation.h"
+
+// Include the headers of the classes that are simulated.
+#include "../../../source/GameData.h"
+#include "../../../source/Government.h"
+#include "../../../source/Personality.h"
+#include "../../../source/Ship.h"
+#include "../../../source/System.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Two governments that are at war with each other.
+const Government *Attacker()
+{
+	Government *government = const_cast<Government *>(GameData::Governments().Get("Test Background Attacker"));
+	government->Load(AsDataNode("government \"Test Background Attacker\"\n"
+		"\t\"attitude toward\"\n"
+		"\t\t\"Test Background Defender\" -1\n"));
+	return government;
+}
+
+const Government *Defender()
+{
+	return GameData::Governments().Get("Test Background Defender");
+}
+
+// A ship that is as strong as any other ship made by this function, and that
+// has nowhere to go.
+std::shared_ptr<Ship> MakeShip(const System &system, const Government *government, bool disables = true)
+{
+	auto ship = std::make_shared<Ship>(AsDataNode("ship \"Test Background Ship\"\n"
+		"\tattributes\n"
+		"\t\tcost 1000\n"
+		"\t\tautomaton 1\n"
+		"\t\thull 1000\n"
+		"\t\tdrag 1\n"
+		"\t\tthrust 1\n"));
+	ship->FinishLoading(true);
+	ship->SetSystem(&system);
+	ship->SetGovernment(government);
+	Personality personality;
+	personality.Load(AsDataNode(disables ? "personality\n\tdisables" : "personality\n\theroic"));
+	ship->SetPersonality(personality);
+	return ship;
+}
+
+// The step in which each ship was disabled and destroyed, or 0 if it never was.
+class Outcome {
+public:
+	std::vector<int> disabled;
+	std::vector<int> destroyed;
+
+	bool operator==(const Outcome &other) const = default;
+};
+
+// Simulate a fight between the given ships for the given number of steps,
+// adding them to the simulation in the given order.
+Outcome Fight(const std::vector<std::shared_ptr<Ship>> &ships, const std::vector<size_t> &order, int steps)
+{
+	BackgroundSimulation simulation;
+	for(size_t i : order)
+		simulation.Add(ships[i]);
+
+	Outcome outcome;
+	outcome.disabled.resize(ships.size());
+	outcome.destroyed.resize(ships.size());
+	std::list<std::shared_ptr<Ship>> released;
+	std::list<ShipEvent> events;
+	for(int step = 1; step <= steps; ++step)
+	{
+		simulation.Step(nullptr, released, events);
+		for(size_t i = 0; i < ships.size(); ++i)
+		{
+			if(!outcome.disabled[i] && ships[i]->IsDisabled())
+				outcome.disabled[i] = step;
+			if(!outcome.destroyed[i] && ships[i]->IsDestroyed())
+				outcome.destroyed[i] = step;
+		}
+	}
+	return outcome;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Choosing which ships to simulate in the background", "[BackgroundSimulation]" ) {
+	const System playerSystem;
+	const System otherSystem;
+
+	GIVEN( "an NPC ship" ) {
+		std::shared_ptr<Ship> ship = MakeShip(otherSystem, Defender());
+		THEN( "it is only simulated if it is not in the player's system" ) {
+			CHECK( BackgroundSimulation::CanSimulate(*ship, &playerSystem, &playerSystem) );
+			CHECK_FALSE( BackgroundSimulation::CanSimulate(*ship, &otherSystem, &playerSystem) );
+			CHECK_FALSE( BackgroundSimulation::CanSimulate(*ship, &playerSystem, &otherSystem) );
+		}
+		THEN( "it is not simulated once it is destroyed" ) {
+			ship->Destroy();
+			CHECK_FALSE( BackgroundSimulation::CanSimulate(*ship, &playerSystem, &playerSystem) );
+		}
+	}
+	GIVEN( "a ship that is not in any system" ) {
+		std::shared_ptr<Ship> ship = MakeShip(otherSystem, Defender());
+		ship->SetSystem(nullptr);
+		THEN( "it is not simulated" ) {
+			CHECK_FALSE( BackgroundSimulation::CanSimulate(*ship, &playerSystem, &playerSystem) );
+		}
+	}
+}
+
+SCENARIO( "Handing ships back to the full simulation", "[BackgroundSimulation]" ) {
+	const System first;
+	const System second;
+	BackgroundSimulation simulation;
+	std::vector<std::shared_ptr<Ship>> ships;
+	for(int i = 0; i < 3; ++i)
+		ships.push_back(MakeShip(first, Defender()));
+	for(int i = 0; i < 2; ++i)
+		ships.push_back(MakeShip(second, Defender()));
+	for(const auto &ship : ships)
+		simulation.Add(ship);
+	REQUIRE( simulation.Size() == 5 );
+
+	WHEN( "the ships in one system are released" ) {
+		std::list<std::shared_ptr<Ship>> released;
+		simulation.Release(&first, released);
+		THEN( "only those ships are handed back, in the order they were added" ) {
+			const std::list<std::shared_ptr<Ship>> expected(ships.begin(), ships.begin() + 3);
+			CHECK( released == expected );
+			CHECK( simulation.Size() == 2 );
+		}
+		AND_WHEN( "they are released again" ) {
+			simulation.Release(&first, released);
+			THEN( "nothing changes" ) {
+				CHECK( released.size() == 3 );
+				CHECK( simulation.Size() == 2 );
+			}
+		}
+	}
+	WHEN( "the simulation is cleared" ) {
+		simulation.Clear();
+		THEN( "no ships are left" ) {
+			CHECK( simulation.Size() == 0 );
+		}
+	}
+}
+
+SCENARIO( "Limiting the work done in each step", "[BackgroundSimulation]" ) {
+	const int SHIPS = BackgroundSimulation::MAX_SHIPS_PER_STEP * 3 / 5;
+	std::vector<System> systems(3);
+	BackgroundSimulation simulation;
+	for(const System &system : systems)
+		for(int i = 0; i < SHIPS; ++i)
+			simulation.Add(MakeShip(system, Defender()));
+
+	GIVEN( "several systems that are all due to be simulated" ) {
+		std::list<std::shared_ptr<Ship>> released;
+		std::list<ShipEvent> events;
+		for(int i = 1; i < BackgroundSimulation::STEPS_PER_UPDATE; ++i)
+			REQUIRE( simulation.Step(nullptr, released, events) == 0 );
+
+		THEN( "they are spread over several steps" ) {
+			CHECK( simulation.Step(nullptr, released, events) == SHIPS );
+			CHECK( simulation.Step(nullptr, released, events) == SHIPS );
+			CHECK( simulation.Step(nullptr, released, events) == SHIPS );
+			CHECK( simulation.Step(nullptr, released, events) == 0 );
+			CHECK( simulation.Size() == 3 * SHIPS );
+			CHECK( released.empty() );
+		}
+	}
+}
+
+SCENARIO( "Resolving fights in the background", "[BackgroundSimulation]" ) {
+	const System first;
+	const System second;
+	const Government *attacker = Attacker();
+	const Government *defender = Defender();
+
+	GIVEN( "two attackers that only disable their target" ) {
+		std::vector<std::shared_ptr<Ship>> ships = {
+			MakeShip(first, attacker), MakeShip(first, attacker), MakeShip(first, defender)};
+		Outcome outcome = Fight(ships, {0, 1, 2}, 3000);
+
+		THEN( "the defender is disabled, but not destroyed" ) {
+			// It faces twice its own strength, so it lasts half as long. Ships
+			// are only checked once in each update, so allow for one update.
+			CHECK( outcome.disabled[2] >= 900 );
+			CHECK( outcome.disabled[2] <= 900 + BackgroundSimulation::STEPS_PER_UPDATE );
+			CHECK( outcome.destroyed[2] == 0 );
+			CHECK( outcome.disabled[0] == 0 );
+			CHECK( outcome.disabled[1] == 0 );
+		}
+	}
+	GIVEN( "two attackers that destroy their target" ) {
+		std::vector<std::shared_ptr<Ship>> ships = {
+			MakeShip(first, attacker, false), MakeShip(first, attacker, false), MakeShip(first, defender)};
+		Outcome outcome = Fight(ships, {0, 1, 2}, 3000);
+
+		THEN( "the defender is destroyed after it is disabled" ) {
+			CHECK( outcome.disabled[2] <= 900 + BackgroundSimulation::STEPS_PER_UPDATE );
+			CHECK( outcome.destroyed[2] > outcome.disabled[2] );
+			CHECK( outcome.destroyed[2] <= 1800 + 2 * BackgroundSimulation::STEPS_PER_UPDATE );
+		}
+	}
+	GIVEN( "the same fights in two systems" ) {
+		auto MakeShips = [&]()
+		{
+			std::vector<std::shared_ptr<Ship>> ships;
+			for(const System *system : {&first, &second})
+			{
+				ships.push_back(MakeShip(*system, attacker, false));
+				ships.push_back(MakeShip(*system, defender, false));
+				ships.push_back(MakeShip(*system, defender));
+			}
+			ships.push_back(MakeShip(second, attacker));
+			return ships;
+		};
+		std::vector<size_t> order(7);
+		for(size_t i = 0; i < order.size(); ++i)
+			order[i] = i;
+		Outcome forward = Fight(MakeShips(), order, 4000);
+		std::reverse(order.begin(), order.end());
+		Outcome backward = Fight(MakeShips(), order, 4000);
+
+		THEN( "the outcome does not depend on the order of the ships" ) {
+			CHECK( forward == backward );
+			CHECK( std::count(forward.destroyed.begin(), forward.destroyed.end(), 0) < 7 );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,222 @@
+/* test_collisionSet.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/CollisionSet.h"
+
+// Include helpers for making objects to put in the set.
+#include "../../../source/Body.h"
+#include "../../../source/Point.h"
+#include "../../../source/Rectangle.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <list>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// The grid used for the asteroid field: 16 cells of 256 pixels, which repeats
+// every 4096 pixels.
+constexpr unsigned CELL_SIZE = 256;
+constexpr unsigned CELL_COUNT = 16;
+
+// Objects without sprites, which only occupy the grid cell that they are in.
+std::list<Body> MakeBodies(const std::vector<Point> &positions)
+{
+	std::list<Body> bodies;
+	for(const Point &position : positions)
+		bodies.emplace_back(nullptr, position);
+	return bodies;
+}
+
+CollisionSet MakeSet(std::list<Body> &bodies)
+{
+	CollisionSet set(CELL_SIZE, CELL_COUNT, CollisionType::ASTEROID);
+	set.Clear(0);
+	for(Body &body : bodies)
+		set.Add(body);
+	set.Finish();
+	return set;
+}
+
+std::vector<Point> Positions(const ScratchVector<Body *> &bodies)
+{
+	std::vector<Point> positions;
+	for(const Body *body : bodies)
+		positions.push_back(body->Position());
+	return positions;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding the objects in an area", "[CollisionSet][Area]" ) {
+	GIVEN( "objects scattered across the grid" ) {
+		std::list<Body> bodies = MakeBodies({Point(3000., 3000.), Point(100., 100.), Point(600., 100.),
+			Point(300., 200.), Point(100. + 4096., 100.), Point(-100., -100.)});
+		CollisionSet set = MakeSet(bodies);
+
+		THEN( "only the objects in cells that overlap the area are found, in the order they were added" ) {
+			ScratchVector<Body *> result;
+			set.Area(Rectangle::WithCorners(Point(0., 0.), Point(400., 400.)), result);
+			CHECK( Positions(result) == std::vector<Point>{Point(100., 100.), Point(300., 200.)} );
+		}
+		THEN( "objects in other copies of the same cells are not found" ) {
+			ScratchVector<Body *> result;
+			set.Area(Rectangle::WithCorners(Point(4096., 0.), Point(4196., 200.)), result);
+			CHECK( Positions(result) == std::vector<Point>{Point(100. + 4096., 100.)} );
+		}
+		THEN( "an area at negative coordinates is found" ) {
+			ScratchVector<Body *> result;
+			set.Area(Rectangle::WithCorners(Point(-200., -200.), Point(-50., -50.)), result);
+			CHECK( Positions(result) == std::vector<Point>{Point(-100., -100.)} );
+		}
+		THEN( "an area far from every object finds nothing" ) {
+			ScratchVector<Body *> result;
+			set.Area(Rectangle::WithCorners(Point(1500., 1500.), Point(1600., 1600.)), result);
+			CHECK( result.empty() );
+		}
+	}
+	GIVEN( "a grid that repeats, like an asteroid field" ) {
+		std::list<Body> bodies = MakeBodies({Point(100., 100.), Point(2000., 2000.), Point(4000., 100.)});
+		CollisionSet set = MakeSet(bodies);
+
+		THEN( "objects are found in every copy of the grid" ) {
+			ScratchVector<Body *> result;
+			set.Area(Rectangle::WithCorners(Point(4096., 0.), Point(4296., 200.)), result, true);
+			CHECK( Positions(result) == std::vector<Point>{Point(100., 100.)} );
+		}
+		THEN( "an area that spans copies of the grid finds objects on both sides" ) {
+			ScratchVector<Body *> result;
+			set.Area(Rectangle::WithCorners(Point(3900., 0.), Point(4300., 200.)), result, true);
+			CHECK( Positions(result) == std::vector<Point>{Point(100., 100.), Point(4000., 100.)} );
+		}
+		THEN( "an area larger than the grid finds every object once" ) {
+			ScratchVector<Body *> result;
+			set.Area(Rectangle::WithCorners(Point(-5000., -5000.), Point(5000., 5000.)), result, true);
+			CHECK( std::equal(result.begin(), result.end(), set.All().begin(), set.All().end()) );
+		}
+	}
+}
+
+SCENARIO( "Adding objects that reach farther than their own size", "[CollisionSet][Add]" ) {
+	GIVEN( "objects added with a range around them" ) {
+		std::list<Body> bodies = MakeBodies({Point(1000., 1000.), Point(100., 100.), Point(600., 100.)});
+		CollisionSet set(CELL_SIZE, CELL_COUNT, CollisionType::SHIP);
+		set.Clear(0);
+		for(Body &body : bodies)
+			set.Add(body, 500.);
+		set.Finish();
+
+		THEN( "every object in range of a point is found, in the order they were added" ) {
+			ScratchVector<Body *> result;
+			set.Area(Rectangle(Point(550., 550.), Point()), result);
+			CHECK( Positions(result) == std::vector<Point>{Point(1000., 1000.), Point(100., 100.), Point(600., 100.)} );
+		}
+		THEN( "objects that cannot reach a point are not found" ) {
+			ScratchVector<Body *> result;
+			set.Area(Rectangle(Point(-300., 1000.), Point()), result);
+			CHECK( result.empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark CollisionSet::Area", "[!benchmark][CollisionSet]" ) {
+	// An asteroid field with a few thousand objects, viewed at the default zoom.
+	std::vector<Point> positions;
+	uint32_t seed = 1;
+	for(int i = 0; i < 5000; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		double x = (seed >> 8) % 4096;
+		seed = seed * 1664525 + 1013904223;
+		double y = (seed >> 8) % 4096;
+		positions.emplace_back(x, y);
+	}
+	std::list<Body> bodies = MakeBodies(positions);
+	CollisionSet set = MakeSet(bodies);
+	const Rectangle screen(Point(1000., 1000.), Point(1920., 1080.));
+
+	BENCHMARK( "Check every object" ) {
+		size_t count = 0;
+		for(const Body *body : set.All())
+			count += screen.Contains(body->Position());
+		return count;
+	};
+	BENCHMARK( "Check the objects in the overlapping cells" ) {
+		ScratchVector<Body *> result;
+		set.Area(screen, result, true);
+		size_t count = 0;
+		for(const Body *body : result)
+			count += screen.Contains(body->Position());
+		return count;
+	};
+}
+
+TEST_CASE( "Benchmark CollisionSet::Add with a range", "[!benchmark][CollisionSet]" ) {
+	// Ships with anti-missile systems spread across a large battle, and a swarm
+	// of missiles that each need to check which of them are in range.
+	std::vector<Point> positions;
+	uint32_t seed = 1;
+	for(int i = 0; i < 1100; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		double x = (seed >> 8) % 6000;
+		seed = seed * 1664525 + 1013904223;
+		double y = (seed >> 8) % 6000;
+		positions.emplace_back(x, y);
+	}
+	std::list<Body> defenders = MakeBodies(std::vector<Point>(positions.begin(), positions.begin() + 100));
+	const std::vector<Point> missiles(positions.begin() + 100, positions.end());
+	const double range = 400.;
+
+	BENCHMARK( "Check every defender for each missile" ) {
+		size_t count = 0;
+		for(const Point &missile : missiles)
+			for(const Body &defender : defenders)
+				count += (missile.Distance(defender.Position()) <= range);
+		return count;
+	};
+	BENCHMARK( "Check the defenders whose range covers each missile" ) {
+		CollisionSet set(256, 32, CollisionType::SHIP);
+		set.Clear(0);
+		for(Body &defender : defenders)
+			set.Add(defender, range);
+		set.Finish();
+		size_t count = 0;
+		for(const Point &missile : missiles)
+		{
+			ScratchVector<Body *> result;
+			set.Area(Rectangle(missile, Point()), result);
+			for(const Body *defender : result)
+				count += (missile.Distance(defender->Position()) <= range);
+		}
+		return count;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
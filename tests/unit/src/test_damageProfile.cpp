@@ -0,0 +1,149 @@
+/* test_damageProfile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// Include only the tested class's header.
+#include "../../../source/DamageProfile.h"
+
+// Include the headers of the classes that deal and take the damage.
+#include "../../../source/DamageDealt.h"
+#include "../../../source/Outfit.h"
+#include "../../../source/Ship.h"
+
+// ... and any system includes needed for the test file.
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+Outfit MakeWeapon(const std::string &damage)
+{
+	Outfit outfit;
+	outfit.Load(AsDataNode("outfit \"Test Weapon\"\n"
+		"\tweapon\n"
+		"\t\tvelocity 10\n"
+		"\t\tlifetime 10\n" + damage));
+	return outfit;
+}
+
+std::shared_ptr<Ship> MakeShip()
+{
+	auto ship = std::make_shared<Ship>(AsDataNode("ship \"Test Damage Ship\"\n"
+		"\tattributes\n"
+		"\t\tshields 1000\n"
+		"\t\thull 1000\n"
+		"\t\t\"energy capacity\" 100\n"
+		"\t\t\"shield protection\" .25\n"
+		"\t\t\"ion protection\" 1\n"));
+	ship->FinishLoading(true);
+	return ship;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Calculating the damage of a hit", "[DamageProfile]" ) {
+	std::shared_ptr<Ship> ship = MakeShip();
+	REQUIRE( ship->ShieldLevel() == 1000. );
+
+	GIVEN( "a weapon that only does instantaneous damage" ) {
+		const Outfit weapon = MakeWeapon("\t\t\"shield damage\" 10\n"
+			"\t\t\"hull damage\" 20\n"
+			"\t\t\"relative energy damage\" .1\n");
+		REQUIRE_FALSE( weapon.DoesStatusDamage() );
+		const DamageProfile profile(Projectile::ImpactInfo(weapon, Point(), 0.));
+		const DamageDealt damage = profile.CalculateDamage(*ship);
+
+		THEN( "the ship's protection and shields reduce the damage" ) {
+			CHECK_THAT( damage.Shield(), Catch::Matchers::WithinAbs(8., 1e-9) );
+			CHECK( damage.Hull() == 0. );
+			CHECK_THAT( damage.Energy(), Catch::Matchers::WithinAbs(5., 1e-9) );
+			CHECK( damage.Ion() == 0. );
+		}
+		WHEN( "an outfit changes the ship's protection" ) {
+			Outfit armor;
+			armor.Set("shield protection", .75);
+			ship->AddOutfit(&armor, 1);
+			THEN( "the next hit uses the new protection" ) {
+				CHECK_THAT( profile.CalculateDamage(*ship).Shield(), Catch::Matchers::WithinAbs(5., 1e-9) );
+			}
+		}
+	}
+	GIVEN( "a weapon that also does status effect damage" ) {
+		const Outfit weapon = MakeWeapon("\t\t\"shield damage\" 10\n"
+			"\t\t\"ion damage\" 8\n");
+		REQUIRE( weapon.DoesStatusDamage() );
+		const DamageDealt damage = DamageProfile(Projectile::ImpactInfo(weapon, Point(), 0.)).CalculateDamage(*ship);
+
+		THEN( "the status effects are reduced by the shields and protection" ) {
+			CHECK_THAT( damage.Shield(), Catch::Matchers::WithinAbs(8., 1e-9) );
+			CHECK_THAT( damage.Ion(), Catch::Matchers::WithinAbs(2., 1e-9) );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark DamageProfile::CalculateDamage", "[!benchmark][DamageProfile]" ) {
+	std::vector<std::shared_ptr<Ship>> ships;
+	for(int i = 0; i < 200; ++i)
+	{
+		ships.push_back(MakeShip());
+		ships.back()->SetPosition(Point(i, 0.));
+	}
+	const Outfit missile = MakeWeapon("\t\t\"shield damage\" 10\n"
+		"\t\t\"hull damage\" 20\n"
+		"\t\t\"hit force\" 5\n");
+	const Outfit bomb = MakeWeapon("\t\t\"blast radius\" 100\n"
+		"\t\t\"shield damage\" 100\n"
+		"\t\t\"hull damage\" 200\n"
+		"\t\t\"hit force\" 50\n");
+
+	BENCHMARK( "A swarm of missiles, each hitting one ship" ) {
+		double total = 0.;
+		for(int i = 0; i < 1000; ++i)
+		{
+			const DamageProfile profile(Projectile::ImpactInfo(missile, Point(), i));
+			total += profile.CalculateDamage(*ships[i % ships.size()]).Shield();
+		}
+		return total;
+	};
+	BENCHMARK( "Blasts that each hit every ship" ) {
+		double total = 0.;
+		for(int i = 0; i < 5; ++i)
+		{
+			const DamageProfile profile(Projectile::ImpactInfo(bomb, Point(), 0.));
+			for(const auto &ship : ships)
+				total += profile.CalculateDamage(*ship).Shield();
+		}
+		return total;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
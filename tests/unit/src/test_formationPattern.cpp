@@ -24,6 +24,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // ... and any system includes needed for the test file.
 #include <map>
 #include <string>
+#include <vector>
 
 namespace { // test namespace
 
@@ -165,6 +166,18 @@ SCENARIO( "Loading and using of a formation pattern", "[formationPattern][Positi
 				REQUIRE( Near(*it, Point(300, 600)) );
 			}
 		}
+		WHEN( "positions are requested all at once" ) {
+			std::vector<Point> positions = delta_px.Positions(12, centerBodyRadius);
+			THEN ( "they are the same as the positions from the iterator" ) {
+				REQUIRE( positions.size() == 12 );
+				auto it = delta_px.begin(centerBodyRadius);
+				for(const Point &position : positions)
+				{
+					CHECK( Near(position, *it) );
+					++it;
+				}
+			}
+		}
 	}
 }
 // #endregion unit tests
@@ -0,0 +1,297 @@
+/* test_packedArchive.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/PackedArchive.h"
+
+// Include a helper for reading files through mounted archives.
+#include "../../../source/Files.h"
+
+// ... and any system includes needed for the test file.
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// A temporary directory that is removed when it goes out of scope.
+class TemporaryDirectory {
+public:
+	explicit TemporaryDirectory(const std::string &name)
+		: path(std::filesystem::temp_directory_path() / ("es-test-" + name))
+	{
+		std::filesystem::remove_all(path);
+		std::filesystem::create_directories(path);
+	}
+	~TemporaryDirectory() { std::filesystem::remove_all(path); }
+
+	std::filesystem::path path;
+};
+
+void WriteFile(const std::filesystem::path &path, const std::string &contents)
+{
+	std::filesystem::create_directories(path.parent_path());
+	std::ofstream(path, std::ios::binary) << contents;
+}
+
+// Text that compresses well, like a data file.
+std::string MakeText(int lines)
+{
+	std::string text;
+	for(int i = 0; i < lines; ++i)
+		text += "ship \"Example " + std::to_string(i % 10) + "\"\n\tattributes\n\t\tcategory \"Light Warship\"\n";
+	return text;
+}
+
+// Bytes that do not compress at all, like an image or sound file.
+std::string MakeNoise(size_t size)
+{
+	std::string noise(size, '\0');
+	uint32_t state = 12345;
+	for(char &c : noise)
+	{
+		state = state * 1664525 + 1013904223;
+		c = static_cast<char>(state >> 24);
+	}
+	return noise;
+}
+
+std::vector<std::filesystem::path> ListAssets(const std::filesystem::path &root)
+{
+	std::vector<std::filesystem::path> files;
+	for(const char *folder : {"data", "images", "sounds"})
+		for(const auto &path : Files::RecursiveList(root / folder))
+			files.push_back(path);
+	return files;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Packing files into an archive", "[PackedArchive]" ) {
+	TemporaryDirectory directory("pack");
+	const std::filesystem::path &root = directory.path;
+	const std::string text = MakeText(200);
+	const std::string noise = MakeNoise(5000);
+	WriteFile(root / "data/ships.txt", text);
+	WriteFile(root / "images/ship/example.png", noise);
+	WriteFile(root / "images/ship/empty.png", "");
+	WriteFile(root / "sounds/engine.wav", noise.substr(0, 123));
+
+	GIVEN( "an archive of those files" ) {
+		const std::filesystem::path path = root / "test.pack";
+		REQUIRE( PackedArchive::Write(path, root, ListAssets(root)) );
+		const auto archive = PackedArchive::Open(path);
+		REQUIRE( archive );
+
+		THEN( "it contains every file by its relative name" ) {
+			CHECK( archive->Size() == 4 );
+			CHECK( archive->Has("data/ships.txt") );
+			CHECK( archive->Has("images/ship/example.png") );
+			CHECK( archive->Has("sounds/engine.wav") );
+			CHECK_FALSE( archive->Has("images/ship") );
+			CHECK_FALSE( archive->Has("images/missing.png") );
+		}
+		THEN( "it can list the files in a directory" ) {
+			CHECK( archive->HasDirectory("images") );
+			CHECK( archive->HasDirectory("images/ship/") );
+			CHECK_FALSE( archive->HasDirectory("image") );
+			const std::vector<std::string> expected = {"images/ship/empty.png", "images/ship/example.png"};
+			CHECK( archive->List("images") == expected );
+			CHECK( archive->List("missing").empty() );
+		}
+		THEN( "every file has its original contents" ) {
+			CHECK( archive->Read("data/ships.txt") == text );
+			CHECK( archive->Read("images/ship/example.png") == noise );
+			CHECK( archive->Read("images/ship/empty.png").empty() );
+			CHECK( archive->Read("sounds/engine.wav") == noise.substr(0, 123) );
+		}
+		THEN( "only files that compress well are compressed" ) {
+			CHECK( archive->IsCompressed("data/ships.txt") );
+			CHECK( archive->View("data/ships.txt").empty() );
+			CHECK_FALSE( archive->IsCompressed("images/ship/example.png") );
+			CHECK( archive->View("images/ship/example.png") == noise );
+		}
+	}
+	GIVEN( "an archive without compression" ) {
+		const std::filesystem::path path = root / "test.pack";
+		REQUIRE( PackedArchive::Write(path, root, ListAssets(root), false) );
+		const auto archive = PackedArchive::Open(path);
+		REQUIRE( archive );
+		THEN( "every file can be read directly from the archive" ) {
+			CHECK_FALSE( archive->IsCompressed("data/ships.txt") );
+			CHECK( archive->View("data/ships.txt") == text );
+		}
+	}
+	GIVEN( "a file outside of the root directory" ) {
+		THEN( "no archive is written" ) {
+			CHECK_FALSE( PackedArchive::Write(root / "test.pack", root / "data", ListAssets(root)) );
+		}
+	}
+	GIVEN( "a file that is not an archive" ) {
+		WriteFile(root / "bad.pack", text);
+		THEN( "it cannot be opened" ) {
+			CHECK_FALSE( PackedArchive::Open(root / "bad.pack") );
+			CHECK_FALSE( PackedArchive::Open(root / "missing.pack") );
+		}
+	}
+	GIVEN( "an archive that has been cut short" ) {
+		const std::filesystem::path path = root / "test.pack";
+		REQUIRE( PackedArchive::Write(path, root, ListAssets(root)) );
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - 100);
+		THEN( "it cannot be opened" ) {
+			CHECK_FALSE( PackedArchive::Open(path) );
+		}
+	}
+}
+
+SCENARIO( "Reading files through a mounted archive", "[PackedArchive][Files]" ) {
+	TemporaryDirectory packed("mount-source");
+	TemporaryDirectory directory("mount");
+	const std::filesystem::path &root = directory.path;
+	const std::string text = MakeText(50);
+	WriteFile(packed.path / "data/ships.txt", text);
+	WriteFile(packed.path / "data/outfits.txt", "outfit");
+	WriteFile(packed.path / "images/ship/example.png", MakeNoise(300));
+	REQUIRE( PackedArchive::Write(root / PackedArchive::FILE_NAME, packed.path, ListAssets(packed.path)) );
+
+	GIVEN( "a directory with an archive and some loose files" ) {
+		WriteFile(root / "data/outfits.txt", "override");
+		WriteFile(root / "data/extra.txt", "extra");
+		REQUIRE( Files::Mount(root) );
+
+		THEN( "the archived files appear to be in the directory" ) {
+			CHECK( Files::Exists(root / "data") );
+			CHECK( Files::Exists(root / "images") );
+			CHECK( Files::Exists(root / "images/ship/example.png") );
+			CHECK_FALSE( Files::Exists(root / "sounds") );
+			const std::vector<std::filesystem::path> expected = {
+				root / "data/extra.txt", root / "data/outfits.txt", root / "data/ships.txt"};
+			CHECK( Files::RecursiveList(root / "data/") == expected );
+		}
+		THEN( "the archived files and directories are listed with the loose ones" ) {
+			const std::vector<std::filesystem::path> files = {root / "data/extra.txt", root / "data/outfits.txt",
+				root / "data/ships.txt"};
+			CHECK( Files::List(root / "data/") == files );
+			const std::vector<std::filesystem::path> directories = {root / "data", root / "images"};
+			CHECK( Files::ListDirectories(root) == directories );
+			const std::vector<std::filesystem::path> subdirectories = {root / "images/ship"};
+			CHECK( Files::ListDirectories(root / "images/") == subdirectories );
+			CHECK( Files::List(root / "images/").empty() );
+		}
+		THEN( "loose files take priority over archived files" ) {
+			CHECK( Files::Read(root / "data/outfits.txt") == "override" );
+			CHECK( Files::Read(root / "data/extra.txt") == "extra" );
+			CHECK( Files::Read(root / "data/ships.txt") == text );
+		}
+		THEN( "archived files can be streamed" ) {
+			std::shared_ptr<std::iostream> in = Files::Open(root / "images/ship/example.png");
+			REQUIRE( in );
+			std::string start(10, '\0');
+			in->read(start.data(), start.size());
+			CHECK( start == MakeNoise(300).substr(0, 10) );
+			in->seekg(0, std::ios::end);
+			CHECK( in->tellg() == 300 );
+			in->seekg(290);
+			std::string end(20, '\0');
+			in->read(end.data(), end.size());
+			CHECK( in->gcount() == 10 );
+		}
+		THEN( "archived and loose files can be mapped" ) {
+			std::shared_ptr<const std::string_view> archived = Files::Map(root / "data/ships.txt");
+			REQUIRE( archived );
+			CHECK( *archived == text );
+			std::shared_ptr<const std::string_view> loose = Files::Map(root / "data/outfits.txt");
+			REQUIRE( loose );
+			CHECK( *loose == "override" );
+			CHECK_FALSE( Files::Map(root / "data/missing.txt") );
+			CHECK_FALSE( Files::Map(root / "data") );
+		}
+	}
+	GIVEN( "an archive in a directory within another mounted directory" ) {
+		TemporaryDirectory pluginSource("mount-plugin-source");
+		WriteFile(pluginSource.path / "data/plugin.txt", "plugin");
+		WriteFile(pluginSource.path / "data/ships.txt", "plugin ships");
+		const std::filesystem::path plugin = root / "plugins/example";
+		std::filesystem::create_directories(plugin);
+		REQUIRE( PackedArchive::Write(plugin / PackedArchive::FILE_NAME, pluginSource.path,
+			ListAssets(pluginSource.path)) );
+		REQUIRE( Files::Mount(root) );
+		REQUIRE( Files::Mount(plugin) );
+
+		THEN( "the files in the nested archive are found" ) {
+			CHECK( Files::Exists(plugin / "data/plugin.txt") );
+			CHECK( Files::Read(plugin / "data/plugin.txt") == "plugin" );
+			CHECK( Files::Read(plugin / "data/ships.txt") == "plugin ships" );
+			const std::vector<std::filesystem::path> expected = {plugin / "data/plugin.txt", plugin / "data/ships.txt"};
+			CHECK( Files::List(plugin / "data/") == expected );
+		}
+		THEN( "the files in the outer archive are still found" ) {
+			CHECK( Files::Read(root / "data/ships.txt") == text );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark PackedArchive", "[!benchmark][PackedArchive]" ) {
+	// Many small files, like the data and images of the base game. These are all
+	// warm (cached by the operating system) after the first iteration, so this
+	// compares the per-file overhead. Measuring a cold cache requires dropping the
+	// operating system's caches between runs, which a unit test cannot do.
+	TemporaryDirectory directory("benchmark");
+	const std::filesystem::path &root = directory.path;
+	const std::string text = MakeText(20);
+	for(int i = 0; i < 2000; ++i)
+		WriteFile(root / "images" / std::to_string(i % 20) / (std::to_string(i) + ".png"), text);
+	const std::filesystem::path path = root / "test.pack";
+	REQUIRE( PackedArchive::Write(path, root, ListAssets(root), false) );
+
+	BENCHMARK( "Directory: list and read every file" ) {
+		size_t total = 0;
+		for(const auto &file : Files::RecursiveList(root / "images"))
+			total += Files::Read(file).size();
+		return total;
+	};
+	BENCHMARK( "Archive: open, list, and read every file" ) {
+		size_t total = 0;
+		const auto archive = PackedArchive::Open(path);
+		for(const std::string &name : archive->List("images"))
+			total += archive->View(name).size();
+		return total;
+	};
+	const auto archive = PackedArchive::Open(path);
+	BENCHMARK( "Archive: list and read every file (already open)" ) {
+		size_t total = 0;
+		for(const std::string &name : archive->List("images"))
+			total += archive->View(name).size();
+		return total;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,181 @@
+/* test_phrase.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// Include only the tested class's header.
+#include "../../../source/Phrase.h"
+
+// Include the headers of the classes that phrases are looked up from.
+#include "../../../source/GameData.h"
+#include "../../../source/Random.h"
+
+// ... and any system includes needed for the test file.
+#include <map>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Get the phrase with the given name, defining it the first time it is needed.
+const Phrase *GetPhrase(const std::string &name, const std::string &definition)
+{
+	Phrase *phrase = const_cast<Phrase *>(GameData::Phrases().Get(name));
+	if(phrase->IsEmpty())
+		phrase->Load(AsDataNode(definition));
+	return phrase;
+}
+
+const Phrase *Weighted()
+{
+	return GetPhrase("Test Weighted", "phrase \"Test Weighted\"\n"
+		"\tword\n"
+		"\t\tcat 1\n"
+		"\t\tdog 3\n");
+}
+
+const Phrase *Nested()
+{
+	GetPhrase("Test Color", "phrase \"Test Color\"\n"
+		"\tword\n"
+		"\t\tred\n"
+		"\t\tblue\n");
+	GetPhrase("Test Size", "phrase \"Test Size\"\n"
+		"\tword\n"
+		"\t\tbig\n"
+		"\t\tsmall\n");
+	return GetPhrase("Test Nested", "phrase \"Test Nested\"\n"
+		"\tword\n"
+		"\t\t\"a \"\n"
+		"\tphrase\n"
+		"\t\t\"Test Color\"\n"
+		"\t\t\"Test Size\"\n"
+		"\tword\n"
+		"\t\t\" ${Test Weighted}\"\n");
+}
+
+// Count how often each string is generated by the given phrase.
+std::map<std::string, int> Sample(const Phrase &phrase, int count)
+{
+	std::map<std::string, int> counts;
+	for(int i = 0; i < count; ++i)
+		++counts[phrase.Get()];
+	return counts;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Generating text from a phrase", "[Phrase]" ) {
+	const int SAMPLES = 8000;
+	Random::Seed(1);
+
+	GIVEN( "a phrase with weighted words" ) {
+		const Phrase &phrase = *Weighted();
+		const auto counts = Sample(phrase, SAMPLES);
+		THEN( "each word is chosen in proportion to its weight" ) {
+			REQUIRE( counts.size() == 2 );
+			CHECK_THAT( counts.at("cat") / static_cast<double>(SAMPLES), Catch::Matchers::WithinAbs(.25, .02) );
+			CHECK_THAT( counts.at("dog") / static_cast<double>(SAMPLES), Catch::Matchers::WithinAbs(.75, .02) );
+		}
+	}
+	GIVEN( "a phrase that is defined more than once" ) {
+		Phrase phrase(AsDataNode("phrase \"Test Twice\"\n"
+			"\tword\n"
+			"\t\tone\n"));
+		phrase.Load(AsDataNode("phrase \"Test Twice\"\n"
+			"\tword\n"
+			"\t\ttwo 9\n"));
+		const auto counts = Sample(phrase, SAMPLES);
+		THEN( "each definition is equally likely, regardless of the weights inside it" ) {
+			REQUIRE( counts.size() == 2 );
+			CHECK_THAT( counts.at("one") / static_cast<double>(SAMPLES), Catch::Matchers::WithinAbs(.5, .02) );
+		}
+	}
+	GIVEN( "a phrase made of other phrases" ) {
+		const Phrase &phrase = *Nested();
+		const auto counts = Sample(phrase, SAMPLES);
+		THEN( "every combination of the parts is generated with the combined probability" ) {
+			REQUIRE( counts.size() == 8 );
+			for(const char *color : {"red", "blue", "big", "small"})
+			{
+				const std::string prefix = std::string("a ") + color;
+				CHECK_THAT( counts.at(prefix + " cat") / static_cast<double>(SAMPLES),
+					Catch::Matchers::WithinAbs(.25 * .25, .015) );
+				CHECK_THAT( counts.at(prefix + " dog") / static_cast<double>(SAMPLES),
+					Catch::Matchers::WithinAbs(.25 * .75, .02) );
+			}
+		}
+		THEN( "the same random seed generates the same text" ) {
+			Random::Seed(7);
+			std::string first;
+			for(int i = 0; i < 20; ++i)
+				first += phrase.Get() + "\n";
+			Random::Seed(7);
+			std::string second;
+			for(int i = 0; i < 20; ++i)
+				second += phrase.Get() + "\n";
+			CHECK( first == second );
+		}
+	}
+	GIVEN( "a phrase with replacements" ) {
+		GetPhrase("Test Replaced", "phrase \"Test Replaced\"\n"
+			"\tword\n"
+			"\t\t\"hello ${Test Weighted}\"\n"
+			"\treplace\n"
+			"\t\tl L\n"
+			"\t\to 0\n");
+		THEN( "only the text generated by that phrase is changed" ) {
+			const std::string text = Phrase::ExpandPhrases("lo: ${Test Replaced}, lo");
+			CHECK( (text == "lo: heLL0 cat, lo" || text == "lo: heLL0 d0g, lo") );
+		}
+	}
+	GIVEN( "text that refers to phrases" ) {
+		Weighted();
+		THEN( "unknown phrases are replaced with their names" ) {
+			CHECK( Phrase::ExpandPhrases("no phrase here") == "no phrase here" );
+			CHECK( Phrase::ExpandPhrases("${Test Undefined} end") == "Test Undefined end" );
+		}
+		THEN( "known phrases are expanded" ) {
+			const std::string text = Phrase::ExpandPhrases("a ${Test Weighted}!");
+			CHECK( (text == "a cat!" || text == "a dog!") );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Phrase::Get", "[!benchmark][Phrase]" ) {
+	const Phrase &phrase = *Nested();
+	BENCHMARK( "A phrase made of other phrases" ) {
+		return phrase.Get();
+	};
+	BENCHMARK( "Text with a phrase reference in it" ) {
+		return Phrase::ExpandPhrases("This is the ${Test Nested}. Prepare to be boarded!");
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
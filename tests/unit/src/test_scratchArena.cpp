@@ -0,0 +1,132 @@
+/* test_scratchArena.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/ScratchArena.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// Do the sort of work that one step of the game does: fill some lists and a
+// map, growing them one element at a time.
+int64_t SimulateStep(int size)
+{
+	int64_t total = 0;
+	for(int i = 0; i < 20; ++i)
+	{
+		ScratchVector<int> list;
+		for(int j = 0; j < size; ++j)
+			list.push_back(j);
+		ScratchMap<int, int64_t> sums;
+		for(int value : list)
+			sums[value % 7] += value;
+		for(const auto &it : sums)
+			total += it.second;
+	}
+	return total;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Allocating scratch containers", "[ScratchArena]" ) {
+	ScratchArena::TakeAllocationCount();
+
+	GIVEN( "no open scope" ) {
+		THEN( "containers allocate from the heap" ) {
+			ScratchVector<int> list = {1, 2, 3};
+			CHECK( list.size() == 3 );
+			CHECK( ScratchArena::TakeAllocationCount() == 1 );
+		}
+	}
+	GIVEN( "an open scope" ) {
+		THEN( "containers work just like they do with the default allocator" ) {
+			ScratchArena::Scope scope;
+			ScratchVector<int> list;
+			std::vector<int> expected;
+			for(int i = 0; i < 10000; ++i)
+			{
+				list.push_back(i * i);
+				expected.push_back(i * i);
+			}
+			CHECK( std::vector<int>(list.begin(), list.end()) == expected );
+			ScratchMap<int, int> map;
+			for(int i = 0; i < 100; ++i)
+				map[i % 10] += i;
+			CHECK( map.size() == 10 );
+			CHECK( map[3] == 3 + 13 + 23 + 33 + 43 + 53 + 63 + 73 + 83 + 93 );
+		}
+		THEN( "the same amount of work does not allocate the second time" ) {
+			{
+				ScratchArena::Scope scope;
+				SimulateStep(5000);
+			}
+			ScratchArena::TakeAllocationCount();
+			for(int step = 0; step < 3; ++step)
+			{
+				ScratchArena::Scope scope;
+				SimulateStep(5000);
+				CHECK( ScratchArena::TakeAllocationCount() == 0 );
+			}
+		}
+		THEN( "nested scopes release their memory only when the outermost one closes" ) {
+			ScratchArena::Scope outer;
+			ScratchVector<int> list(100, 7);
+			{
+				ScratchArena::Scope inner;
+				ScratchVector<int> other(100, 3);
+			}
+			CHECK( list == ScratchVector<int>(100, 7) );
+		}
+		THEN( "containers that were allocated on the heap can be used in a scope" ) {
+			ScratchVector<int> list = {1, 2, 3};
+			{
+				ScratchArena::Scope scope;
+				list.resize(1000, 4);
+				list.shrink_to_fit();
+			}
+			list.clear();
+			list.shrink_to_fit();
+			CHECK( list.empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark ScratchArena", "[!benchmark][ScratchArena]" ) {
+	BENCHMARK( "Containers using the heap" ) {
+		return SimulateStep(500);
+	};
+	BENCHMARK( "Containers using a scratch arena" ) {
+		ScratchArena::Scope scope;
+		return SimulateStep(500);
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -18,10 +18,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // Include only the tested class's header.
 #include "../../../source/Ship.h"
 
+// Include the helpers for giving the ships outfits and a system.
+#include "../../../source/Outfit.h"
+#include "../../../source/System.h"
+
 // ... and any system includes needed for the test file.
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace { // test namespace
 
@@ -30,6 +35,32 @@ namespace { // test namespace
 // Insert file-local data here, e.g. classes, structs, or fixtures that will be useful
 // to help test this class/method.
 
+// Outfits that together make a ship flyable, without needing any game data.
+class FlyableOutfits {
+public:
+	FlyableOutfits()
+	{
+		hull.Set("heat capacity", 100.);
+		hull.Set("bunks", 4.);
+		reactor.Set("energy generation", 2.);
+		thruster.Set("thrust", 10.);
+		thruster.Set("thrusting energy", 1.);
+		steering.Set("turn", 100.);
+		steering.Set("turning energy", .5);
+	}
+
+	void Install(Ship &ship) const
+	{
+		for(const Outfit *outfit : {&hull, &reactor, &thruster, &steering})
+			ship.AddOutfit(outfit, 1);
+	}
+
+	Outfit hull;
+	Outfit reactor;
+	Outfit thruster;
+	Outfit steering;
+};
+
 // #endregion mock data
 
 
@@ -98,6 +129,66 @@ SCENARIO( "A Ship::Bay instance is being copied", "[ship][bay]") {
 		}
 	}
 }
+
+SCENARIO( "Checking whether a ship can fly", "[ship][FlightCheck]" ) {
+	const FlyableOutfits outfits;
+	GIVEN( "a ship with a reactor, thruster, and steering" ) {
+		Ship ship;
+		outfits.Install(ship);
+		THEN( "only the warnings about its lack of a hyperdrive are given" ) {
+			const std::vector<std::string> expected = {"no hyperdrive?"};
+			CHECK( ship.FlightCheck() == expected );
+			CHECK( ship.FlightCheck() == expected );
+		}
+		WHEN( "its steering is removed" ) {
+			ship.FlightCheck();
+			ship.AddOutfit(&outfits.steering, -1);
+			THEN( "the check reflects the change" ) {
+				const std::vector<std::string> expected = {"no steering!"};
+				CHECK( ship.FlightCheck() == expected );
+			}
+		}
+		WHEN( "it generates more heat than it can hold" ) {
+			ship.FlightCheck();
+			Outfit engine;
+			engine.Set("heat generation", 1.);
+			ship.AddOutfit(&engine, 1);
+			THEN( "it overheats" ) {
+				const std::vector<std::string> expected = {"overheating!"};
+				CHECK( ship.FlightCheck() == expected );
+			}
+		}
+	}
+	GIVEN( "a ship with a hyperdrive but no fuel" ) {
+		const System system;
+		Ship ship;
+		ship.SetSystem(&system);
+		outfits.Install(ship);
+		Outfit hyperdrive;
+		hyperdrive.Set("hyperdrive", 1.);
+		hyperdrive.Set("hyperdrive fuel", 100.);
+		ship.AddOutfit(&hyperdrive, 1);
+		THEN( "it warns that it cannot jump" ) {
+			const std::vector<std::string> expected = {"no fuel?"};
+			CHECK( ship.FlightCheck() == expected );
+		}
+		WHEN( "it is carried by another ship" ) {
+			ship.FlightCheck();
+			ship.SetSystem(nullptr);
+			THEN( "it no longer needs fuel to jump" ) {
+				CHECK( ship.FlightCheck().empty() );
+			}
+			AND_WHEN( "it is launched again" ) {
+				ship.SetSystem(&system);
+				THEN( "the warning is given again" ) {
+					const std::vector<std::string> expected = {"no fuel?"};
+					CHECK( ship.FlightCheck() == expected );
+				}
+			}
+		}
+	}
+}
+
 // Constructing useful Ship instances requires Ship::Load, which requires all of GameData & runtime deps.
 
 
@@ -112,6 +203,39 @@ SCENARIO( "A Ship::Bay instance is being copied", "[ship][bay]") {
 
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark a large player fleet", "[!benchmark][ship]" ) {
+	// A fleet of 500 ships, like one that the player might have after capturing
+	// many ships. The outfitter and shipyard check every ship each frame.
+	const FlyableOutfits outfits;
+	std::vector<std::shared_ptr<Ship>> fleet;
+	for(int i = 0; i < 500; ++i)
+	{
+		fleet.push_back(std::make_shared<Ship>());
+		outfits.Install(*fleet.back());
+	}
+
+	BENCHMARK( "Ship::FlightCheck (500 ships)" ) {
+		size_t problems = 0;
+		for(const auto &ship : fleet)
+			problems += ship->FlightCheck().size();
+		return problems;
+	};
+	BENCHMARK( "Ship::FlightCheck after changing every ship's outfits (500 ships)" ) {
+		size_t problems = 0;
+		for(const auto &ship : fleet)
+		{
+			ship->AddOutfit(&outfits.reactor, 1);
+			ship->AddOutfit(&outfits.reactor, -1);
+			problems += ship->FlightCheck().size();
+		}
+		return problems;
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
@@ -0,0 +1,90 @@
+/* test_visual.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// Include only the tested class's header.
+#include "../../../source/Visual.h"
+
+// Include the headers of the classes that visuals are created from.
+#include "../../../source/Effect.h"
+#include "../../../source/Random.h"
+
+// ... and any system includes needed for the test file.
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+Effect MakeEffect()
+{
+	Effect effect;
+	effect.Load(AsDataNode("effect \"Test Effect\"\n"
+		"\tlifetime 10\n"
+		"\t\"random lifetime\" 5\n"
+		"\t\"random angle\" 30\n"
+		"\t\"random spin\" 4\n"
+		"\t\"random velocity\" 3\n"));
+	return effect;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Creating several visuals of the same effect at once", "[Visual]" ) {
+	const Effect effect = MakeEffect();
+	const Point position(100., -50.);
+	const Point velocity(2., 1.);
+	const Angle facing(45.);
+
+	GIVEN( "the same random seed" ) {
+		Random::Seed(42);
+		std::vector<Visual> separate;
+		for(int i = 0; i < 5; ++i)
+			separate.emplace_back(effect, position, velocity, facing);
+
+		Random::Seed(42);
+		std::vector<Visual> spawned;
+		Visual::Spawn(spawned, 5, effect, position, velocity, facing);
+
+		THEN( "the visuals are the same as if they were created one at a time" ) {
+			REQUIRE( spawned.size() == separate.size() );
+			for(size_t i = 0; i < spawned.size(); ++i)
+			{
+				CHECK( spawned[i].Position() == separate[i].Position() );
+				CHECK( spawned[i].Velocity() == separate[i].Velocity() );
+				CHECK( spawned[i].Facing() == separate[i].Facing() );
+			}
+		}
+	}
+	GIVEN( "a count of zero" ) {
+		std::vector<Visual> visuals;
+		Visual::Spawn(visuals, 0, effect, position, velocity, facing);
+		THEN( "no visuals are created" ) {
+			CHECK( visuals.empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace